@@ -0,0 +1,163 @@
+/*
+Copyright 2024 Nikola Jelic <nikola.jelic83@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the “Software”), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "phys_units.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+namespace units {
+
+// Unsigned radix key with the order of the holding value: the sign bit of
+// signed integers is flipped, negative floating point values are inverted.
+// -0.0 sorts before +0.0, NaNs go to the ends by their sign.
+
+template <typename V, typename Enable = void> struct RadixKey {};
+
+template <typename V>
+struct RadixKey<V, typename std::enable_if<std::is_integral<V>::value>::type> {
+  using type = typename std::make_unsigned<V>::type;
+  static type get(V value) {
+    return std::is_signed<V>::value
+               ? type(type(value) ^ (type(1) << (sizeof(V) * 8 - 1)))
+               : type(value);
+  }
+};
+
+template <typename V>
+struct RadixKey<
+    V, typename std::enable_if<std::is_floating_point<V>::value>::type> {
+  static_assert(sizeof(V) == 4 || sizeof(V) == 8,
+                "Only 32 and 64 bit floating point values are supported");
+  using type = typename std::conditional<sizeof(V) == 4, std::uint32_t,
+                                         std::uint64_t>::type;
+  static type get(V value) {
+    type bits;
+    std::memcpy(&bits, &value, sizeof(V));
+    const int shift = int(sizeof(V) * 8 - 1);
+    return bits ^ (type(0 - (bits >> shift)) | (type(1) << shift));
+  }
+};
+
+// LSD radix sort by bytes, stable, on the units themselves; the scratch
+// buffer must hold count units. Bytes shared by all the values (e.g. the top
+// bytes of timestamps from one batch) are skipped.
+
+template <typename Unit>
+void radix_sort(Unit *data, std::size_t count, Unit *scratch) {
+  using Key = RadixKey<decltype(raw_value(Unit()))>;
+  using KeyType = typename Key::type;
+  const int Passes = int(sizeof(KeyType));
+  std::size_t histogram[sizeof(KeyType)][256] = {};
+  for (std::size_t i = 0; i < count; ++i) {
+    const KeyType key = Key::get(raw_value(data[i]));
+    for (int p = 0; p < Passes; ++p)
+      ++histogram[p][(key >> (p * 8)) & 0xff];
+  }
+
+  Unit *src = data;
+  Unit *dst = scratch;
+  for (int p = 0; p < Passes && count > 0; ++p) {
+    std::size_t *offsets = histogram[p];
+    const KeyType first = Key::get(raw_value(src[0]));
+    if (offsets[(first >> (p * 8)) & 0xff] == count)
+      continue;
+    std::size_t sum = 0;
+    for (int digit = 0; digit < 256; ++digit) {
+      const std::size_t bucket = offsets[digit];
+      offsets[digit] = sum;
+      sum += bucket;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+      const KeyType key = Key::get(raw_value(src[i]));
+      dst[offsets[(key >> (p * 8)) & 0xff]++] = src[i];
+    }
+    Unit *tmp = src;
+    src = dst;
+    dst = tmp;
+  }
+  if (src != data)
+    for (std::size_t i = 0; i < count; ++i)
+      data[i] = src[i];
+}
+
+template <typename Unit> void radix_sort(Unit *data, std::size_t count) {
+  std::vector<Unit> scratch(count);
+  radix_sort(data, count, scratch.data());
+}
+
+// Batched branchless lower_bound over a sorted array: the searches of a group
+// of keys advance together, so their cache misses overlap instead of waiting
+// on each other, and the halving steps compile to conditional moves.
+
+template <typename Unit>
+void lower_bound_n(const Unit *sorted, std::size_t size, const Unit *keys,
+                   std::size_t count, std::size_t *out) {
+  using V = decltype(raw_value(Unit()));
+  const std::size_t Group = 16;
+  if (size == 0) {
+    for (std::size_t i = 0; i < count; ++i)
+      out[i] = 0;
+    return;
+  }
+  for (std::size_t start = 0; start < count; start += Group) {
+    const std::size_t group = count - start < Group ? count - start : Group;
+    const Unit *base[Group];
+    V key[Group];
+    for (std::size_t g = 0; g < group; ++g) {
+      base[g] = sorted;
+      key[g] = raw_value(keys[start + g]);
+    }
+    for (std::size_t len = size; len > 1; len -= len / 2) {
+      const std::size_t half = len / 2;
+      for (std::size_t g = 0; g < group; ++g)
+        base[g] = raw_value(base[g][half]) < key[g] ? base[g] + half : base[g];
+    }
+    for (std::size_t g = 0; g < group; ++g)
+      out[start + g] = std::size_t(base[g] - sorted) +
+                       (raw_value(*base[g]) < key[g] ? 1 : 0);
+  }
+}
+
+}; // namespace units
+
+namespace std {
+
+template <typename V, typename... Ts>
+struct hash<units::PhysicalUnit<V, Ts...>> {
+  size_t operator()(const units::PhysicalUnit<V, Ts...> &val) const {
+    return hash<V>()(val.value());
+  }
+};
+
+template <typename V, typename... Ts>
+struct hash<units::AbsolutePhysicalUnit<V, Ts...>> {
+  size_t operator()(const units::AbsolutePhysicalUnit<V, Ts...> &val) const {
+    return hash<V>()(val.value());
+  }
+};
+
+}; // namespace std
@@ -26,11 +26,6 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 namespace units {
 
-template <typename T> struct ResultingType {
-  using type = typename std::conditional<std::is_floating_point<T>::value, T,
-                                         double>::type;
-};
-
 template <typename ValType, typename Factor>
 using PhysicalUnitAngle =
     PhysicalUnit<ValType, Factor, std::ratio<0>, std::ratio<0>, std::ratio<0>,
@@ -49,7 +44,9 @@ public:
     setValue(initialValue);
   }
   constexpr AbsoluteAngle() : m_value(0) {}
+  explicit AbsoluteAngle(Uninitialized) {}
   constexpr AbsoluteAngle(const AbsoluteAngle &val) { setValue(val.value()); }
+  AbsoluteAngle &operator=(const AbsoluteAngle &val) = default;
   template <typename V, typename F, bool H>
   explicit AbsoluteAngle(const AbsoluteAngle<V, F, H> &val) {
     using outRatio = std::ratio_divide<F, Factor>;
@@ -73,15 +70,15 @@ public:
   }
 
   constexpr DiffAngleUnit operator-(const AbsoluteAngle &rhs) const {
-    return DiffAngleUnit(value - rhs.value());
+    return DiffAngleUnit(value() - rhs.value());
   }
 
   constexpr AbsoluteAngle operator-(const DiffAngleUnit &rhs) const {
-    return AbsoluteAngle(value - rhs.value());
+    return AbsoluteAngle(value() - rhs.value());
   }
 
   constexpr AbsoluteAngle operator+(const DiffAngleUnit &rhs) const {
-    return AbsoluteAngle(value + rhs.value());
+    return AbsoluteAngle(value() + rhs.value());
   }
 
   constexpr ValType value() const { return m_value; }
@@ -92,6 +89,13 @@ protected:
         std::ratio_multiply<std::ratio<360>,
                             std::ratio_divide<std::ratio<1>, Factor>>;
     ValType factor = ValType(fullCircle::num) / fullCircle::den;
+    // Values already within the interval, e.g. from the batch functions,
+    // skip the division
+    const ValType low = HalfInterval ? ValType(-(factor / 2)) : ValType(0);
+    if (!(value < low) && value < low + factor) {
+      m_value = value;
+      return;
+    }
     ValType result = std::fmod(value, factor);
     if (HalfInterval && (result >= (factor / 2))) {
       m_value = result - factor;
@@ -108,51 +112,54 @@ private:
 
 // Comparison operators for the AbsoluteAngle
 
-template <typename... Ts>
-inline constexpr bool operator==(const AbsoluteAngle<Ts...> &lhs,
-                                 const AbsoluteAngle<Ts...> &rhs) {
+template <typename V, typename F, bool H>
+inline constexpr bool operator==(const AbsoluteAngle<V, F, H> &lhs,
+                                 const AbsoluteAngle<V, F, H> &rhs) {
   return lhs.value() == rhs.value();
 }
 
-template <typename... Ts>
-inline constexpr bool operator!=(const AbsoluteAngle<Ts...> &lhs,
-                                 const AbsoluteAngle<Ts...> &rhs) {
+template <typename V, typename F, bool H>
+inline constexpr bool operator!=(const AbsoluteAngle<V, F, H> &lhs,
+                                 const AbsoluteAngle<V, F, H> &rhs) {
   return lhs.value() != rhs.value();
 }
 
-template <typename... Ts>
-inline constexpr bool operator<=(const AbsoluteAngle<Ts...> &lhs,
-                                 const AbsoluteAngle<Ts...> &rhs) {
+template <typename V, typename F, bool H>
+inline constexpr bool operator<=(const AbsoluteAngle<V, F, H> &lhs,
+                                 const AbsoluteAngle<V, F, H> &rhs) {
   return lhs.value() <= rhs.value();
 }
 
-template <typename... Ts>
-inline constexpr bool operator>=(const AbsoluteAngle<Ts...> &lhs,
-                                 const AbsoluteAngle<Ts...> &rhs) {
+template <typename V, typename F, bool H>
+inline constexpr bool operator>=(const AbsoluteAngle<V, F, H> &lhs,
+                                 const AbsoluteAngle<V, F, H> &rhs) {
   return lhs.value() >= rhs.value();
 }
 
-template <typename... Ts>
-inline constexpr bool operator<(const AbsoluteAngle<Ts...> &lhs,
-                                const AbsoluteAngle<Ts...> &rhs) {
+template <typename V, typename F, bool H>
+inline constexpr bool operator<(const AbsoluteAngle<V, F, H> &lhs,
+                                const AbsoluteAngle<V, F, H> &rhs) {
   return lhs.value() < rhs.value();
 }
 
-template <typename... Ts>
-inline constexpr bool operator>(const AbsoluteAngle<Ts...> &lhs,
-                                const AbsoluteAngle<Ts...> &rhs) {
+template <typename V, typename F, bool H>
+inline constexpr bool operator>(const AbsoluteAngle<V, F, H> &lhs,
+                                const AbsoluteAngle<V, F, H> &rhs) {
   return lhs.value() > rhs.value();
 }
 
 using RadianRatio = std::ratio<57296, 1000>;
 
+template <typename V, typename F, bool H>
+struct UnitDimension<AbsoluteAngle<V, F, H>>
+    : UnitDimension<typename AbsoluteAngle<V, F, H>::DiffAngleUnit> {};
+
 }; // namespace units
 
 namespace std {
-template <typename V, typename... Args>
-units::AbsoluteAngle<V, Args...>
-abs(const units::AbsoluteAngle<V, Args...> &val) {
-  return abs(val.value());
+template <typename V, typename F, bool H>
+units::AbsoluteAngle<V, F, H> abs(const units::AbsoluteAngle<V, F, H> &val) {
+  return units::AbsoluteAngle<V, F, H>(abs(val.value()));
 }
 
 }; // namespace std
@@ -0,0 +1,202 @@
+/*
+Copyright 2024 Nikola Jelic <nikola.jelic83@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the “Software”), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "phys_units.hpp"
+#include <cstddef>
+#include <type_traits>
+
+namespace units {
+
+// Streaming cumulative integral of a sample stream over time
+// Each output is the integral from the first sample up to the current one.
+// The step is either fixed at construction or taken from timestamps, which
+// may be absolute time units. The Simpson variant integrates each interval
+// over the parabola through the last three samples, falling back to the
+// trapezoid for the first interval. State is kept between calls, so
+// unbounded streams can be processed in chunks.
+
+template <typename SampleUnit, typename TimeUnit, bool Simpson>
+class CumulativeIntegral {
+  static_assert(
+      std::is_same<typename DiffUnitType<SampleUnit>::type, SampleUnit>::value,
+      "Integral of an absolute unit depends on its offset");
+
+public:
+  using TimeValue = decltype(raw_value(TimeUnit()));
+  using CalcType = typename ResultingType<decltype(
+      raw_value(SampleUnit()) * raw_value(TimeUnit()))>::type;
+  using StepUnit =
+      typename RebindValueType<typename DiffUnitType<TimeUnit>::type,
+                               CalcType>::type;
+  using ResultUnit =
+      decltype(typename RebindValueType<SampleUnit, CalcType>::type() *
+               StepUnit());
+
+  explicit CumulativeIntegral(const StepUnit &step = StepUnit(),
+                              const ResultUnit &initial = ResultUnit())
+      : m_step(step.value()) {
+    reset(initial);
+  }
+
+  void reset(const ResultUnit &initial = ResultUnit()) {
+    m_sum = initial.value();
+    m_count = 0;
+    m_prev[0] = m_prev[1] = 0;
+    m_prevStep = 0;
+    m_lastTime = 0;
+  }
+
+  ResultUnit value() const { return ResultUnit(m_sum); }
+
+  void process(const SampleUnit *in, std::size_t count, ResultUnit *out) {
+    for (std::size_t i = 0; i < count; ++i)
+      out[i] = ResultUnit(push(CalcType(raw_value(in[i])), m_step));
+  }
+
+  void process(const SampleUnit *in, const TimeUnit *times, std::size_t count,
+               ResultUnit *out) {
+    for (std::size_t i = 0; i < count; ++i) {
+      const TimeValue now = raw_value(times[i]);
+      const CalcType step = m_count ? CalcType(now - m_lastTime) : 0;
+      m_lastTime = now;
+      out[i] = ResultUnit(push(CalcType(raw_value(in[i])), step));
+    }
+  }
+
+private:
+  CalcType push(CalcType sample, CalcType step) {
+    if (m_count > 1 && Simpson && m_prevStep > 0 && step > 0) {
+      const CalcType h1 = m_prevStep, h2 = step;
+      m_sum += -h2 * h2 * h2 / (6 * h1 * (h1 + h2)) * m_prev[0] +
+               h2 * (h2 + 3 * h1) / (6 * h1) * m_prev[1] +
+               h2 * (2 * h2 + 3 * h1) / (6 * (h1 + h2)) * sample;
+    } else if (m_count > 0) {
+      m_sum += step * (m_prev[1] + sample) / 2;
+    }
+    m_prev[0] = m_prev[1];
+    m_prev[1] = sample;
+    m_prevStep = step;
+    m_count = m_count < 2 ? m_count + 1 : 2;
+    return m_sum;
+  }
+
+  CalcType m_step;
+  CalcType m_sum;
+  CalcType m_prev[2];
+  CalcType m_prevStep;
+  TimeValue m_lastTime;
+  int m_count;
+};
+
+template <typename SampleUnit, typename TimeUnit>
+using CumulativeTrapezoid = CumulativeIntegral<SampleUnit, TimeUnit, false>;
+
+template <typename SampleUnit, typename TimeUnit>
+using CumulativeSimpson = CumulativeIntegral<SampleUnit, TimeUnit, true>;
+
+// Streaming finite difference derivative
+// The backward difference emits one rate per sample, except for the very first
+// sample of the stream. The central difference is second order accurate also
+// on uneven timestamps and lags one sample behind. process() returns the
+// number of rates written.
+
+template <typename SampleUnit, typename TimeUnit, bool Central>
+class FiniteDifference {
+public:
+  using TimeValue = decltype(raw_value(TimeUnit()));
+  using CalcType = typename ResultingType<decltype(
+      raw_value(SampleUnit()) * raw_value(TimeUnit()))>::type;
+  using StepUnit =
+      typename RebindValueType<typename DiffUnitType<TimeUnit>::type,
+                               CalcType>::type;
+  using ResultUnit = decltype(
+      typename RebindValueType<typename DiffUnitType<SampleUnit>::type,
+                               CalcType>::type() /
+      StepUnit());
+
+  explicit FiniteDifference(const StepUnit &step = StepUnit())
+      : m_step(step.value()) {
+    reset();
+  }
+
+  void reset() {
+    m_count = 0;
+    m_prev[0] = m_prev[1] = 0;
+    m_prevStep = 0;
+    m_lastTime = 0;
+  }
+
+  std::size_t process(const SampleUnit *in, std::size_t count,
+                      ResultUnit *out) {
+    std::size_t written = 0;
+    for (std::size_t i = 0; i < count; ++i)
+      written += push(CalcType(raw_value(in[i])), m_step, out + written);
+    return written;
+  }
+
+  std::size_t process(const SampleUnit *in, const TimeUnit *times,
+                      std::size_t count, ResultUnit *out) {
+    std::size_t written = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      const TimeValue now = raw_value(times[i]);
+      const CalcType step = m_count ? CalcType(now - m_lastTime) : 0;
+      m_lastTime = now;
+      written += push(CalcType(raw_value(in[i])), step, out + written);
+    }
+    return written;
+  }
+
+private:
+  std::size_t push(CalcType sample, CalcType step, ResultUnit *out) {
+    std::size_t written = 0;
+    if (Central && m_count > 1) {
+      const CalcType h1 = m_prevStep, h2 = step;
+      *out = ResultUnit(-h2 / (h1 * (h1 + h2)) * m_prev[0] +
+                        (h2 - h1) / (h1 * h2) * m_prev[1] +
+                        h1 / (h2 * (h1 + h2)) * sample);
+      written = 1;
+    } else if (!Central && m_count > 0) {
+      *out = ResultUnit((sample - m_prev[1]) / step);
+      written = 1;
+    }
+    m_prev[0] = m_prev[1];
+    m_prev[1] = sample;
+    m_prevStep = step;
+    m_count = m_count < 2 ? m_count + 1 : 2;
+    return written;
+  }
+
+  CalcType m_step;
+  CalcType m_prev[2];
+  CalcType m_prevStep;
+  TimeValue m_lastTime;
+  int m_count;
+};
+
+template <typename SampleUnit, typename TimeUnit>
+using BackwardDifference = FiniteDifference<SampleUnit, TimeUnit, false>;
+
+template <typename SampleUnit, typename TimeUnit>
+using CentralDifference = FiniteDifference<SampleUnit, TimeUnit, true>;
+
+}; // namespace units
@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "phys_units.hpp"
 #include <chrono>
+#include <cstddef>
 
 namespace std::chrono {
 
@@ -32,6 +33,16 @@ duration_cast(const units::PhysicalUnit<Rep, Period, std::ratio<0>,
                                         std::ratio<0>, std::ratio<1>> &val) {
   return std::chrono::duration<Rep, Period>(val.value());
 }
+
+template <typename TimePoint, typename V, typename F, typename D, typename O>
+constexpr TimePoint
+time_point_cast(const units::AbsolutePhysicalUnit<
+                V, F, D, O, std::ratio<0>, std::ratio<0>, std::ratio<1>> &val) {
+  using Duration = typename TimePoint::duration;
+  return TimePoint(Duration(
+      units::AbsoluteRescale<F, O, typename Duration::period, std::ratio<0>>::
+          template apply<typename Duration::rep>(val.value())));
+}
 }; // namespace std::chrono
 
 namespace units {
@@ -43,4 +54,37 @@ unit_cast(const std::chrono::duration<V, F> &val) {
       val.count());
 }
 
+// Time points are taken as absolute time, with the clock epoch as zero
+
+template <typename C, typename V, typename F>
+constexpr AbsolutePhysicalUnit<V, F, V, std::ratio<0>, std::ratio<0>,
+                               std::ratio<0>, std::ratio<1>>
+unit_cast(const std::chrono::time_point<C, std::chrono::duration<V, F>> &val) {
+  return AbsolutePhysicalUnit<V, F, V, std::ratio<0>, std::ratio<0>,
+                              std::ratio<0>, std::ratio<1>>(
+      val.time_since_epoch().count());
+}
+
+template <typename ToType, typename C, typename V, typename F>
+constexpr ToType
+unit_cast(const std::chrono::time_point<C, std::chrono::duration<V, F>> &val) {
+  return ToType(AbsoluteRescale<F, std::ratio<0>, typename ToType::ConvFactor,
+                                typename ToType::ConvOffset>::
+                    template apply<typename ToType::ValueType>(
+                        val.time_since_epoch().count()));
+}
+
+// Bulk conversion of raw clock ticks of the given period, counted from Epoch
+// seconds after zero, into absolute timestamps
+
+template <typename ToType, typename Period, typename Epoch = std::ratio<0>,
+          typename Rep>
+void timestamp_cast_n(const Rep *ticks, std::size_t count, ToType *out) {
+  using Rescale = AbsoluteRescale<Period, Epoch, typename ToType::ConvFactor,
+                                  typename ToType::ConvOffset>;
+  for (std::size_t i = 0; i < count; ++i)
+    out[i] = ToType(
+        Rescale::template apply<typename ToType::ValueType>(ticks[i]));
+}
+
 }; // namespace units
@@ -0,0 +1,275 @@
+/*
+Copyright 2024 Nikola Jelic <nikola.jelic83@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the “Software”), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "phys_angle.hpp"
+#include "phys_fastmath.hpp"
+#include "phys_units.hpp"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace units {
+
+// Turn of an angle type in its own units, the period of its normalization,
+// e.g. 360 for degrees and 65536 for binary angles in 360/65536 degrees
+
+template <typename Angle> struct Circle {
+  using ValueType = typename Angle::ValueType;
+  using Turn = std::ratio_multiply<
+      std::ratio<360>,
+      std::ratio_divide<std::ratio<1>, typename Angle::ConvFactor>>;
+  static_assert(std::is_floating_point<ValueType>::value || Turn::den == 1,
+                "Integral angles need a whole number of units per turn");
+  enum : std::size_t { Block = 256 };
+
+  static constexpr ValueType full() {
+    return ValueType(Turn::num) / ValueType(Turn::den);
+  }
+};
+
+// Wrapping arithmetic on raw angle values, without branches
+// Integral values compare into 0 or 1 multiples of the turn, floating point
+// values into compare and mask instructions. Unsigned values, e.g. binary
+// angles, are taken as signed so that differences can be negative.
+
+template <typename V, bool Integral = std::is_integral<V>::value>
+struct CircleWrap {
+  using Wide = typename std::make_signed<decltype(V() + 0)>::type;
+  using Signed = typename std::make_signed<V>::type;
+
+  // Difference of two normalized values into [-turn / 2, turn / 2)
+  static Wide arc(Wide d, Wide full) {
+    const Wide half = full / 2;
+    return d + full * Wide(d < -half) - full * Wide(d >= half);
+  }
+
+  // a + t * d, with t in Q16 and the product rounded to the nearest
+  static Wide lerp(Wide a, Wide d, std::int64_t t16) {
+    return a + Wide((std::int64_t(d) * t16 + 32768) >> 16);
+  }
+
+  // Unsigned angles cannot hold the results below zero, they go up a turn
+  static Wide store(Wide value, Wide full) {
+    return value + full * Wide(std::is_unsigned<V>::value && value < 0);
+  }
+
+  static std::int64_t weight(double t) {
+    return std::int64_t(std::floor(t * 65536 + 0.5));
+  }
+};
+
+template <typename V> struct CircleWrap<V, false> {
+  using Wide = double;
+  using Signed = V;
+
+  static double arc(double d, double full) {
+    const double half = full / 2;
+    d = d + (d < -half ? full : 0.);
+    return d - (d >= half ? full : 0.);
+  }
+
+  static double lerp(double a, double d, double t) { return a + t * d; }
+
+  static double store(double value, double) { return value; }
+
+  static double weight(double t) { return t; }
+};
+
+// Mean direction and mean resultant length of a set of angles
+// The resultant length is 1 for equal angles and near 0 for spread ones; the
+// circular variance is its complement.
+
+template <typename Angle> struct CircularStats {
+  Angle mean;
+  double resultant;
+
+  double variance() const { return 1 - resultant; }
+};
+
+template <typename V, typename F, bool H>
+CircularStats<AbsoluteAngle<V, F, H>>
+circular_stats(const AbsoluteAngle<V, F, H> *in, std::size_t count) {
+  using Angle = AbsoluteAngle<V, F, H>;
+  const double scale = AngleRadians<Angle>::scale;
+  double sinSums[4] = {0, 0, 0, 0}, cosSums[4] = {0, 0, 0, 0};
+  double radians[Circle<Angle>::Block], sines[Circle<Angle>::Block],
+      cosines[Circle<Angle>::Block];
+  for (std::size_t done = 0; done < count; done += Circle<Angle>::Block) {
+    const std::size_t n = count - done < Circle<Angle>::Block
+                              ? count - done
+                              : std::size_t(Circle<Angle>::Block);
+    for (std::size_t i = 0; i < n; ++i)
+      radians[i] = double(in[done + i].value()) * scale;
+    for (std::size_t i = 0; i < n; ++i)
+      FastMath::sincos(radians[i], sines[i], cosines[i]);
+    for (std::size_t i = 0; i < n; ++i) {
+      sinSums[i % 4] += sines[i];
+      cosSums[i % 4] += cosines[i];
+    }
+  }
+  const double sinSum = (sinSums[0] + sinSums[1]) + (sinSums[2] + sinSums[3]);
+  const double cosSum = (cosSums[0] + cosSums[1]) + (cosSums[2] + cosSums[3]);
+  if (count == 0)
+    return CircularStats<Angle>{Angle(), 0.};
+  using Wrap = CircleWrap<V>;
+  using Wide = typename Wrap::Wide;
+  const double mean = FastMath::atan2(sinSum, cosSum) / scale;
+  const double resultant =
+      std::sqrt(sinSum * sinSum + cosSum * cosSum) / double(count);
+  const Wide wide =
+      Wide(std::is_integral<V>::value ? std::floor(mean + 0.5) : mean);
+  return CircularStats<Angle>{
+      Angle(V(Wrap::store(wide, Wide(Circle<Angle>::full())))), resultant};
+}
+
+// Mean direction, e.g. 0 degrees for 350 and 10 degrees
+template <typename V, typename F, bool H>
+AbsoluteAngle<V, F, H> circular_mean(const AbsoluteAngle<V, F, H> *in,
+                                     std::size_t count) {
+  return circular_stats(in, count).mean;
+}
+
+template <typename V, typename F, bool H>
+double circular_variance(const AbsoluteAngle<V, F, H> *in,
+                         std::size_t count) {
+  return circular_stats(in, count).variance();
+}
+
+// Signed difference from one angle to another along the shorter way round,
+// in [-turn / 2, turn / 2), held in the signed type of unsigned angles
+
+template <typename V, typename F>
+using ArcAngle = PhysicalUnitAngle<typename CircleWrap<V>::Signed, F>;
+
+template <typename V, typename F, bool H>
+ArcAngle<V, F> shortest_arc(const AbsoluteAngle<V, F, H> &from,
+                            const AbsoluteAngle<V, F, H> &to) {
+  using Wrap = CircleWrap<V>;
+  using Wide = typename Wrap::Wide;
+  const Wide full = Circle<AbsoluteAngle<V, F, H>>::full();
+  return ArcAngle<V, F>(typename Wrap::Signed(
+      Wrap::arc(Wide(to.value()) - Wide(from.value()), full)));
+}
+
+template <typename V, typename F, bool H>
+void shortest_arc_n(const AbsoluteAngle<V, F, H> *from,
+                    const AbsoluteAngle<V, F, H> *to, std::size_t count,
+                    ArcAngle<V, F> *out) {
+  using Wrap = CircleWrap<V>;
+  using Wide = typename Wrap::Wide;
+  const Wide full = Circle<AbsoluteAngle<V, F, H>>::full();
+  for (std::size_t i = 0; i < count; ++i)
+    out[i] = ArcAngle<V, F>(typename Wrap::Signed(
+        Wrap::arc(Wide(to[i].value()) - Wide(from[i].value()), full)));
+}
+
+// Angle at the fraction t of the shorter way from one angle to another, e.g.
+// the smoothing of a heading by its new reading. Integral angles round t to
+// 1/65536. The few results past the ends of the interval are wrapped by the
+// angle itself. The output may be the first input.
+
+template <typename V, typename F, bool H>
+void interpolate_n(const AbsoluteAngle<V, F, H> *from,
+                   const AbsoluteAngle<V, F, H> *to, std::size_t count,
+                   double t, AbsoluteAngle<V, F, H> *out) {
+  using Angle = AbsoluteAngle<V, F, H>;
+  using Wrap = CircleWrap<V>;
+  using Wide = typename Wrap::Wide;
+  const Wide full = Circle<Angle>::full();
+  const auto weight = Wrap::weight(t);
+  for (std::size_t i = 0; i < count; ++i) {
+    const Wide a = Wide(from[i].value());
+    const Wide d = Wrap::arc(Wide(to[i].value()) - a, full);
+    out[i] = Angle(V(Wrap::store(Wrap::lerp(a, d, weight), full)));
+  }
+}
+
+template <typename V, typename F, bool H>
+AbsoluteAngle<V, F, H> interpolate(const AbsoluteAngle<V, F, H> &from,
+                                   const AbsoluteAngle<V, F, H> &to,
+                                   double t) {
+  AbsoluteAngle<V, F, H> out;
+  interpolate_n(&from, &to, 1, t, &out);
+  return out;
+}
+
+// Continuous angle from a stream of wrapped ones, e.g. a heading that turned
+// twice is 720 degrees rather than 0; each step takes the shorter way round.
+
+template <typename Angle,
+          typename W = typename CircleWrap<typename Angle::ValueType>::Signed>
+class AngleUnwrapper {
+public:
+  using Unwrapped = PhysicalUnitAngle<W, typename Angle::ConvFactor>;
+
+  AngleUnwrapper() : m_last(), m_total(0), m_started(false) {}
+
+  void reset() { m_started = false; }
+
+  // The first angle ever pushed starts the output at its own value
+  void push_n(const Angle *in, std::size_t count, Unwrapped *out) {
+    using Wrap = CircleWrap<typename Angle::ValueType>;
+    using Wide = typename Wrap::Wide;
+    const Wide full = Circle<Angle>::full();
+    if (count == 0)
+      return;
+    if (!m_started) {
+      m_last = in[0];
+      m_total = W(in[0].value());
+      m_started = true;
+    }
+    Wide steps[Circle<Angle>::Block];
+    for (std::size_t done = 0; done < count; done += Circle<Angle>::Block) {
+      const std::size_t n = count - done < Circle<Angle>::Block
+                                ? count - done
+                                : std::size_t(Circle<Angle>::Block);
+      steps[0] = Wide(in[done].value()) - Wide(m_last.value());
+      for (std::size_t i = 1; i < n; ++i)
+        steps[i] = Wide(in[done + i].value()) - Wide(in[done + i - 1].value());
+      for (std::size_t i = 0; i < n; ++i)
+        steps[i] = Wrap::arc(steps[i], full);
+      for (std::size_t i = 0; i < n; ++i) {
+        m_total += W(steps[i]);
+        out[done + i] = Unwrapped(m_total);
+      }
+      m_last = in[done + n - 1];
+    }
+  }
+
+  Unwrapped value() const { return Unwrapped(m_total); }
+
+private:
+  Angle m_last;
+  W m_total;
+  bool m_started;
+};
+
+template <typename V, typename F, bool H, typename W>
+void unwrap_n(const AbsoluteAngle<V, F, H> *in, std::size_t count,
+              PhysicalUnitAngle<W, F> *out) {
+  AngleUnwrapper<AbsoluteAngle<V, F, H>, W> unwrapper;
+  unwrapper.push_n(in, count, out);
+}
+
+}; // namespace units
@@ -0,0 +1,366 @@
+/*
+Copyright 2024 Nikola Jelic <nikola.jelic83@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the “Software”), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "phys_units.hpp"
+#include <cstdint>
+#include <ratio>
+#include <type_traits>
+
+namespace units {
+
+// Packed dimension: the eight exponents (length, mass, time, electric current,
+// temperature, amount, luminous intensity, angle) in one integer, eight bits
+// each, counted in twelfths so halves, thirds and quarters stay exact.
+// Multiplication adds the codes field by field instead of instantiating eight
+// std::ratio_add templates, and the mangled names shrink accordingly.
+
+using DimCode = std::uint64_t;
+
+template <DimCode Code> struct dim {
+  static constexpr DimCode code = Code;
+};
+
+struct DimPacking {
+  static constexpr int Count = 8;
+  static constexpr int Bits = 8;
+  static constexpr int Scale = 12;
+  static constexpr int Min = -128;
+  static constexpr int Max = 127;
+
+  static constexpr int field(DimCode code, int idx) {
+    return int((code >> (idx * Bits)) & 0xff) > Max
+               ? int((code >> (idx * Bits)) & 0xff) - 256
+               : int((code >> (idx * Bits)) & 0xff);
+  }
+
+  static constexpr DimCode place(int exponent, int idx) {
+    return DimCode(unsigned(exponent) & 0xffu) << (idx * Bits);
+  }
+
+  // Exponent num/den, in twelfths
+  static constexpr DimCode place(std::intmax_t num, std::intmax_t den,
+                                 int idx) {
+    return place(int(num * Scale / den), idx);
+  }
+
+  static constexpr bool fits(std::intmax_t exponent) {
+    return exponent >= Min && exponent <= Max;
+  }
+
+  static constexpr bool exact(std::intmax_t num, std::intmax_t den) {
+    return num * Scale % den == 0 && fits(num * Scale / den);
+  }
+
+  // Field-wise addition without carries between the fields
+  static constexpr DimCode add(DimCode lhs, DimCode rhs) {
+    return ((lhs & Low) + (rhs & Low)) ^ ((lhs ^ rhs) & High);
+  }
+
+  static constexpr DimCode negate(DimCode code) { return add(~code, Ones); }
+
+  // A field overflows when both operands share the sign the sum lacks
+  static constexpr bool adds(DimCode lhs, DimCode rhs) {
+    return (~(lhs ^ rhs) & (lhs ^ add(lhs, rhs)) & High) == 0;
+  }
+
+  // Only -128 has no negation, it stays negative
+  static constexpr bool negates(DimCode code) {
+    return (code & negate(code) & High) == 0;
+  }
+
+private:
+  static constexpr DimCode Ones = 0x0101010101010101ull;
+  static constexpr DimCode High = 0x8080808080808080ull;
+  static constexpr DimCode Low = ~High;
+};
+
+template <typename LenDim = std::ratio<0>, typename MassDim = std::ratio<0>,
+          typename TimeDim = std::ratio<0>, typename ElcurDim = std::ratio<0>,
+          typename TempDim = std::ratio<0>, typename AmmDim = std::ratio<0>,
+          typename LumDim = std::ratio<0>, typename AngleDim = std::ratio<0>>
+struct PackDim {
+  static_assert(DimPacking::exact(LenDim::num, LenDim::den) &&
+                    DimPacking::exact(MassDim::num, MassDim::den) &&
+                    DimPacking::exact(TimeDim::num, TimeDim::den) &&
+                    DimPacking::exact(ElcurDim::num, ElcurDim::den) &&
+                    DimPacking::exact(TempDim::num, TempDim::den) &&
+                    DimPacking::exact(AmmDim::num, AmmDim::den) &&
+                    DimPacking::exact(LumDim::num, LumDim::den) &&
+                    DimPacking::exact(AngleDim::num, AngleDim::den),
+                "Exponent must be a multiple of 1/12 within [-10, 10]");
+  using type = dim<DimPacking::place(LenDim::num, LenDim::den, 0) |
+                   DimPacking::place(MassDim::num, MassDim::den, 1) |
+                   DimPacking::place(TimeDim::num, TimeDim::den, 2) |
+                   DimPacking::place(ElcurDim::num, ElcurDim::den, 3) |
+                   DimPacking::place(TempDim::num, TempDim::den, 4) |
+                   DimPacking::place(AmmDim::num, AmmDim::den, 5) |
+                   DimPacking::place(LumDim::num, LumDim::den, 6) |
+                   DimPacking::place(AngleDim::num, AngleDim::den, 7)>;
+};
+
+template <typename Dim, int Index>
+using DimExponent = typename std::ratio<DimPacking::field(Dim::code, Index),
+                                        DimPacking::Scale>::type;
+
+template <typename Lhs, typename Rhs> struct DimMultiply {
+  static_assert(DimPacking::adds(Lhs::code, Rhs::code),
+                "Dimension exponent out of the packed range");
+  using type = dim<DimPacking::add(Lhs::code, Rhs::code)>;
+};
+
+template <typename Lhs, typename Rhs> struct DimDivide {
+  static_assert(DimPacking::negates(Rhs::code) &&
+                    DimPacking::adds(Lhs::code, DimPacking::negate(Rhs::code)),
+                "Dimension exponent out of the packed range");
+  using type = dim<DimPacking::add(Lhs::code, DimPacking::negate(Rhs::code))>;
+};
+
+template <typename ValType, typename Factor, typename Dim> class Quantity;
+
+// Expands the packed dimension back to the PhysicalUnit parameters
+
+template <typename ValType, typename Factor, typename Dim> struct UnpackDim {
+  using type =
+      PhysicalUnit<ValType, Factor, DimExponent<Dim, 0>, DimExponent<Dim, 1>,
+                   DimExponent<Dim, 2>, DimExponent<Dim, 3>,
+                   DimExponent<Dim, 4>, DimExponent<Dim, 5>,
+                   DimExponent<Dim, 6>, DimExponent<Dim, 7>>;
+};
+
+template <typename ValType, typename Factor, typename Dim> class Quantity {
+public:
+  using ValueType = ValType;
+  using ConvFactor = Factor;
+  using Dimension = Dim;
+
+  constexpr explicit Quantity(ValType initialValue) : m_value(initialValue) {}
+  constexpr Quantity() : m_value(0) {}
+  explicit Quantity(Uninitialized) {}
+  template <typename V, typename F>
+  /* converting constructor */
+  constexpr explicit Quantity(const Quantity<V, F, Dim> &val)
+      : m_value(UnitRescale<F, Factor>::template apply<ValType>(val.value())) {
+  }
+
+  template <typename V, typename F, typename... Dims,
+            typename = typename std::enable_if<std::is_same<
+                typename PackDim<Dims...>::type, Dim>::value>::type>
+  /* from the unpacked representation */
+  constexpr explicit Quantity(const PhysicalUnit<V, F, Dims...> &val)
+      : m_value(UnitRescale<F, Factor>::template apply<ValType>(val.value())) {
+  }
+
+  // Expanded lazily, only the conversions pay for the eight ratios
+  template <typename Unpacked = typename UnpackDim<ValType, Factor, Dim>::type>
+  constexpr Unpacked unpacked() const {
+    return Unpacked(m_value);
+  }
+
+  Quantity const &operator+=(const Quantity &rhs) {
+    m_value += rhs.value();
+    return *this;
+  }
+
+  Quantity const &operator-=(const Quantity &rhs) {
+    m_value -= rhs.value();
+    return *this;
+  }
+
+  Quantity const &operator*=(const ValType &rhs) {
+    m_value *= rhs;
+    return *this;
+  }
+
+  Quantity const &operator/=(const ValType &rhs) {
+    m_value /= rhs;
+    return *this;
+  }
+
+  constexpr Quantity const operator-() const { return Quantity(-m_value); }
+  constexpr ValType value() const { return m_value; }
+
+private:
+  ValType m_value;
+};
+
+template <typename ValType, typename Factor>
+class Quantity<ValType, Factor, dim<0>> {
+public:
+  constexpr explicit Quantity(ValType initialValue) : m_value(initialValue) {}
+  constexpr Quantity() : m_value(0) {}
+  explicit Quantity(Uninitialized) {}
+  constexpr operator ValType() const {
+    return m_value * Factor::num / Factor::den;
+  }
+
+private:
+  ValType m_value;
+};
+
+// Same parameter order as PhysicalUnit, with the dimensions packed
+
+template <typename ValType, typename Factor = std::ratio<1>,
+          typename LenDim = std::ratio<0>, typename MassDim = std::ratio<0>,
+          typename TimeDim = std::ratio<0>, typename ElcurDim = std::ratio<0>,
+          typename TempDim = std::ratio<0>, typename AmmDim = std::ratio<0>,
+          typename LumDim = std::ratio<0>, typename AngleDim = std::ratio<0>>
+using PackedUnit =
+    Quantity<ValType, Factor,
+             typename PackDim<LenDim, MassDim, TimeDim, ElcurDim, TempDim,
+                              AmmDim, LumDim, AngleDim>::type>;
+
+template <typename V1, typename V2, typename F, typename D>
+inline constexpr bool operator==(const Quantity<V1, F, D> &lhs,
+                                 const Quantity<V2, F, D> &rhs) {
+  return lhs.value() == rhs.value();
+}
+
+template <typename V1, typename V2, typename F, typename D>
+inline constexpr bool operator!=(const Quantity<V1, F, D> &lhs,
+                                 const Quantity<V2, F, D> &rhs) {
+  return lhs.value() != rhs.value();
+}
+
+template <typename V1, typename V2, typename F, typename D>
+inline constexpr bool operator<=(const Quantity<V1, F, D> &lhs,
+                                 const Quantity<V2, F, D> &rhs) {
+  return lhs.value() <= rhs.value();
+}
+
+template <typename V1, typename V2, typename F, typename D>
+inline constexpr bool operator>=(const Quantity<V1, F, D> &lhs,
+                                 const Quantity<V2, F, D> &rhs) {
+  return lhs.value() >= rhs.value();
+}
+
+template <typename V1, typename V2, typename F, typename D>
+inline constexpr bool operator<(const Quantity<V1, F, D> &lhs,
+                                const Quantity<V2, F, D> &rhs) {
+  return lhs.value() < rhs.value();
+}
+
+template <typename V1, typename V2, typename F, typename D>
+inline constexpr bool operator>(const Quantity<V1, F, D> &lhs,
+                                const Quantity<V2, F, D> &rhs) {
+  return lhs.value() > rhs.value();
+}
+
+template <typename V1, typename V2, typename F, typename D>
+constexpr auto operator+(const Quantity<V1, F, D> &lhs,
+                         const Quantity<V2, F, D> &rhs)
+    -> Quantity<decltype(lhs.value() + rhs.value()), F, D> {
+  return Quantity<decltype(lhs.value() + rhs.value()), F, D>(lhs.value() +
+                                                             rhs.value());
+}
+
+template <typename V1, typename V2, typename F, typename D>
+constexpr auto operator-(const Quantity<V1, F, D> &lhs,
+                         const Quantity<V2, F, D> &rhs)
+    -> Quantity<decltype(lhs.value() - rhs.value()), F, D> {
+  return Quantity<decltype(lhs.value() - rhs.value()), F, D>(lhs.value() -
+                                                             rhs.value());
+}
+
+template <typename V1, typename F1, typename D1, typename V2, typename F2,
+          typename D2>
+constexpr auto operator*(const Quantity<V1, F1, D1> &lhs,
+                         const Quantity<V2, F2, D2> &rhs)
+    -> Quantity<decltype(lhs.value() * rhs.value()),
+                std::ratio_multiply<F1, F2>,
+                typename DimMultiply<D1, D2>::type> {
+  return Quantity<decltype(lhs.value() * rhs.value()),
+                  std::ratio_multiply<F1, F2>,
+                  typename DimMultiply<D1, D2>::type>(lhs.value() *
+                                                      rhs.value());
+}
+
+template <typename V1, typename V2, typename F, typename D>
+constexpr auto operator*(const V1 &lhs, const Quantity<V2, F, D> &rhs)
+    -> Quantity<decltype(lhs * rhs.value()), F, D> {
+  return Quantity<decltype(lhs * rhs.value()), F, D>(lhs * rhs.value());
+}
+
+template <typename V1, typename F, typename D, typename V2>
+constexpr auto operator*(const Quantity<V1, F, D> &lhs, const V2 &rhs)
+    -> Quantity<decltype(lhs.value() * rhs), F, D> {
+  return Quantity<decltype(lhs.value() * rhs), F, D>(lhs.value() * rhs);
+}
+
+template <typename V1, typename F1, typename D1, typename V2, typename F2,
+          typename D2>
+constexpr auto operator/(const Quantity<V1, F1, D1> &lhs,
+                         const Quantity<V2, F2, D2> &rhs)
+    -> Quantity<decltype(lhs.value() / rhs.value()), std::ratio_divide<F1, F2>,
+                typename DimDivide<D1, D2>::type> {
+  return Quantity<decltype(lhs.value() / rhs.value()),
+                  std::ratio_divide<F1, F2>,
+                  typename DimDivide<D1, D2>::type>(lhs.value() / rhs.value());
+}
+
+template <typename V1, typename V2, typename F, typename D>
+constexpr auto operator/(const V1 &lhs, const Quantity<V2, F, D> &rhs)
+    -> Quantity<decltype(lhs / rhs.value()),
+                std::ratio_divide<std::ratio<1>, F>,
+                typename DimDivide<dim<0>, D>::type> {
+  return Quantity<decltype(lhs / rhs.value()),
+                  std::ratio_divide<std::ratio<1>, F>,
+                  typename DimDivide<dim<0>, D>::type>(lhs / rhs.value());
+}
+
+template <typename V1, typename F, typename D, typename V2>
+constexpr auto operator/(const Quantity<V1, F, D> &lhs, const V2 &rhs)
+    -> Quantity<decltype(lhs.value() / rhs), F, D> {
+  return Quantity<decltype(lhs.value() / rhs), F, D>(lhs.value() / rhs);
+}
+
+template <typename ToType, typename V, typename F, typename D>
+constexpr ToType unit_cast(const Quantity<V, F, D> &fromType) {
+  return ToType(fromType);
+}
+
+// Packed counterpart of a PhysicalUnit and back, e.g. to migrate declarations
+
+template <typename Unit> struct PackUnit {};
+
+template <typename V, typename F, typename... Dims>
+struct PackUnit<PhysicalUnit<V, F, Dims...>> {
+  using type = Quantity<V, F, typename PackDim<Dims...>::type>;
+};
+
+template <typename Unit> struct UnpackUnit {};
+
+template <typename V, typename F, typename D>
+struct UnpackUnit<Quantity<V, F, D>> {
+  using type = typename UnpackDim<V, F, D>::type;
+};
+
+template <typename V, typename F, typename D>
+struct UnitDimension<Quantity<V, F, D>>
+    : UnitDimension<typename UnpackDim<V, F, D>::type> {};
+
+template <typename V, typename OldV, typename F, typename D>
+struct RebindValueType<Quantity<OldV, F, D>, V> {
+  using type = Quantity<V, F, D>;
+};
+
+}; // namespace units
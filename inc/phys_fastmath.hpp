@@ -0,0 +1,217 @@
+/*
+Copyright 2024 Nikola Jelic <nikola.jelic83@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the “Software”), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "phys_angle.hpp"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace units {
+
+
+// Branch-free double precision functions for the batch kernels
+// Unlike the std functions they carry no errno or special case branches, so
+// loops calling them are vectorized. sincos takes |x| up to a few thousand
+// radians, sqrt takes non-negative values.
+
+struct FastMath {
+  static constexpr double Pi = 3.14159265358979323846;
+
+  static std::uint64_t bits(double x) {
+    std::uint64_t b;
+    std::memcpy(&b, &x, sizeof(b));
+    return b;
+  }
+
+  static double from_bits(std::uint64_t b) {
+    double x;
+    std::memcpy(&x, &b, sizeof(x));
+    return x;
+  }
+
+  // Bitwise selection by an all ones or all zeros mask, because conditions
+  // turned into branches or bool conversions stop the vectorizer
+  static double select(std::uint64_t mask, double a, double b) {
+    return from_bits((bits(a) & mask) | (bits(b) & ~mask));
+  }
+
+  static std::uint64_t negative(double x) { return 0 - (bits(x) >> 63); }
+
+  // Reduction by pi/2; the quadrant is read from the low bits of the value
+  // rounded with the 1.5 * 2^52 constant
+  static void sincos(double x, double &s, double &c) {
+    const double shifter = 6755399441055744.0;
+    const double rounded = x * 0.63661977236758134308 + shifter;
+    const std::uint64_t quadrant = bits(rounded);
+    const double j = rounded - shifter;
+    const double r = (x - j * 1.57079632673412561417e+00) -
+                     j * 6.07710050650619224932e-11;
+    const double z = r * r;
+    const double sr =
+        r + r * z *
+                (((((1.58962301576546568060e-10 * z -
+                     2.50507477628578072866e-8) *
+                        z +
+                    2.75573136213857245213e-6) *
+                       z -
+                   1.98412698295895385996e-4) *
+                      z +
+                  8.33333333332211858878e-3) *
+                     z -
+                 1.66666666666666307295e-1);
+    const double cr =
+        1 - 0.5 * z +
+        z * z *
+            (((((-1.13585365213876817300e-11 * z +
+                 2.08757008419747316778e-9) *
+                    z -
+                2.75573141792967388112e-7) *
+                   z +
+               2.48015872888517045348e-5) *
+                  z -
+              1.38888888888730564116e-3) *
+                 z +
+             4.16666666666665929218e-2);
+    const std::uint64_t swap = 0 - (quadrant & 1);
+    s = from_bits(bits(select(swap, cr, sr)) ^ ((quadrant & 2) << 62));
+    c = from_bits(bits(select(swap, sr, cr)) ^ (((quadrant + 1) & 2) << 62));
+  }
+
+  // Arc tangent of a in [0, 1]
+  static double atan_unit(double a) {
+    const std::uint64_t far = negative(0.41421356237309504880 - a);
+    const double t = select(far, (a - 1) / (a + 1), a);
+    const double z = t * t;
+    const double p =
+        (((-8.750608600031904122785e-1 * z - 1.615753718733365076637e1) * z -
+          7.500855792314704667340e1) *
+             z -
+         1.228866684490136173410e2) *
+            z -
+        6.485021904942025371773e1;
+    const double q =
+        ((((z + 2.485846490142306297962e1) * z + 1.650270098316988542046e2) *
+              z +
+          4.328810604912902668951e2) *
+             z +
+         4.853903996359136964868e2) *
+            z +
+        1.945506571482613964425e2;
+    return select(far, Pi / 4, 0.) + (t + t * z * p / q);
+  }
+
+  static double atan2(double y, double x) {
+    const double ax = std::fabs(x), ay = std::fabs(y);
+    const std::uint64_t steep = negative(ax - ay);
+    const double low = select(steep, ax, ay), high = select(steep, ay, ax);
+    double r = atan_unit(low / (high + 2.2250738585072014e-308));
+    r = select(steep, Pi / 2 - r, r);
+    r = select(negative(x), Pi - r, r);
+    return from_bits(bits(r) ^ (bits(y) & 0x8000000000000000ull));
+  }
+
+  // Arc sine of the square root of h in [0, 1], as the arc tangent of
+  // sqrt(h / (1 - h)), with a single square root
+  static double asin_sqrt(double h) {
+    const double g = 1 - h;
+    const std::uint64_t steep = negative(g - h);
+    const double low = select(steep, g, h), high = select(steep, h, g);
+    const double r =
+        atan_unit(sqrt(low / (high + 2.2250738585072014e-308)));
+    return select(steep, Pi / 2 - r, r);
+  }
+
+  // Newton iterations on the reciprocal square root
+  static double sqrt(double x) {
+    double y = from_bits(0x5fe6eb50c7b537a9ull - (bits(x) >> 1));
+    for (int i = 0; i < 4; ++i)
+      y = y * (1.5 - 0.5 * x * y * y);
+    return x * y;
+  }
+
+  // Natural logarithm of positive normal values, as in fdlibm: the mantissa
+  // is reduced into [sqrt(2)/2, sqrt(2)) and the exponent is read back into
+  // a double without an integer conversion
+  static double log(double x) {
+    const std::uint64_t hx = bits(x) + 0x00095f6200000000ull;
+    const double k =
+        from_bits(0x4330000000000000ull | (hx >> 52)) - 4503599627371519.0;
+    const double f =
+        from_bits((hx & 0x000fffff00000000ull) + 0x3fe6a09e00000000ull +
+                  (bits(x) & 0xffffffffull)) -
+        1;
+    const double hfsq = 0.5 * f * f;
+    const double s = f / (2 + f);
+    const double z = s * s;
+    const double w = z * z;
+    const double t1 = w * (3.999999999940941908e-01 +
+                           w * (2.222219843214978396e-01 +
+                                w * 1.531383769920937332e-01));
+    const double t2 =
+        z * (6.666666666666735130e-01 +
+             w * (2.857142874366239149e-01 +
+                  w * (1.818357216161805012e-01 +
+                       w * 1.479819860511658591e-01)));
+    return s * (hfsq + t1 + t2) + k * 1.90821492927058770002e-10 - hfsq + f +
+           k * 6.93147180369123816490e-01;
+  }
+};
+
+// Radians per unit of an angle type
+// Angles with the RadianRatio factor are taken as radians, so the kernels
+// read them without any rescaling; other factors are exact multiples of a
+// degree.
+
+template <typename Angle> struct AngleRadians {
+  using Factor = typename Angle::ConvFactor;
+  static constexpr double scale =
+      std::is_same<Factor, RadianRatio>::value
+          ? 1.
+          : double(Factor::num) / double(Factor::den) * FastMath::Pi / 180;
+};
+
+// Runs body(first, count) over the batch, split between threads when it is
+// large enough to pay for starting them
+template <typename Body>
+void batch_parallel(std::size_t count, unsigned threads, Body body) {
+  const std::size_t minChunk = 1 << 15;
+  if (threads <= 1 || count < 2 * minChunk) {
+    body(std::size_t(0), count);
+    return;
+  }
+  std::size_t chunk = (count + threads - 1) / threads;
+  chunk = chunk > minChunk ? chunk : minChunk;
+  std::vector<std::thread> helpers;
+  for (std::size_t first = chunk; first < count; first += chunk)
+    helpers.emplace_back(body, first, count - first < chunk ? count - first
+                                                            : chunk);
+  body(std::size_t(0), chunk);
+  for (auto &helper : helpers)
+    helper.join();
+}
+
+}; // namespace units
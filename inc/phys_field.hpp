@@ -0,0 +1,267 @@
+/*
+Copyright 2024 Nikola Jelic <nikola.jelic83@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the “Software”), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "phys_units.hpp"
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace units {
+
+// Two or three dimensional grid of a quantity
+// The holding values are stored x-fastest with a one cell halo around the
+// grid, so the stencils read their neighbours without branches. The halo is
+// addressed with the indices -1 and extent, and is set either to a fixed value
+// (fill_boundary) or to a copy of the edge (clamp_boundary). Fields of the
+// same extents share the layout, whatever their holding types.
+
+template <typename Unit, std::size_t Rank> class Field {
+  static_assert(Rank == 2 || Rank == 3, "Fields are two or three dimensional");
+
+public:
+  using UnitType = Unit;
+  using ValueType = decltype(raw_value(Unit()));
+  enum : std::size_t { Dimensions = Rank };
+
+  explicit Field(const std::size_t (&extents)[Rank],
+                 const Unit &initial = Unit()) {
+    m_extent[2] = 1;
+    for (std::size_t d = 0; d < Rank; ++d)
+      m_extent[d] = extents[d];
+    m_stride[0] = 1;
+    m_stride[1] = std::ptrdiff_t(m_extent[0] + 2);
+    m_stride[2] = m_stride[1] * std::ptrdiff_t(m_extent[1] + 2);
+    const std::size_t halo = Rank == 3 ? 1 : 0;
+    m_data.assign(std::size_t(m_stride[2]) * (m_extent[2] + 2 * halo),
+                  raw_value(initial));
+    m_origin = std::ptrdiff_t(halo) * m_stride[2] + m_stride[1] + 1;
+  }
+
+  std::size_t extent(std::size_t axis) const { return m_extent[axis]; }
+  std::ptrdiff_t stride(std::size_t axis) const { return m_stride[axis]; }
+
+  template <typename Other> bool same_extents(const Other &other) const {
+    for (std::size_t d = 0; d < Rank; ++d)
+      if (m_extent[d] != other.extent(d))
+        return false;
+    return Rank == Other::Dimensions;
+  }
+
+  // Holding value of the cell (0, 0, 0)
+  ValueType *data() { return m_data.data() + m_origin; }
+  const ValueType *data() const { return m_data.data() + m_origin; }
+
+  Unit operator()(std::ptrdiff_t x, std::ptrdiff_t y,
+                  std::ptrdiff_t z = 0) const {
+    return Unit(data()[offset(x, y, z)]);
+  }
+
+  void set(std::ptrdiff_t x, std::ptrdiff_t y, const Unit &value) {
+    data()[offset(x, y, 0)] = raw_value(value);
+  }
+
+  void set(std::ptrdiff_t x, std::ptrdiff_t y, std::ptrdiff_t z,
+           const Unit &value) {
+    data()[offset(x, y, z)] = raw_value(value);
+  }
+
+  void fill(const Unit &value) {
+    for (auto &cell : m_data)
+      cell = raw_value(value);
+  }
+
+  void fill_boundary(const Unit &value) {
+    for_each_halo([&value](ValueType &cell, const ValueType &) {
+      cell = raw_value(value);
+    });
+  }
+
+  void clamp_boundary() {
+    for_each_halo([](ValueType &cell, const ValueType &edge) { cell = edge; });
+  }
+
+private:
+  std::ptrdiff_t offset(std::ptrdiff_t x, std::ptrdiff_t y,
+                        std::ptrdiff_t z) const {
+    return x + y * m_stride[1] + z * m_stride[2];
+  }
+
+  static std::ptrdiff_t clamp(std::ptrdiff_t i, std::size_t extent) {
+    const std::ptrdiff_t last = std::ptrdiff_t(extent) - 1;
+    return i < 0 ? 0 : (i > last ? last : i);
+  }
+
+  // Calls body(halo cell, nearest grid cell) for every cell of the halo
+  template <typename Body> void for_each_halo(Body body) {
+    const std::ptrdiff_t nx = m_extent[0], ny = m_extent[1];
+    const std::ptrdiff_t nz = m_extent[2];
+    const std::ptrdiff_t z0 = Rank == 3 ? -1 : 0, z1 = Rank == 3 ? nz + 1 : 1;
+    ValueType *origin = data();
+    for (std::ptrdiff_t z = z0; z < z1; ++z)
+      for (std::ptrdiff_t y = -1; y <= ny; ++y) {
+        const bool inner = z >= 0 && z < nz && y >= 0 && y < ny;
+        for (std::ptrdiff_t x = -1; x <= nx; x += inner ? nx + 1 : 1)
+          body(origin[offset(x, y, z)],
+               origin[offset(clamp(x, nx), clamp(y, ny), clamp(z, nz))]);
+      }
+  }
+
+  std::size_t m_extent[3];
+  std::ptrdiff_t m_stride[3];
+  std::ptrdiff_t m_origin;
+  std::vector<ValueType> m_data;
+};
+
+// Runs a row kernel over a field, tile by tile, on a number of threads
+// A tile is a segment of the rows short enough for the input rows around it
+// and the output row to stay in L1, and tall enough for the three planes of
+// a 3D stencil to stay in L2. The kernel is called as kernel(in, out, count)
+// with the holding values of the first cell of a row segment in the input
+// and the output field, and it reaches the neighbours through the strides.
+
+class StencilExecutor {
+public:
+  enum : std::size_t { L1Bytes = 32 * 1024, L2Bytes = 512 * 1024 };
+
+  explicit StencilExecutor(unsigned threads = 1)
+      : m_threads(threads ? threads : 1) {}
+
+  unsigned threads() const { return m_threads; }
+
+  // Returns false, without running the kernel, if the extents differ
+  template <typename InField, typename OutField, typename RowKernel>
+  bool run(const InField &in, OutField &out, RowKernel kernel) const {
+    if (!in.same_extents(out))
+      return false;
+    const std::size_t bytes = sizeof(typename InField::ValueType);
+    const std::size_t nx = in.extent(0), ny = in.extent(1);
+    const std::size_t nz = InField::Dimensions == 3 ? in.extent(2) : 1;
+    const std::size_t width = clamp(L1Bytes / (4 * bytes), nx);
+    const std::size_t height = clamp(L2Bytes / (3 * width * bytes), ny);
+    const std::size_t depth = clamp(nz / m_threads, nz);
+    const std::size_t tilesX = (nx + width - 1) / width;
+    const std::size_t tilesY = (ny + height - 1) / height;
+    const std::size_t tiles = tilesX * tilesY * ((nz + depth - 1) / depth);
+    std::atomic<std::size_t> next(0);
+    auto worker = [&]() {
+      // Local copy, so the stores cannot alias the captures of the kernel
+      RowKernel rows(kernel);
+      for (std::size_t t = next++; t < tiles; t = next++) {
+        const std::size_t x0 = t % tilesX * width;
+        const std::size_t y0 = t / tilesX % tilesY * height;
+        const std::size_t z0 = t / tilesX / tilesY * depth;
+        const std::size_t count = x0 + width < nx ? width : nx - x0;
+        for (std::size_t z = z0; z < z0 + depth && z < nz; ++z)
+          for (std::size_t y = y0; y < y0 + height && y < ny; ++y) {
+            const std::ptrdiff_t at = std::ptrdiff_t(x0) +
+                                      std::ptrdiff_t(y) * in.stride(1) +
+                                      std::ptrdiff_t(z) * in.stride(2);
+            rows(in.data() + at, out.data() + at, count);
+          }
+      }
+    };
+    std::vector<std::thread> helpers;
+    for (unsigned i = 1; i < m_threads && i < tiles; ++i)
+      helpers.emplace_back(worker);
+    worker();
+    for (auto &helper : helpers)
+      helper.join();
+    return true;
+  }
+
+private:
+  static std::size_t clamp(std::size_t value, std::size_t limit) {
+    return value < 1 ? 1 : (value > limit ? limit : value);
+  }
+
+  unsigned m_threads;
+};
+
+// Units of the finite differences of a field with the given grid spacing
+// The differences of an absolute unit are in its difference unit, e.g. the
+// gradient of a TempKelvin field is in kelvins per meter.
+
+template <typename Unit, typename LengthUnit> struct FieldDerivative {
+  using CalcType = typename ResultingType<decltype(
+      raw_value(Unit()) * raw_value(LengthUnit()))>::type;
+  using DiffUnit =
+      typename RebindValueType<typename DiffUnitType<Unit>::type,
+                               CalcType>::type;
+  using StepUnit = typename RebindValueType<LengthUnit, CalcType>::type;
+  using GradientUnit = decltype(DiffUnit() / StepUnit());
+  using LaplacianUnit = decltype(DiffUnit() / (StepUnit() * StepUnit()));
+};
+
+// Central difference along one axis, for every cell of the grid
+template <typename Unit, std::size_t Rank, typename LengthUnit>
+bool gradient(
+    const Field<Unit, Rank> &in, const LengthUnit &spacing, std::size_t axis,
+    Field<typename FieldDerivative<Unit, LengthUnit>::GradientUnit, Rank> &out,
+    const StencilExecutor &executor = StencilExecutor()) {
+  using Derivative = FieldDerivative<Unit, LengthUnit>;
+  using CalcType = typename Derivative::CalcType;
+  using InValue = typename Field<Unit, Rank>::ValueType;
+  using OutValue = decltype(raw_value(typename Derivative::GradientUnit()));
+  if (axis >= Rank)
+    return false;
+  const CalcType scale = CalcType(1) / (2 * CalcType(raw_value(spacing)));
+  const std::ptrdiff_t step = in.stride(axis);
+  auto kernel = [scale, step](const InValue *src, OutValue *dst,
+                              std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i)
+      dst[i] =
+          OutValue((CalcType(src[i + step]) - CalcType(src[i - step])) * scale);
+  };
+  return executor.run(in, out, kernel);
+}
+
+// Second order Laplacian, for every cell of the grid
+template <typename Unit, std::size_t Rank, typename LengthUnit>
+bool laplacian(
+    const Field<Unit, Rank> &in, const LengthUnit &spacing,
+    Field<typename FieldDerivative<Unit, LengthUnit>::LaplacianUnit, Rank>
+        &out,
+    const StencilExecutor &executor = StencilExecutor()) {
+  using Derivative = FieldDerivative<Unit, LengthUnit>;
+  using CalcType = typename Derivative::CalcType;
+  using InValue = typename Field<Unit, Rank>::ValueType;
+  using OutValue = decltype(raw_value(typename Derivative::LaplacianUnit()));
+  const CalcType h = CalcType(raw_value(spacing));
+  const CalcType scale = CalcType(1) / (h * h);
+  const std::ptrdiff_t sy = in.stride(1), sz = in.stride(2);
+  auto kernel = [scale, sy, sz](const InValue *src, OutValue *dst,
+                                std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+      CalcType sum = CalcType(src[i - 1]) + CalcType(src[i + 1]) +
+                     CalcType(src[i - sy]) + CalcType(src[i + sy]) -
+                     CalcType(2 * Rank) * CalcType(src[i]);
+      if (Rank == 3)
+        sum += CalcType(src[i - sz]) + CalcType(src[i + sz]);
+      dst[i] = OutValue(sum * scale);
+    }
+  };
+  return executor.run(in, out, kernel);
+}
+
+}; // namespace units
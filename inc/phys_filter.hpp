@@ -0,0 +1,337 @@
+/*
+Copyright 2024 Nikola Jelic <nikola.jelic83@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the “Software”), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "phys_si.hpp"
+#include "phys_units.hpp"
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace units {
+
+// Dimensionless filter coefficient, e.g. Coefficient<>(0.25)
+template <typename V = double> using Coefficient = PhysicalUnit<V>;
+
+// Biquad section, normalized so that a0 is one
+struct Biquad {
+  Coefficient<> b0, b1, b2, a1, a2;
+};
+
+// Arithmetic of the filter kernels
+// Floating point holding types are filtered in their own type. Integral ones
+// are filtered in fixed point, with coefficients holding FracBits fractional
+// bits, a 64-bit accumulator and outputs rounded to nearest and saturated.
+
+template <typename V, unsigned FracBits,
+          bool = std::is_floating_point<V>::value>
+struct FilterArithmetic {
+  using Coef = V;
+  using Acc = V;
+
+  static Coef quantize(double coefficient) { return Coef(coefficient); }
+  static V output(Acc acc) { return acc; }
+  static V output(Acc acc, Acc &) { return acc; }
+};
+
+template <typename V, unsigned FracBits>
+struct FilterArithmetic<V, FracBits, false> {
+  static_assert(FracBits > 0 && FracBits < 31, "Coefficients are 32-bit");
+  using Coef = int32_t;
+  using Acc = int64_t;
+
+  static Coef quantize(double coefficient) {
+    return Coef(std::lround(std::ldexp(coefficient, FracBits)));
+  }
+
+  static V output(Acc acc) {
+    return saturate((acc + (Acc(1) << (FracBits - 1))) >> FracBits);
+  }
+
+  // Carries the truncated fraction into the next output, which removes the
+  // dead band of the recursive filters
+  static V output(Acc acc, Acc &residual) {
+    acc += residual;
+    const Acc whole = acc >> FracBits;
+    residual = acc - (whole << FracBits);
+    return saturate(whole);
+  }
+
+  static V saturate(Acc value) {
+    const Acc low = Acc(std::numeric_limits<V>::min());
+    const Acc high = Acc(std::numeric_limits<V>::max());
+    return V(value < low ? low : (value > high ? high : value));
+  }
+};
+
+// Finite impulse response filter over a unit stream
+// The output has the unit of the input. Samples are processed in blocks: the
+// history and the block are kept in one line, and the block outputs are
+// accumulated one tap at a time, which lets the compiler vectorize the inner
+// loop. The history is kept between calls, so unbounded streams can be
+// processed in chunks.
+
+template <typename Unit, std::size_t Taps, unsigned FracBits = 14>
+class FirFilter {
+  static_assert(Taps > 0, "Filter needs at least one tap");
+
+public:
+  using ValueType = decltype(raw_value(Unit()));
+  using Arithmetic = FilterArithmetic<ValueType, FracBits>;
+  using Acc = typename Arithmetic::Acc;
+  enum : std::size_t { Block = 64 };
+
+  template <typename V, typename F>
+  explicit FirFilter(const PhysicalUnit<V, F> (&coefficients)[Taps])
+      : m_coef{}, m_line{} {
+    for (std::size_t k = 0; k < Taps; ++k)
+      m_coef[k] = Arithmetic::quantize(double(coefficients[k]));
+    reset();
+  }
+
+  template <typename V, typename F>
+  explicit FirFilter(const std::array<PhysicalUnit<V, F>, Taps> &coefficients)
+      : m_coef{}, m_line{} {
+    for (std::size_t k = 0; k < Taps; ++k)
+      m_coef[k] = Arithmetic::quantize(double(coefficients[k]));
+    reset();
+  }
+
+  // Fills the history, e.g. with the first sample to avoid the start-up ramp
+  void reset(const Unit &initial = Unit()) {
+    for (std::size_t i = 0; i < Taps - 1; ++i)
+      m_line[i] = raw_value(initial);
+  }
+
+  void process(const Unit *in, std::size_t count, Unit *out) {
+    while (count > 0) {
+      const std::size_t n = count < Block ? count : std::size_t(Block);
+      for (std::size_t j = 0; j < n; ++j)
+        m_line[Taps - 1 + j] = raw_value(in[j]);
+      // Whole blocks are accumulated even for a short tail, so the inner
+      // loop has a constant trip count; the outputs past n are dropped
+      Acc acc[Block] = {};
+      for (std::size_t k = 0; k < Taps; ++k) {
+        const Acc coef = Acc(m_coef[k]);
+        const ValueType *src = m_line + Taps - 1 - k;
+        for (std::size_t j = 0; j < Block; ++j)
+          acc[j] += coef * Acc(src[j]);
+      }
+      for (std::size_t j = 0; j < n; ++j)
+        out[j] = Unit(Arithmetic::output(acc[j]));
+      for (std::size_t i = 0; i < Taps - 1; ++i)
+        m_line[i] = m_line[n + i];
+      in += n;
+      out += n;
+      count -= n;
+    }
+  }
+
+private:
+  typename Arithmetic::Coef m_coef[Taps];
+  ValueType m_line[Taps - 1 + Block];
+};
+
+// Cascade of biquad sections in direct form I
+// The cascade runs sample by sample, so the dependency chains of the sections
+// overlap. Integral streams are saturated after every section, with the
+// rounding error fed back into the next sample.
+
+template <typename Unit, std::size_t Sections = 1, unsigned FracBits = 14>
+class BiquadFilter {
+  static_assert(Sections > 0, "Filter needs at least one section");
+
+public:
+  using ValueType = decltype(raw_value(Unit()));
+  using Arithmetic = FilterArithmetic<ValueType, FracBits>;
+  using Acc = typename Arithmetic::Acc;
+
+  explicit BiquadFilter(const Biquad (&sections)[Sections]) {
+    for (std::size_t s = 0; s < Sections; ++s) {
+      m_coef[s][0] = Acc(Arithmetic::quantize(double(sections[s].b0)));
+      m_coef[s][1] = Acc(Arithmetic::quantize(double(sections[s].b1)));
+      m_coef[s][2] = Acc(Arithmetic::quantize(double(sections[s].b2)));
+      m_coef[s][3] = Acc(Arithmetic::quantize(-double(sections[s].a1)));
+      m_coef[s][4] = Acc(Arithmetic::quantize(-double(sections[s].a2)));
+    }
+    reset();
+  }
+
+  void reset() {
+    for (std::size_t s = 0; s < Sections; ++s) {
+      m_x[s][0] = m_x[s][1] = m_y[s][0] = m_y[s][1] = ValueType(0);
+      m_residual[s] = Acc(0);
+    }
+  }
+
+  void process(const Unit *in, std::size_t count, Unit *out) {
+    for (std::size_t i = 0; i < count; ++i) {
+      ValueType x = raw_value(in[i]);
+      for (std::size_t s = 0; s < Sections; ++s) {
+        const Acc *c = m_coef[s];
+        const ValueType y = Arithmetic::output(
+            c[0] * Acc(x) + c[1] * Acc(m_x[s][0]) + c[2] * Acc(m_x[s][1]) +
+                c[3] * Acc(m_y[s][0]) + c[4] * Acc(m_y[s][1]),
+            m_residual[s]);
+        m_x[s][1] = m_x[s][0];
+        m_x[s][0] = x;
+        m_y[s][1] = m_y[s][0];
+        m_y[s][0] = y;
+        x = y;
+      }
+      out[i] = Unit(x);
+    }
+  }
+
+private:
+  Acc m_coef[Sections][5];
+  ValueType m_x[Sections][2];
+  ValueType m_y[Sections][2];
+  Acc m_residual[Sections];
+};
+
+// Moving average over the last Length samples, with a running sum
+// Integral streams are summed exactly and rounded to nearest.
+
+template <typename Unit, std::size_t Length> class MovingAverage {
+  static_assert(Length > 0, "Average needs at least one sample");
+
+public:
+  using ValueType = decltype(raw_value(Unit()));
+  using SumType =
+      typename std::conditional<std::is_floating_point<ValueType>::value,
+                                decltype(ValueType() + double()),
+                                int64_t>::type;
+
+  explicit MovingAverage(const Unit &initial = Unit()) { reset(initial); }
+
+  void reset(const Unit &initial = Unit()) {
+    for (std::size_t i = 0; i < Length; ++i)
+      m_history[i] = raw_value(initial);
+    m_sum = SumType(raw_value(initial)) * SumType(Length);
+    m_pos = 0;
+  }
+
+  void process(const Unit *in, std::size_t count, Unit *out) {
+    for (std::size_t i = 0; i < count; ++i) {
+      const ValueType x = raw_value(in[i]);
+      m_sum += SumType(x) - SumType(m_history[m_pos]);
+      m_history[m_pos] = x;
+      m_pos = m_pos + 1 < Length ? m_pos + 1 : 0;
+      out[i] = Unit(average());
+    }
+  }
+
+private:
+  ValueType average() const {
+    if (std::is_floating_point<ValueType>::value)
+      return ValueType(m_sum / SumType(Length));
+    const SumType half = SumType(Length / 2);
+    return ValueType((m_sum < 0 ? m_sum - half : m_sum + half) /
+                     SumType(Length));
+  }
+
+  ValueType m_history[Length];
+  SumType m_sum;
+  std::size_t m_pos;
+};
+
+// Filter design
+// Cutoff and sampling rate are frequencies in any scale (Hz, kHz, ...), so an
+// angular frequency in rad/s does not compile. The biquads follow the audio
+// EQ cookbook, the FIR filters are Hamming windowed sinc with unity gain in
+// the pass band.
+
+template <typename V1, typename F1, typename V2, typename F2>
+double normalized_frequency(const si::Frequency<V1, F1> &frequency,
+                            const si::Frequency<V2, F2> &rate) {
+  return double(si::Frequency<double>(frequency) / si::Frequency<double>(rate));
+}
+
+inline Biquad normalized_biquad(double b0, double b1, double b2, double a0,
+                               double a1, double a2) {
+  return Biquad{Coefficient<>(b0 / a0), Coefficient<>(b1 / a0),
+                Coefficient<>(b2 / a0), Coefficient<>(a1 / a0),
+                Coefficient<>(a2 / a0)};
+}
+
+template <typename V1, typename F1, typename V2, typename F2>
+Biquad lowpass(const si::Frequency<V1, F1> &cutoff,
+               const si::Frequency<V2, F2> &rate,
+               const Coefficient<> &q = Coefficient<>(0.70710678118654752)) {
+  const double pi = 3.14159265358979323846;
+  const double w0 = 2 * pi * normalized_frequency(cutoff, rate);
+  const double cosw = std::cos(w0), alpha = std::sin(w0) / (2 * double(q));
+  return normalized_biquad((1 - cosw) / 2, 1 - cosw, (1 - cosw) / 2, 1 + alpha,
+                           -2 * cosw, 1 - alpha);
+}
+
+template <typename V1, typename F1, typename V2, typename F2>
+Biquad highpass(const si::Frequency<V1, F1> &cutoff,
+                const si::Frequency<V2, F2> &rate,
+                const Coefficient<> &q = Coefficient<>(0.70710678118654752)) {
+  const double pi = 3.14159265358979323846;
+  const double w0 = 2 * pi * normalized_frequency(cutoff, rate);
+  const double cosw = std::cos(w0), alpha = std::sin(w0) / (2 * double(q));
+  return normalized_biquad((1 + cosw) / 2, -(1 + cosw), (1 + cosw) / 2,
+                           1 + alpha, -2 * cosw, 1 - alpha);
+}
+
+template <std::size_t Taps, typename V1, typename F1, typename V2, typename F2>
+std::array<Coefficient<>, Taps> fir_lowpass(const si::Frequency<V1, F1> &cutoff,
+                                            const si::Frequency<V2, F2> &rate) {
+  const double pi = 3.14159265358979323846;
+  const double fc = normalized_frequency(cutoff, rate);
+  double taps[Taps], sum = 0;
+  for (std::size_t k = 0; k < Taps; ++k) {
+    const double m = double(k) - double(Taps - 1) / 2;
+    const double sinc = m == 0 ? 2 * fc : std::sin(2 * pi * fc * m) / (pi * m);
+    const double window =
+        Taps > 1 ? 0.54 - 0.46 * std::cos(2 * pi * double(k) / double(Taps - 1))
+                 : 1.;
+    taps[k] = sinc * window;
+    sum += taps[k];
+  }
+  std::array<Coefficient<>, Taps> coefficients;
+  for (std::size_t k = 0; k < Taps; ++k)
+    coefficients[k] = Coefficient<>(taps[k] / sum);
+  return coefficients;
+}
+
+// Spectral inversion of the low pass, so the length must be odd
+template <std::size_t Taps, typename V1, typename F1, typename V2, typename F2>
+std::array<Coefficient<>, Taps>
+fir_highpass(const si::Frequency<V1, F1> &cutoff,
+             const si::Frequency<V2, F2> &rate) {
+  static_assert(Taps % 2 == 1, "High pass FIR needs an odd number of taps");
+  const std::array<Coefficient<>, Taps> low = fir_lowpass<Taps>(cutoff, rate);
+  std::array<Coefficient<>, Taps> coefficients;
+  for (std::size_t k = 0; k < Taps; ++k)
+    coefficients[k] =
+        Coefficient<>((k == Taps / 2 ? 1. : 0.) - double(low[k]));
+  return coefficients;
+}
+
+}; // namespace units
@@ -0,0 +1,373 @@
+/*
+Copyright 2024 Nikola Jelic <nikola.jelic83@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the “Software”), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "phys_units.hpp"
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace units {
+
+// Rounding policies for dropping fractional bits, of a signed wide value
+// RoundDown is an arithmetic shift, towards minus infinity, RoundNearest
+// rounds halves up. Both divide the same way.
+
+struct RoundDown {
+  template <typename W> static constexpr W shift(W value, unsigned bits) {
+    return bits == 0 ? value : W(value >> bits);
+  }
+  template <typename W> static constexpr W divide(W num, W den) {
+    return W(num / den -
+             ((num % den != 0) && ((num < 0) != (den < 0)) ? 1 : 0));
+  }
+};
+
+struct RoundNearest {
+  template <typename W> static constexpr W shift(W value, unsigned bits) {
+    return bits == 0 ? value : W((value + (W(1) << (bits - 1))) >> bits);
+  }
+  template <typename W> static constexpr W divide(W num, W den) {
+    return den < 0 ? divide(W(-num), W(-den))
+                   : RoundDown::divide(W(2 * num + den), W(2 * den));
+  }
+};
+
+// Integer holding a product of two integers without overflow, up to 64 bits
+template <typename I1, typename I2> struct FixedWiden {
+  static const unsigned bytes =
+      sizeof(I1) + sizeof(I2) < 8 ? sizeof(I1) + sizeof(I2) : 8;
+  using Signed = typename std::conditional<
+      (bytes <= 2), std::int16_t,
+      typename std::conditional<(bytes <= 4), std::int32_t,
+                                std::int64_t>::type>::type;
+  using type = typename std::conditional<
+      std::is_signed<I1>::value || std::is_signed<I2>::value, Signed,
+      typename std::make_unsigned<Signed>::type>::type;
+};
+
+// Integer holding the product of two raw values of one format: 64 bits up to
+// 32-bit formats, 128 bits beyond where the compiler has them
+template <typename Int, bool Narrow = (sizeof(Int) <= 4)>
+struct FixedDoubleWidth {
+  using type = std::int64_t;
+};
+
+template <typename Int> struct FixedDoubleWidth<Int, false> {
+#if defined(__SIZEOF_INT128__)
+  __extension__ typedef __int128 Signed;
+  __extension__ typedef unsigned __int128 Unsigned;
+  using type = typename std::conditional<std::is_signed<Int>::value, Signed,
+                                         Unsigned>::type;
+#else
+  static_assert(sizeof(Int) <= 4,
+                "Products of 64-bit formats need a 128-bit integer");
+  using type = std::int64_t;
+#endif
+};
+
+// Fixed point value with FracBits fractional bits in an Int, i.e. the Q
+// format, usable as the holding type of the units, e.g.
+// PhysicalUnit<Fixed<int32_t, 16>, std::milli, std::ratio<1>>
+// Sums keep the finest fraction and the widest range of the operands.
+// Products add the fractional bits and quotients keep those of the dividend,
+// both in the widened integer, so they are exact until they are converted
+// back to a narrower format with the rounding policy. Conversions between
+// unit scales multiply by the ratio in fixed point and shift, without a
+// division, for up to 32-bit integers.
+
+template <typename Int, unsigned FracBits, typename Rounding = RoundNearest>
+class Fixed {
+  static_assert(std::is_integral<Int>::value, "Fixed point needs an integer");
+  static_assert(FracBits <= sizeof(Int) * 8 - std::is_signed<Int>::value,
+                "The fraction must leave room for the sign");
+  using Wide = std::int64_t;
+
+  static constexpr unsigned bit_length(std::uintmax_t value) {
+    return value == 0 ? 0 : 1 + bit_length(value >> 1);
+  }
+
+public:
+  using IntType = Int;
+  using RoundingPolicy = Rounding;
+  static const unsigned Fraction = FracBits;
+
+  constexpr Fixed() : m_raw(0) {}
+  explicit Fixed(Uninitialized) {}
+  template <typename T, typename = typename std::enable_if<
+                            std::is_integral<T>::value>::type>
+  constexpr explicit Fixed(T integer) : m_raw(Int(Wide(integer) * one())) {}
+  constexpr explicit Fixed(double value)
+      : m_raw(Int(value * double(one()) + (value < 0 ? -0.5 : 0.5))) {}
+  template <typename I, unsigned F, typename R>
+  constexpr explicit Fixed(const Fixed<I, F, R> &other)
+      : m_raw(Int(align(Wide(other.raw()), F))) {}
+
+  static constexpr Fixed from_raw(Int raw) { return Fixed(raw, RawTag()); }
+  static constexpr Wide one() { return Wide(1) << FracBits; }
+
+  constexpr Int raw() const { return m_raw; }
+
+  template <typename T>
+  constexpr typename std::enable_if<std::is_floating_point<T>::value, T>::type
+  to() const {
+    return T(m_raw) / T(one());
+  }
+  template <typename T>
+  constexpr typename std::enable_if<std::is_integral<T>::value, T>::type
+  to() const {
+    return T(Rounding::shift(Wide(m_raw), FracBits));
+  }
+  template <typename T, typename = typename std::enable_if<
+                            std::is_arithmetic<T>::value>::type>
+  constexpr explicit operator T() const {
+    return to<T>();
+  }
+
+  Fixed &operator+=(const Fixed &rhs) {
+    m_raw = Int(m_raw + rhs.m_raw);
+    return *this;
+  }
+  Fixed &operator-=(const Fixed &rhs) {
+    m_raw = Int(m_raw - rhs.m_raw);
+    return *this;
+  }
+  Fixed &operator*=(const Fixed &rhs) {
+    using Double = typename FixedDoubleWidth<Int>::type;
+    m_raw = Int(Rounding::shift(Double(m_raw) * Double(rhs.m_raw), FracBits));
+    return *this;
+  }
+  Fixed &operator/=(const Fixed &rhs) {
+    using Double = typename FixedDoubleWidth<Int>::type;
+    m_raw = Int(Rounding::divide(Double(m_raw) * (Double(1) << FracBits),
+                                 Double(rhs.m_raw)));
+    return *this;
+  }
+  Fixed &operator++() {
+    m_raw = Int(m_raw + one());
+    return *this;
+  }
+  Fixed &operator--() {
+    m_raw = Int(m_raw - one());
+    return *this;
+  }
+  constexpr Fixed operator-() const { return from_raw(Int(-m_raw)); }
+
+  // Hook of AbsoluteRescale: value * Ratio + Bias in this format
+  template <typename Ratio, typename Bias> struct Rescale {
+    static constexpr Fixed apply(Fixed value) {
+      return from_raw(Int(scaled(Wide(value.raw())) + BiasRaw));
+    }
+
+  private:
+    // The ratio as a constant in [2^30, 2^31) with Shift fractional bits
+    static constexpr unsigned Shift =
+        Ratio::num >= Ratio::den
+            ? 31 - bit_length(std::uintmax_t(Ratio::num / Ratio::den))
+            : 30 + bit_length(std::uintmax_t((Ratio::den - 1) / Ratio::num));
+    static constexpr bool Shifted =
+        Ratio::den != 1 && sizeof(Int) <= 4 && Shift <= 62;
+    static constexpr Wide Scale =
+        Shifted ? Wide(double(Ratio::num) / double(Ratio::den) *
+                           double(std::uint64_t(1) << Shift) +
+                       0.5)
+                : 0;
+    static constexpr Wide BiasRaw =
+        Bias::num == 0 ? 0
+                       : Wide(double(Bias::num) / double(Bias::den) *
+                                  double(one()) +
+                              (Bias::num < 0 ? -0.5 : 0.5));
+
+    static constexpr Wide scaled(Wide raw) {
+      return Shifted ? Rounding::shift(raw * Scale, Shift)
+                     : raw * Wide(Ratio::num) / Wide(Ratio::den);
+    }
+  };
+
+private:
+  struct RawTag {};
+  constexpr Fixed(Int raw, RawTag) : m_raw(raw) {}
+
+  static constexpr Wide align(Wide raw, unsigned from) {
+    return from > FracBits ? Rounding::shift(raw, from - FracBits)
+                           : raw * (Wide(1) << (FracBits - from));
+  }
+
+  Int m_raw;
+};
+
+// Result types of the mixed format arithmetic
+
+// A sum keeps the finer fraction and the integer range of both operands, in
+// the smallest integer holding them; formats that need more than 64 bits
+// together do not add
+template <typename I1, unsigned F1, typename I2, unsigned F2>
+struct FixedSumInt {
+  static const bool Signed =
+      std::is_signed<I1>::value || std::is_signed<I2>::value;
+  static const unsigned Whole1 = std::numeric_limits<I1>::digits - F1;
+  static const unsigned Whole2 = std::numeric_limits<I2>::digits - F2;
+  static const unsigned bits = (Whole1 > Whole2 ? Whole1 : Whole2) +
+                               (F1 > F2 ? F1 : F2) + (Signed ? 1 : 0);
+  static_assert(bits <= 64, "The sum of these formats needs over 64 bits");
+  using Wide = typename std::conditional<
+      (bits <= 8), std::int8_t,
+      typename std::conditional<
+          (bits <= 16), std::int16_t,
+          typename std::conditional<(bits <= 32), std::int32_t,
+                                    std::int64_t>::type>::type>::type;
+  using type = typename std::conditional<
+      Signed, Wide, typename std::make_unsigned<Wide>::type>::type;
+};
+
+template <typename I1, unsigned F1, typename R1, typename I2, unsigned F2>
+using FixedSum = Fixed<typename FixedSumInt<I1, F1, I2, F2>::type,
+                       (F1 > F2 ? F1 : F2), R1>;
+
+template <typename I1, unsigned F1, typename R1, typename I2, unsigned F2>
+using FixedProduct = Fixed<typename FixedWiden<I1, I2>::type, F1 + F2, R1>;
+
+template <typename I1, unsigned F1, typename R1, typename I2>
+using FixedQuotient = Fixed<typename FixedWiden<I1, I2>::type, F1, R1>;
+
+template <typename I1, unsigned F1, typename R1, typename I2, unsigned F2,
+          typename R2>
+constexpr FixedSum<I1, F1, R1, I2, F2>
+operator+(const Fixed<I1, F1, R1> &lhs, const Fixed<I2, F2, R2> &rhs) {
+  using Sum = FixedSum<I1, F1, R1, I2, F2>;
+  return Sum::from_raw(
+      typename Sum::IntType(Sum(lhs).raw() + Sum(rhs).raw()));
+}
+
+template <typename I1, unsigned F1, typename R1, typename I2, unsigned F2,
+          typename R2>
+constexpr FixedSum<I1, F1, R1, I2, F2>
+operator-(const Fixed<I1, F1, R1> &lhs, const Fixed<I2, F2, R2> &rhs) {
+  using Sum = FixedSum<I1, F1, R1, I2, F2>;
+  return Sum::from_raw(
+      typename Sum::IntType(Sum(lhs).raw() - Sum(rhs).raw()));
+}
+
+template <typename I1, unsigned F1, typename R1, typename I2, unsigned F2,
+          typename R2>
+constexpr FixedProduct<I1, F1, R1, I2, F2>
+operator*(const Fixed<I1, F1, R1> &lhs, const Fixed<I2, F2, R2> &rhs) {
+  using Product = FixedProduct<I1, F1, R1, I2, F2>;
+  using W = typename Product::IntType;
+  return Product::from_raw(W(W(lhs.raw()) * W(rhs.raw())));
+}
+
+template <typename I1, unsigned F1, typename R1, typename I2, unsigned F2,
+          typename R2>
+constexpr FixedQuotient<I1, F1, R1, I2>
+operator/(const Fixed<I1, F1, R1> &lhs, const Fixed<I2, F2, R2> &rhs) {
+  using Quotient = FixedQuotient<I1, F1, R1, I2>;
+  using W = typename Quotient::IntType;
+  return Quotient::from_raw(
+      R1::divide(W(W(lhs.raw()) * (W(1) << F2)), W(rhs.raw())));
+}
+
+// Integer scalars keep the format
+
+template <typename I, unsigned F, typename R, typename T>
+constexpr typename std::enable_if<std::is_integral<T>::value,
+                                  Fixed<I, F, R>>::type
+operator*(const Fixed<I, F, R> &lhs, T rhs) {
+  return Fixed<I, F, R>::from_raw(I(lhs.raw() * rhs));
+}
+
+template <typename T, typename I, unsigned F, typename R>
+constexpr typename std::enable_if<std::is_integral<T>::value,
+                                  Fixed<I, F, R>>::type
+operator*(T lhs, const Fixed<I, F, R> &rhs) {
+  return Fixed<I, F, R>::from_raw(I(lhs * rhs.raw()));
+}
+
+template <typename I, unsigned F, typename R, typename T>
+constexpr typename std::enable_if<std::is_integral<T>::value,
+                                  Fixed<I, F, R>>::type
+operator/(const Fixed<I, F, R> &lhs, T rhs) {
+  return Fixed<I, F, R>::from_raw(
+      I(R::divide(std::int64_t(lhs.raw()), std::int64_t(rhs))));
+}
+
+// Comparisons of any two formats, exact in the finer one
+
+template <unsigned To, typename I, unsigned F, typename R>
+constexpr std::int64_t fixed_aligned(const Fixed<I, F, R> &value) {
+  return std::int64_t(value.raw()) * (std::int64_t(1) << (To - F));
+}
+
+template <typename I1, unsigned F1, typename R1, typename I2, unsigned F2,
+          typename R2>
+constexpr bool operator==(const Fixed<I1, F1, R1> &lhs,
+                          const Fixed<I2, F2, R2> &rhs) {
+  return fixed_aligned<(F1 > F2 ? F1 : F2)>(lhs) ==
+         fixed_aligned<(F1 > F2 ? F1 : F2)>(rhs);
+}
+
+template <typename I1, unsigned F1, typename R1, typename I2, unsigned F2,
+          typename R2>
+constexpr bool operator!=(const Fixed<I1, F1, R1> &lhs,
+                          const Fixed<I2, F2, R2> &rhs) {
+  return fixed_aligned<(F1 > F2 ? F1 : F2)>(lhs) !=
+         fixed_aligned<(F1 > F2 ? F1 : F2)>(rhs);
+}
+
+template <typename I1, unsigned F1, typename R1, typename I2, unsigned F2,
+          typename R2>
+constexpr bool operator<(const Fixed<I1, F1, R1> &lhs,
+                         const Fixed<I2, F2, R2> &rhs) {
+  return fixed_aligned<(F1 > F2 ? F1 : F2)>(lhs) <
+         fixed_aligned<(F1 > F2 ? F1 : F2)>(rhs);
+}
+
+template <typename I1, unsigned F1, typename R1, typename I2, unsigned F2,
+          typename R2>
+constexpr bool operator>(const Fixed<I1, F1, R1> &lhs,
+                         const Fixed<I2, F2, R2> &rhs) {
+  return fixed_aligned<(F1 > F2 ? F1 : F2)>(lhs) >
+         fixed_aligned<(F1 > F2 ? F1 : F2)>(rhs);
+}
+
+template <typename I1, unsigned F1, typename R1, typename I2, unsigned F2,
+          typename R2>
+constexpr bool operator<=(const Fixed<I1, F1, R1> &lhs,
+                          const Fixed<I2, F2, R2> &rhs) {
+  return fixed_aligned<(F1 > F2 ? F1 : F2)>(lhs) <=
+         fixed_aligned<(F1 > F2 ? F1 : F2)>(rhs);
+}
+
+template <typename I1, unsigned F1, typename R1, typename I2, unsigned F2,
+          typename R2>
+constexpr bool operator>=(const Fixed<I1, F1, R1> &lhs,
+                          const Fixed<I2, F2, R2> &rhs) {
+  return fixed_aligned<(F1 > F2 ? F1 : F2)>(lhs) >=
+         fixed_aligned<(F1 > F2 ? F1 : F2)>(rhs);
+}
+
+template <typename I, unsigned F, typename R>
+constexpr Fixed<I, F, R> abs(const Fixed<I, F, R> &value) {
+  return value.raw() < 0 ? -value : value;
+}
+
+}; // namespace units
@@ -0,0 +1,296 @@
+/*
+Copyright 2024 Nikola Jelic <nikola.jelic83@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the “Software”), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "phys_angle.hpp"
+#include "phys_fastmath.hpp"
+#include "phys_si.hpp"
+#include "phys_units.hpp"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace units {
+
+// Units per meter of a length type
+
+template <typename Length> struct LengthMeters {
+  using Factor = typename Length::ConvFactor;
+  static constexpr double per_meter = double(Factor::den) / double(Factor::num);
+};
+
+// Mean earth radius and the WGS84 ellipsoid, in meters
+struct Earth {
+  static constexpr double MeanRadius = 6371008.8;
+  static constexpr double SemiMajorAxis = 6378137.0;
+  static constexpr double Flattening = 1 / 298.257223563;
+};
+
+// Pairs of points, read block by block into radians
+// The math of a block runs over plain arrays, which the compiler vectorizes.
+
+template <typename Lat, typename Lon> struct GeoPairs {
+  enum : std::size_t { Block = 256 };
+
+  const Lat *lat1;
+  const Lon *lon1;
+  const Lat *lat2;
+  const Lon *lon2;
+
+  template <typename Kernel, typename Store>
+  void run(std::size_t first, std::size_t count, Kernel kernel,
+           Store store) const {
+    double p1[Block], l1[Block], p2[Block], l2[Block], result[Block];
+    for (std::size_t done = 0; done < count; done += Block) {
+      const std::size_t n = count - done < Block ? count - done : Block;
+      const std::size_t at = first + done;
+      for (std::size_t i = 0; i < n; ++i) {
+        p1[i] = double(raw_value(lat1[at + i])) * AngleRadians<Lat>::scale;
+        l1[i] = double(raw_value(lon1[at + i])) * AngleRadians<Lon>::scale;
+        p2[i] = double(raw_value(lat2[at + i])) * AngleRadians<Lat>::scale;
+        l2[i] = double(raw_value(lon2[at + i])) * AngleRadians<Lon>::scale;
+      }
+      kernel(p1, l1, p2, l2, n, result);
+      store(at, result, n);
+    }
+  }
+};
+
+// Great circle distance on a sphere, by the haversine formula
+inline void haversine_block(const double *p1, const double *l1,
+                            const double *p2, const double *l2, std::size_t n,
+                            double *out) {
+  for (std::size_t i = 0; i < n; ++i) {
+    double sdp, cdp, sdl, cdl, sp1, cp1, sp2, cp2;
+    FastMath::sincos((p2[i] - p1[i]) * 0.5, sdp, cdp);
+    FastMath::sincos((l2[i] - l1[i]) * 0.5, sdl, cdl);
+    FastMath::sincos(p1[i], sp1, cp1);
+    FastMath::sincos(p2[i], sp2, cp2);
+    double a = sdp * sdp + cp1 * cp2 * sdl * sdl;
+    a = FastMath::select(FastMath::negative(1. - a), 1., a);
+    out[i] = 2 * FastMath::asin_sqrt(a);
+  }
+}
+
+// Initial bearing from the first to the second point, in (-pi, pi]
+inline void bearing_block(const double *p1, const double *l1, const double *p2,
+                          const double *l2, std::size_t n, double *out) {
+  for (std::size_t i = 0; i < n; ++i) {
+    double sdl, cdl, sp1, cp1, sp2, cp2;
+    FastMath::sincos(l2[i] - l1[i], sdl, cdl);
+    FastMath::sincos(p1[i], sp1, cp1);
+    FastMath::sincos(p2[i], sp2, cp2);
+    out[i] = FastMath::atan2(sdl * cp2, cp1 * sp2 - sp1 * cp2 * cdl);
+  }
+}
+
+// Distance on the WGS84 ellipsoid, by Vincenty's inverse formula
+// Accurate to a millimeter; the iteration count depends on the points, so
+// this kernel is not vectorized. Nearly antipodal points, where the method
+// does not converge, return the estimate after 100 iterations.
+inline void vincenty_block(const double *p1, const double *l1,
+                           const double *p2, const double *l2, std::size_t n,
+                           double *out) {
+  const double a = Earth::SemiMajorAxis, f = Earth::Flattening;
+  const double b = a * (1 - f);
+  for (std::size_t i = 0; i < n; ++i) {
+    const double u1 = std::atan((1 - f) * std::tan(p1[i]));
+    const double u2 = std::atan((1 - f) * std::tan(p2[i]));
+    double su1, cu1, su2, cu2;
+    FastMath::sincos(u1, su1, cu1);
+    FastMath::sincos(u2, su2, cu2);
+    const double l = l2[i] - l1[i];
+    double lambda = l, sigma = 0, sinSigma = 0, cosSigma = 1;
+    double cos2Alpha = 1, cos2Sm = 0;
+    for (int iteration = 0; iteration < 100; ++iteration) {
+      double sl, cl;
+      FastMath::sincos(lambda, sl, cl);
+      const double x = cu2 * sl, y = cu1 * su2 - su1 * cu2 * cl;
+      sinSigma = std::sqrt(x * x + y * y);
+      if (sinSigma == 0)
+        break;
+      cosSigma = su1 * su2 + cu1 * cu2 * cl;
+      sigma = std::atan2(sinSigma, cosSigma);
+      const double sinAlpha = cu1 * cu2 * sl / sinSigma;
+      cos2Alpha = 1 - sinAlpha * sinAlpha;
+      cos2Sm = cos2Alpha != 0 ? cosSigma - 2 * su1 * su2 / cos2Alpha : 0;
+      const double c = f / 16 * cos2Alpha * (4 + f * (4 - 3 * cos2Alpha));
+      const double previous = lambda;
+      lambda = l + (1 - c) * f * sinAlpha *
+                       (sigma + c * sinSigma *
+                                    (cos2Sm + c * cosSigma *
+                                                  (-1 + 2 * cos2Sm * cos2Sm)));
+      if (std::fabs(lambda - previous) < 1e-12)
+        break;
+    }
+    const double u = cos2Alpha * (a * a - b * b) / (b * b);
+    const double ka = 1 + u / 16384 * (4096 + u * (-768 + u * (320 - 175 * u)));
+    const double kb = u / 1024 * (256 + u * (-128 + u * (74 - 47 * u)));
+    const double deltaSigma =
+        kb * sinSigma *
+        (cos2Sm + kb / 4 * (cosSigma * (-1 + 2 * cos2Sm * cos2Sm) -
+                            kb / 6 * cos2Sm * (-3 + 4 * sinSigma * sinSigma) *
+                                (-3 + 4 * cos2Sm * cos2Sm)));
+    out[i] = sinSigma == 0 ? 0. : b * ka * (sigma - deltaSigma);
+  }
+}
+
+// Batch kernels over arrays of latitudes and longitudes (AbsoluteAngle of
+// any scale) into lengths or bearings, on the given number of threads
+
+template <typename Lat, typename Lon, typename LengthUnit>
+void haversine_n(const Lat *lat1, const Lon *lon1, const Lat *lat2,
+                 const Lon *lon2, std::size_t count, LengthUnit *out,
+                 unsigned threads = 1,
+                 const si::Meter<> &radius = si::Meter<>(Earth::MeanRadius)) {
+  using OutValue = decltype(raw_value(LengthUnit()));
+  const double scale = radius.value() * LengthMeters<LengthUnit>::per_meter;
+  const GeoPairs<Lat, Lon> pairs{lat1, lon1, lat2, lon2};
+  auto store = [out, scale](std::size_t at, const double *angle,
+                            std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i)
+      out[at + i] = LengthUnit(OutValue(angle[i] * scale));
+  };
+  batch_parallel(count, threads, [&](std::size_t first, std::size_t n) {
+    pairs.run(first, n, haversine_block, store);
+  });
+}
+
+template <typename Lat, typename Lon, typename LengthUnit>
+void vincenty_n(const Lat *lat1, const Lon *lon1, const Lat *lat2,
+                const Lon *lon2, std::size_t count, LengthUnit *out,
+                unsigned threads = 1) {
+  using OutValue = decltype(raw_value(LengthUnit()));
+  const double scale = LengthMeters<LengthUnit>::per_meter;
+  const GeoPairs<Lat, Lon> pairs{lat1, lon1, lat2, lon2};
+  auto store = [out, scale](std::size_t at, const double *meters,
+                            std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i)
+      out[at + i] = LengthUnit(OutValue(meters[i] * scale));
+  };
+  batch_parallel(count, threads, [&](std::size_t first, std::size_t n) {
+    pairs.run(first, n, vincenty_block, store);
+  });
+}
+
+template <typename Lat, typename Lon, typename Bearing>
+void bearing_n(const Lat *lat1, const Lon *lon1, const Lat *lat2,
+               const Lon *lon2, std::size_t count, Bearing *out,
+               unsigned threads = 1) {
+  using OutValue = decltype(raw_value(Bearing()));
+  const double scale = 1 / AngleRadians<Bearing>::scale;
+  const GeoPairs<Lat, Lon> pairs{lat1, lon1, lat2, lon2};
+  auto store = [out, scale](std::size_t at, const double *angle,
+                            std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i)
+      out[at + i] = Bearing(OutValue(angle[i] * scale));
+  };
+  batch_parallel(count, threads, [&](std::size_t first, std::size_t n) {
+    pairs.run(first, n, bearing_block, store);
+  });
+}
+
+// Great circle distance between two points
+
+template <typename Lat, typename Lon>
+si::Meter<>
+haversine(const Lat &lat1, const Lon &lon1, const Lat &lat2, const Lon &lon2,
+          const si::Meter<> &radius = si::Meter<>(Earth::MeanRadius)) {
+  const double p1 = double(raw_value(lat1)) * AngleRadians<Lat>::scale;
+  const double l1 = double(raw_value(lon1)) * AngleRadians<Lon>::scale;
+  const double p2 = double(raw_value(lat2)) * AngleRadians<Lat>::scale;
+  const double l2 = double(raw_value(lon2)) * AngleRadians<Lon>::scale;
+  double angle;
+  haversine_block(&p1, &l1, &p2, &l2, 1, &angle);
+  return angle * radius;
+}
+
+// Point at the given distance and initial bearing, on a sphere
+template <typename Lat, typename Lon, typename Bearing, typename LengthUnit>
+void destination(const Lat &lat, const Lon &lon, const Bearing &bearing,
+                 const LengthUnit &distance, Lat &latOut, Lon &lonOut,
+                 const si::Meter<> &radius = si::Meter<>(Earth::MeanRadius)) {
+  const double p = double(raw_value(lat)) * AngleRadians<Lat>::scale;
+  const double l = double(raw_value(lon)) * AngleRadians<Lon>::scale;
+  const double theta =
+      double(raw_value(bearing)) * AngleRadians<Bearing>::scale;
+  const double delta = double(raw_value(distance)) /
+                       LengthMeters<LengthUnit>::per_meter / radius.value();
+  double sp, cp, sd, cd, st, ct;
+  FastMath::sincos(p, sp, cp);
+  FastMath::sincos(delta, sd, cd);
+  FastMath::sincos(theta, st, ct);
+  const double sp2 = sp * cd + cp * sd * ct;
+  const double p2 = std::asin(sp2);
+  const double l2 = l + FastMath::atan2(st * sd * cp, cd - sp * sp2);
+  latOut = Lat(decltype(raw_value(lat))(p2 / AngleRadians<Lat>::scale));
+  lonOut = Lon(decltype(raw_value(lon))(l2 / AngleRadians<Lon>::scale));
+}
+
+// Latitude and longitude range holding every point within a distance
+// When the circle crosses the antimeridian west is greater than east, and when
+// it holds a pole every longitude is inside.
+
+template <typename Lat, typename Lon> struct GeoBox {
+  Lat south, north;
+  Lon west, east;
+  bool allLongitudes;
+
+  bool contains(const Lat &lat, const Lon &lon) const {
+    if (lat < south || north < lat)
+      return false;
+    if (allLongitudes)
+      return true;
+    return west <= east ? !(lon < west || east < lon)
+                        : !(lon < west) || !(east < lon);
+  }
+};
+
+template <typename Lat, typename Lon, typename LengthUnit>
+GeoBox<Lat, Lon>
+bounding_box(const Lat &lat, const Lon &lon, const LengthUnit &distance,
+             const si::Meter<> &radius = si::Meter<>(Earth::MeanRadius)) {
+  using LatValue = decltype(raw_value(lat));
+  using LonValue = decltype(raw_value(lon));
+  const double p = double(raw_value(lat)) * AngleRadians<Lat>::scale;
+  const double l = double(raw_value(lon)) * AngleRadians<Lon>::scale;
+  const double delta = double(raw_value(distance)) /
+                       LengthMeters<LengthUnit>::per_meter / radius.value();
+  const double half = FastMath::Pi / 2;
+  double south = p - delta, north = p + delta, west = -FastMath::Pi,
+         east = FastMath::Pi;
+  const bool pole = south <= -half || north >= half;
+  south = south > -half ? south : -half;
+  north = north < half ? north : half;
+  if (!pole) {
+    const double spread = std::asin(std::sin(delta) / std::cos(p));
+    west = l - spread;
+    east = l + spread;
+  }
+  return GeoBox<Lat, Lon>{
+      Lat(LatValue(south / AngleRadians<Lat>::scale)),
+      Lat(LatValue(north / AngleRadians<Lat>::scale)),
+      Lon(LonValue(west / AngleRadians<Lon>::scale)),
+      Lon(LonValue(east / AngleRadians<Lon>::scale)), pole};
+}
+
+}; // namespace units
@@ -0,0 +1,347 @@
+/*
+Copyright 2024 Nikola Jelic <nikola.jelic83@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the “Software”), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "phys_metrics.hpp"
+#include "phys_units.hpp"
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace units {
+
+// Binnings of the values of a unit, in its own scale. index() maps a holding
+// value to its bucket without branches, lower() and upper() are the limits of
+// a bucket as doubles of the same scale, equal for the open ended buckets.
+
+// Count equal buckets from low to high, after a bucket for the values below
+// low and before one for the values from high on
+template <typename Unit, std::size_t Count> class LinearBins {
+  using Calc = typename std::conditional<
+      std::is_same<typename Unit::ValueType, float>::value, float,
+      double>::type;
+
+public:
+  using UnitType = Unit;
+  using ValueType = typename Unit::ValueType;
+  static const std::size_t Buckets = Count + 2;
+
+  LinearBins(const Unit &low, const Unit &high)
+      : m_low(Calc(raw_value(low))),
+        m_width((Calc(raw_value(high)) - m_low) / Calc(Count)),
+        m_scale(Calc(1) / m_width) {}
+
+  std::size_t index(ValueType raw) const {
+    Calc at = (Calc(raw) - m_low) * m_scale + Calc(1);
+    at = at > Calc(0) ? at : Calc(0);
+    at = at < Calc(Count + 1) ? at : Calc(Count + 1);
+    return std::size_t(std::int32_t(at));
+  }
+
+  double lower(std::size_t b) const {
+    const std::size_t edge = b == 0 ? 0 : (b > Count ? Count : b - 1);
+    return double(m_low) + double(m_width) * double(edge);
+  }
+
+  double upper(std::size_t b) const {
+    const std::size_t edge = b > Count ? Count : b;
+    return double(m_low) + double(m_width) * double(edge);
+  }
+
+private:
+  Calc m_low;
+  Calc m_width;
+  Calc m_scale;
+};
+
+// Log-linear buckets of integral values, as in HDR histograms: 2^SubBits
+// buckets of one unit, then each power of two split in 2^SubBits buckets, so
+// a bucket is within 2^-SubBits of its values. Negative values go to the
+// first bucket.
+template <typename Unit, unsigned SubBits = 5> class LogLinearBins {
+  static_assert(std::is_integral<typename Unit::ValueType>::value,
+                "Log-linear buckets need an integral holding type");
+  static const unsigned Digits =
+      std::numeric_limits<typename Unit::ValueType>::digits;
+  static_assert(SubBits > 0 && SubBits < Digits, "Sub-buckets out of range");
+  static const std::uint64_t Sub = std::uint64_t(1) << SubBits;
+
+  static unsigned bit_length(std::uint64_t value) {
+#if defined(__GNUC__)
+    return 64 - unsigned(__builtin_clzll(value));
+#else
+    unsigned result = 0;
+    for (; value; value >>= 1)
+      ++result;
+    return result;
+#endif
+  }
+
+public:
+  using UnitType = Unit;
+  using ValueType = typename Unit::ValueType;
+  static const std::size_t Buckets = std::size_t(Digits + 1 - SubBits)
+                                     << SubBits;
+
+  static std::size_t index(ValueType raw) {
+    const std::uint64_t value = raw > 0 ? std::uint64_t(raw) : 0;
+    const unsigned shift = bit_length(value | (2 * Sub - 1)) - SubBits - 1;
+    return std::size_t((value >> shift) + shift * Sub);
+  }
+
+  static double lower(std::size_t b) {
+    const unsigned shift = b < 2 * Sub ? 0 : unsigned(b / Sub - 1);
+    return double((std::uint64_t(b) - shift * Sub) << shift);
+  }
+
+  static double upper(std::size_t b) {
+    const unsigned shift = b < 2 * Sub ? 0 : unsigned(b / Sub - 1);
+    return lower(b) + double(std::uint64_t(1) << shift);
+  }
+};
+
+// Buckets between the given ascending edges, after a bucket for the values
+// below the first edge; the last bucket holds the values from the last on
+template <typename Unit, std::size_t Edges> class EdgeBins {
+  static_assert(Edges > 0, "At least one edge is needed");
+
+public:
+  using UnitType = Unit;
+  using ValueType = typename Unit::ValueType;
+  static const std::size_t Buckets = Edges + 1;
+
+  explicit EdgeBins(const Unit (&edges)[Edges]) {
+    for (std::size_t e = 0; e < Edges; ++e)
+      m_edges[e] = raw_value(edges[e]);
+  }
+
+  // Number of edges up to the value, by a binary search without branches
+  std::size_t index(ValueType raw) const {
+    const ValueType *base = m_edges;
+    for (std::size_t n = Edges; n > 1; n -= n / 2)
+      base = base[n / 2] <= raw ? base + n / 2 : base;
+    return std::size_t(base - m_edges) + (*base <= raw ? 1 : 0);
+  }
+
+  double lower(std::size_t b) const {
+    return double(m_edges[b == 0 ? 0 : b - 1]);
+  }
+
+  double upper(std::size_t b) const {
+    return double(m_edges[b < Edges ? b : Edges - 1]);
+  }
+
+private:
+  ValueType m_edges[Edges];
+};
+
+template <typename Bins, int Slots> class ThreadHistograms;
+
+// Counts of the values per bucket of the binning. The values inserted may be
+// in any scale of the dimension, converted to the scale of the bins by the
+// factors folded at compile time. Histograms of separate threads merge.
+// Batches count in four lanes, so runs of values in one bucket do not wait
+// on each other's increments.
+
+template <typename Bins> class Histogram {
+public:
+  using UnitType = typename Bins::UnitType;
+  using ValueType = typename Bins::ValueType;
+  static const std::size_t Buckets = Bins::Buckets;
+  static const std::size_t Block = 256;
+
+  explicit Histogram(const Bins &bins = Bins()) : m_bins(bins) { reset(); }
+
+  template <typename U> void insert(const U &value) {
+    static_assert(SameDimension<U, UnitType>::value &&
+                      std::is_constructible<UnitType, U>::value,
+                  "Inserted values must have the dimension of the bins");
+    ++m_counts[0][m_bins.index(raw_value(UnitType(value)))];
+    ++m_count;
+  }
+
+  // The bucket indices of a block are computed first, in a loop the compiler
+  // vectorizes where the binning allows, then counted
+  template <typename U> void insert_n(const U *values, std::size_t count) {
+    static_assert(SameDimension<U, UnitType>::value &&
+                      std::is_constructible<UnitType, U>::value,
+                  "Inserted values must have the dimension of the bins");
+    std::uint32_t index[Block];
+    for (std::size_t done = 0; done < count; done += Block) {
+      const std::size_t n = count - done < Block ? count - done : Block;
+      const U *in = values + done;
+      for (std::size_t i = 0; i < n; ++i)
+        index[i] = std::uint32_t(m_bins.index(raw_value(UnitType(in[i]))));
+      std::size_t i = 0;
+      for (; i + Lanes <= n; i += Lanes)
+        for (std::size_t l = 0; l < Lanes; ++l)
+          ++m_counts[l][index[i + l]];
+      for (; i < n; ++i)
+        ++m_counts[0][index[i]];
+    }
+    m_count += count;
+  }
+
+  void merge(const Histogram &other) {
+    for (std::size_t l = 0; l < Lanes; ++l)
+      for (std::size_t b = 0; b < Buckets; ++b)
+        m_counts[l][b] += other.m_counts[l][b];
+    m_count += other.m_count;
+  }
+
+  void reset() {
+    for (std::size_t l = 0; l < Lanes; ++l)
+      for (std::size_t b = 0; b < Buckets; ++b)
+        m_counts[l][b] = 0;
+    m_count = 0;
+  }
+
+  const Bins &bins() const { return m_bins; }
+  std::uint64_t count() const { return m_count; }
+  std::uint64_t bucket_count(std::size_t b) const {
+    std::uint64_t count = 0;
+    for (std::size_t l = 0; l < Lanes; ++l)
+      count += m_counts[l][b];
+    return count;
+  }
+  UnitType lower(std::size_t b) const { return make(m_bins.lower(b)); }
+  UnitType upper(std::size_t b) const { return make(m_bins.upper(b)); }
+
+  // Value below which the given fraction of the values lie, interpolated
+  // within its bucket; integral values stay below the upper limit
+  UnitType percentile(double fraction) const {
+    if (m_count == 0)
+      return UnitType(ValueType(0));
+    std::uint64_t rank = std::uint64_t(std::ceil(fraction * double(m_count)));
+    rank = rank == 0 ? 1 : (rank > m_count ? m_count : rank);
+    std::uint64_t seen = 0;
+    std::size_t b = 0;
+    while (seen + bucket_count(b) < rank)
+      seen += bucket_count(b++);
+    const double lower = m_bins.lower(b), upper = m_bins.upper(b);
+    double at = lower + (upper - lower) * double(rank - seen) /
+                            double(bucket_count(b));
+    if (std::is_integral<ValueType>::value && upper > lower)
+      at = std::floor(at) < upper ? std::floor(at) : upper - 1;
+    return make(at);
+  }
+
+private:
+  template <typename B, int Slots> friend class ThreadHistograms;
+
+  static UnitType make(double raw) {
+    return UnitType(ValueType(std::is_integral<ValueType>::value
+                                  ? std::floor(raw + 0.5)
+                                  : raw));
+  }
+
+  static const std::size_t Lanes = 4;
+
+  Bins m_bins;
+  std::uint64_t m_counts[Lanes][Buckets];
+  std::uint64_t m_count;
+};
+
+// Histogram shards of the threads, merged on demand. Every thread counts in a
+// shard of its own with a plain load and store; the threads past the shard
+// count share the last shard, as the metrics do.
+
+template <typename Bins, int Slots = 64> class ThreadHistograms {
+  using Shards = MetricShards<Slots>;
+  using Cell = MetricCell<std::uint64_t>;
+  static const std::size_t Buckets = Bins::Buckets;
+  // Shards a cache line apart, rounded to whole lines
+  static const std::size_t Stride = ((Buckets + 7) / 8 + 1) * 8;
+
+public:
+  using UnitType = typename Bins::UnitType;
+  static const std::size_t Block = Histogram<Bins>::Block;
+
+  explicit ThreadHistograms(const Bins &bins = Bins())
+      : m_bins(bins), m_counts(Stride * Slots) {
+    reset();
+  }
+  ThreadHistograms(const ThreadHistograms &) = delete;
+  ThreadHistograms &operator=(const ThreadHistograms &) = delete;
+
+  template <typename U> void insert(const U &value) {
+    static_assert(SameDimension<U, UnitType>::value &&
+                      std::is_constructible<UnitType, U>::value,
+                  "Inserted values must have the dimension of the bins");
+    const int slot = Shards::slot();
+    const std::size_t b = m_bins.index(raw_value(UnitType(value)));
+    std::atomic<std::uint64_t> &cell = m_counts[std::size_t(slot) * Stride + b];
+    if (slot != Shards::Shared)
+      Cell::add_owned(cell, 1);
+    else
+      Cell::add_shared(cell, 1);
+  }
+
+  template <typename U> void insert_n(const U *values, std::size_t count) {
+    static_assert(SameDimension<U, UnitType>::value &&
+                      std::is_constructible<UnitType, U>::value,
+                  "Inserted values must have the dimension of the bins");
+    const int slot = Shards::slot();
+    std::atomic<std::uint64_t> *shard = &m_counts[std::size_t(slot) * Stride];
+    std::uint32_t index[Block];
+    for (std::size_t done = 0; done < count; done += Block) {
+      const std::size_t n = count - done < Block ? count - done : Block;
+      const U *in = values + done;
+      for (std::size_t i = 0; i < n; ++i)
+        index[i] = std::uint32_t(m_bins.index(raw_value(UnitType(in[i]))));
+      if (slot != Shards::Shared)
+        for (std::size_t i = 0; i < n; ++i)
+          Cell::add_owned(shard[index[i]], 1);
+      else
+        for (std::size_t i = 0; i < n; ++i)
+          Cell::add_shared(shard[index[i]], 1);
+    }
+  }
+
+  Histogram<Bins> snapshot() const {
+    Histogram<Bins> result(m_bins);
+    for (int s = 0; s < Slots; ++s) {
+      const std::atomic<std::uint64_t> *shard =
+          &m_counts[std::size_t(s) * Stride];
+      for (std::size_t b = 0; b < Buckets; ++b)
+        result.m_counts[0][b] += shard[b].load(std::memory_order_relaxed);
+    }
+    for (std::size_t b = 0; b < Buckets; ++b)
+      result.m_count += result.m_counts[0][b];
+    return result;
+  }
+
+  void reset() {
+    for (std::size_t c = 0; c < m_counts.size(); ++c)
+      m_counts[c].store(0, std::memory_order_relaxed);
+  }
+
+private:
+  Bins m_bins;
+  std::vector<std::atomic<std::uint64_t>> m_counts;
+};
+
+}; // namespace units
@@ -0,0 +1,124 @@
+/*
+Copyright 2024 Nikola Jelic <nikola.jelic83@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the “Software”), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "phys_units.hpp"
+#include <cassert>
+#include <cstddef>
+
+namespace units {
+
+// Piecewise-linear table from InUnit to OutUnit, clamped at both ends
+// Breakpoints, values and segment slopes are kept in separate arrays. Equally
+// spaced breakpoints are detected when the table is built and are then looked
+// up with a single multiplication, other tables use a branchless binary
+// search. The breakpoints must be strictly ascending, which debug builds
+// assert.
+
+template <typename InUnit, typename OutUnit, std::size_t Size>
+class LookupTable {
+  static_assert(Size >= 2, "Lookup table needs at least two breakpoints");
+
+public:
+  using InValue = decltype(raw_value(InUnit()));
+  using OutValue = decltype(raw_value(OutUnit()));
+  using CalcType =
+      typename ResultingType<decltype(InValue() * OutValue())>::type;
+
+  constexpr LookupTable(const InUnit (&inputs)[Size],
+                        const OutUnit (&outputs)[Size])
+      : m_in{}, m_out{}, m_slope{}, m_step(0), m_invStep(0), m_uniform(true) {
+    for (std::size_t i = 0; i < Size; ++i) {
+      m_in[i] = raw_value(inputs[i]);
+      m_out[i] = raw_value(outputs[i]);
+    }
+    m_step = (CalcType(m_in[Size - 1]) - CalcType(m_in[0])) / (Size - 1);
+    for (std::size_t i = 0; i + 1 < Size; ++i) {
+      assert(m_in[i] < m_in[i + 1] && "Breakpoints must be ascending");
+      const CalcType width = CalcType(m_in[i + 1]) - CalcType(m_in[i]);
+      m_slope[i] = (CalcType(m_out[i + 1]) - CalcType(m_out[i])) / width;
+      const CalcType error = width > m_step ? width - m_step : m_step - width;
+      m_uniform = m_uniform && error <= m_step * CalcType(1e-9);
+    }
+    m_invStep = CalcType(1) / m_step;
+  }
+
+  constexpr bool uniform() const { return m_uniform; }
+  constexpr InUnit input(std::size_t i) const { return InUnit(m_in[i]); }
+  constexpr OutUnit output(std::size_t i) const { return OutUnit(m_out[i]); }
+
+  OutUnit lookup(const InUnit &in) const {
+    return OutUnit(OutValue(interpolate(CalcType(raw_value(in)))));
+  }
+
+  // Any other scale of the input dimension, converted by the constant factor
+  template <typename OtherIn> OutUnit lookup(const OtherIn &in) const {
+    return lookup(InUnit(in));
+  }
+
+  void lookup_n(const InUnit *in, std::size_t count, OutUnit *out) const {
+    for (std::size_t i = 0; i < count; ++i)
+      out[i] = OutUnit(OutValue(interpolate(CalcType(raw_value(in[i])))));
+  }
+
+  // The same table with breakpoints and values converted to other scales
+  template <typename OtherIn, typename OtherOut>
+  LookupTable<OtherIn, OtherOut, Size> as() const {
+    OtherIn inputs[Size];
+    OtherOut outputs[Size];
+    for (std::size_t i = 0; i < Size; ++i) {
+      inputs[i] = OtherIn(input(i));
+      outputs[i] = OtherOut(output(i));
+    }
+    return LookupTable<OtherIn, OtherOut, Size>(inputs, outputs);
+  }
+
+private:
+  std::size_t segment(CalcType x) const {
+    if (m_uniform) {
+      const CalcType pos = (x - CalcType(m_in[0])) * m_invStep;
+      const std::size_t idx = std::size_t(pos);
+      return idx < Size - 2 ? idx : Size - 2;
+    }
+    std::size_t base = 0;
+    for (std::size_t len = Size; len > 1; len -= len / 2)
+      base = CalcType(m_in[base + len / 2]) <= x ? base + len / 2 : base;
+    return base < Size - 2 ? base : Size - 2;
+  }
+
+  CalcType interpolate(CalcType x) const {
+    const CalcType low = CalcType(m_in[0]);
+    const CalcType high = CalcType(m_in[Size - 1]);
+    x = x < low ? low : (x > high ? high : x);
+    const std::size_t idx = segment(x);
+    return CalcType(m_out[idx]) + m_slope[idx] * (x - CalcType(m_in[idx]));
+  }
+
+  InValue m_in[Size];
+  OutValue m_out[Size];
+  CalcType m_slope[Size - 1];
+  CalcType m_step;
+  CalcType m_invStep;
+  bool m_uniform;
+};
+
+}; // namespace units
@@ -0,0 +1,361 @@
+/*
+Copyright 2024 Nikola Jelic <nikola.jelic83@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the “Software”), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "phys_string.hpp"
+#include "phys_timing.hpp"
+#include "phys_units.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ratio>
+#include <type_traits>
+#include <vector>
+
+namespace units {
+
+// SI value and symbol of a metric unit, with the factor and the offset folded
+// at compile time, e.g. 2.5 MilliSecond exports as 2.5e-3 s and TempCelsius
+// as Kelvin. Integral values without a scale export exactly.
+
+template <typename V, typename Factor, typename Offset, typename... Dims>
+struct MetricScale {
+  using ValueType = V;
+  using Rescale =
+      AbsoluteRescale<Factor, Offset, std::ratio<1>, std::ratio<0>>;
+  static const bool Exact = std::is_integral<V>::value &&
+                            std::ratio_equal<Factor, std::ratio<1>>::value &&
+                            Offset::num == 0;
+
+  static double si(V value) {
+    return Rescale::template apply<double>(double(value));
+  }
+
+  static void append(FormatBuffer &out, V value) {
+    if (Exact)
+      out.append_value(value);
+    else
+      out.append_scientific(si(value));
+  }
+
+  // The unit symbol after a space, nothing for dimensionless units
+  static void symbol(FormatBuffer &out) {
+    char text[64];
+    FormatBuffer symbol(text, sizeof(text));
+    DimFormat<0, Dims...>::append(symbol, false);
+    if (symbol.size() > 0) {
+      out.append(' ');
+      out.append(text);
+    }
+  }
+
+  static void line(FormatBuffer &out, const char *name, const char *suffix,
+                   V value) {
+    out.append(name);
+    out.append(suffix);
+    out.append(' ');
+    append(out, value);
+    symbol(out);
+    out.append('\n');
+  }
+};
+
+template <typename Unit> struct MetricUnit {};
+
+template <typename V, typename Factor, typename... Dims>
+struct MetricUnit<PhysicalUnit<V, Factor, Dims...>>
+    : MetricScale<V, Factor, std::ratio<0>, Dims...> {
+  static V raw(const PhysicalUnit<V, Factor, Dims...> &value) {
+    return value.value();
+  }
+};
+
+// Dimensionless units, e.g. counts of requests, only convert to their value
+template <typename V, typename Factor>
+struct MetricUnit<PhysicalUnit<V, Factor, std::ratio<0>, std::ratio<0>,
+                               std::ratio<0>, std::ratio<0>, std::ratio<0>,
+                               std::ratio<0>, std::ratio<0>, std::ratio<0>>>
+    : MetricScale<V, std::ratio<1>, std::ratio<0>> {
+  static_assert(std::ratio_equal<Factor, std::ratio<1>>::value,
+                "Dimensionless metrics count in ones");
+  static V raw(const PhysicalUnit<V, Factor> &value) { return V(value); }
+};
+
+template <typename V, typename Factor, typename DV, typename Offset,
+          typename... Dims>
+struct MetricUnit<AbsolutePhysicalUnit<V, Factor, DV, Offset, Dims...>>
+    : MetricScale<V, Factor, Offset, Dims...> {
+  static V
+  raw(const AbsolutePhysicalUnit<V, Factor, DV, Offset, Dims...> &value) {
+    return value.value();
+  }
+};
+
+// Shard updates by their only writer, a relaxed load and store without a
+// locked instruction. Threads past the shard count share the last shard,
+// updated with atomic read-modify-writes.
+
+template <typename V> struct MetricCell {
+  static void add_owned(std::atomic<V> &cell, V amount) {
+    cell.store(V(cell.load(std::memory_order_relaxed) + amount),
+               std::memory_order_relaxed);
+  }
+
+  static void add_shared(std::atomic<V> &cell, V amount) {
+    V seen = cell.load(std::memory_order_relaxed);
+    while (!cell.compare_exchange_weak(seen, V(seen + amount),
+                                       std::memory_order_relaxed)) {
+    }
+  }
+};
+
+template <int Slots> struct MetricShards {
+  static_assert(Slots > 1, "One shard is kept for the overflow threads");
+  static const int Shared = Slots - 1;
+
+  static int slot() {
+    const unsigned slot = thread_slot();
+    return slot < unsigned(Shared) ? int(slot) : Shared;
+  }
+};
+
+// Sum of the amounts added by all threads, e.g. bytes sent or energy used
+
+template <typename Unit, int Slots = 64> class Counter {
+  using Metric = MetricUnit<Unit>;
+
+public:
+  using ValueType = typename Metric::ValueType;
+
+  Counter() { reset(); }
+  Counter(const Counter &) = delete;
+  Counter &operator=(const Counter &) = delete;
+
+  void add(const Unit &amount) {
+    const int slot = MetricShards<Slots>::slot();
+    if (slot != MetricShards<Slots>::Shared)
+      MetricCell<ValueType>::add_owned(m_shards[slot].sum, Metric::raw(amount));
+    else
+      MetricCell<ValueType>::add_shared(m_shards[slot].sum,
+                                        Metric::raw(amount));
+  }
+
+  Unit value() const {
+    ValueType sum = 0;
+    for (int s = 0; s < Slots; ++s)
+      sum += m_shards[s].sum.load(std::memory_order_relaxed);
+    return Unit(sum);
+  }
+
+  void reset() {
+    for (int s = 0; s < Slots; ++s)
+      m_shards[s].sum.store(0, std::memory_order_relaxed);
+  }
+
+  void write(const char *name, FormatBuffer &out) const {
+    Metric::line(out, name, "", Metric::raw(value()));
+  }
+
+private:
+  struct alignas(64) Shard {
+    std::atomic<ValueType> sum;
+  };
+
+  Shard m_shards[Slots];
+};
+
+// Last value set by any thread, e.g. a temperature or a queue length, on a
+// cache line of its own
+
+template <typename Unit> class Gauge {
+  using Metric = MetricUnit<Unit>;
+  using DiffType = typename DiffUnitType<Unit>::type;
+
+public:
+  using ValueType = typename Metric::ValueType;
+
+  Gauge() : m_value(0) {}
+  Gauge(const Gauge &) = delete;
+  Gauge &operator=(const Gauge &) = delete;
+
+  void set(const Unit &value) {
+    m_value.store(Metric::raw(value), std::memory_order_relaxed);
+  }
+
+  // A difference of the unit in any scale, converted at compile time
+  template <typename Diff,
+            typename = typename std::enable_if<
+                std::is_constructible<DiffType, Diff>::value &&
+                !std::is_arithmetic<Diff>::value>::type>
+  void add(const Diff &amount) {
+    MetricCell<ValueType>::add_shared(m_value,
+                                      ValueType(DiffType(amount).value()));
+  }
+
+  Unit value() const { return Unit(m_value.load(std::memory_order_relaxed)); }
+
+  void write(const char *name, FormatBuffer &out) const {
+    Metric::line(out, name, "", Metric::raw(value()));
+  }
+
+private:
+  alignas(64) std::atomic<ValueType> m_value;
+};
+
+// Counts of the recorded values per bucket, with the given ascending upper
+// bounds and a last bucket for the values above them, and their sum
+
+template <typename Unit, std::size_t Bounds, int Slots = 64>
+class MetricHistogram {
+  using Metric = MetricUnit<Unit>;
+
+public:
+  using ValueType = typename Metric::ValueType;
+  static const std::size_t Buckets = Bounds + 1;
+
+  explicit MetricHistogram(const Unit (&bounds)[Bounds]) {
+    for (std::size_t b = 0; b < Bounds; ++b)
+      m_bounds[b] = Metric::raw(bounds[b]);
+    reset();
+  }
+  MetricHistogram(const MetricHistogram &) = delete;
+  MetricHistogram &operator=(const MetricHistogram &) = delete;
+
+  std::size_t bucket(const Unit &value) const {
+    const ValueType raw = Metric::raw(value);
+    std::size_t b = 0;
+    for (std::size_t i = 0; i < Bounds; ++i)
+      b += raw > m_bounds[i] ? 1 : 0;
+    return b;
+  }
+
+  void record(const Unit &value) {
+    const int slot = MetricShards<Slots>::slot();
+    Shard &shard = m_shards[slot];
+    const std::size_t b = bucket(value);
+    if (slot != MetricShards<Slots>::Shared) {
+      MetricCell<std::uint64_t>::add_owned(shard.buckets[b], 1);
+      MetricCell<ValueType>::add_owned(shard.sum, Metric::raw(value));
+    } else {
+      MetricCell<std::uint64_t>::add_shared(shard.buckets[b], 1);
+      MetricCell<ValueType>::add_shared(shard.sum, Metric::raw(value));
+    }
+  }
+
+  std::uint64_t bucket_count(std::size_t b) const {
+    std::uint64_t count = 0;
+    for (int s = 0; s < Slots; ++s)
+      count += m_shards[s].buckets[b].load(std::memory_order_relaxed);
+    return count;
+  }
+
+  std::uint64_t count() const {
+    std::uint64_t count = 0;
+    for (std::size_t b = 0; b < Buckets; ++b)
+      count += bucket_count(b);
+    return count;
+  }
+
+  Unit sum() const {
+    ValueType sum = 0;
+    for (int s = 0; s < Slots; ++s)
+      sum += m_shards[s].sum.load(std::memory_order_relaxed);
+    return Unit(sum);
+  }
+
+  Unit bound(std::size_t b) const { return Unit(m_bounds[b]); }
+
+  void reset() {
+    for (int s = 0; s < Slots; ++s) {
+      for (std::size_t b = 0; b < Buckets; ++b)
+        m_shards[s].buckets[b].store(0, std::memory_order_relaxed);
+      m_shards[s].sum.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  // Cumulative buckets, each counting the values up to its bound
+  void write(const char *name, FormatBuffer &out) const {
+    std::uint64_t cumulative = 0;
+    for (std::size_t b = 0; b < Buckets; ++b) {
+      cumulative += bucket_count(b);
+      out.append(name);
+      out.append("_bucket{le=\"");
+      if (b < Bounds)
+        Metric::append(out, m_bounds[b]);
+      else
+        out.append("+Inf");
+      out.append("\"} ");
+      out.append_unsigned(cumulative);
+      out.append('\n');
+    }
+    out.append(name);
+    out.append("_count ");
+    out.append_unsigned(cumulative);
+    out.append('\n');
+    Metric::line(out, name, "_sum", Metric::raw(sum()));
+  }
+
+private:
+  struct alignas(64) Shard {
+    std::atomic<std::uint64_t> buckets[Buckets];
+    std::atomic<ValueType> sum;
+  };
+
+  ValueType m_bounds[Bounds];
+  Shard m_shards[Slots];
+};
+
+// Named metrics owned by the caller, exported together as text lines of the
+// metric name, its value in SI units and the SI unit symbol
+
+class MetricsRegistry {
+public:
+  template <typename Metric> void add(const char *name, const Metric &metric) {
+    m_entries.push_back(Entry{name, &metric, &write<Metric>});
+  }
+
+  std::size_t size() const { return m_entries.size(); }
+
+  // Returns the length of the text, which is cut to the buffer
+  std::size_t export_text(char *buffer, std::size_t size) const {
+    FormatBuffer out(buffer, size);
+    for (const Entry &entry : m_entries)
+      entry.write(entry.metric, entry.name, out);
+    return out.size();
+  }
+
+private:
+  struct Entry {
+    const char *name;
+    const void *metric;
+    void (*write)(const void *, const char *, FormatBuffer &);
+  };
+
+  template <typename Metric>
+  static void write(const void *metric, const char *name, FormatBuffer &out) {
+    static_cast<const Metric *>(metric)->write(name, out);
+  }
+
+  std::vector<Entry> m_entries;
+};
+
+}; // namespace units
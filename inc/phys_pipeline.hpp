@@ -0,0 +1,479 @@
+/*
+Copyright 2024 Nikola Jelic <nikola.jelic83@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the “Software”), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "phys_metrics.hpp"
+#include "phys_record.hpp"
+#include "phys_timing.hpp"
+#include "phys_units.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace units {
+
+// A pipeline stage declares the units it takes and gives, and processes a
+// batch at a time:
+//   using Input = ...; using Output = ...;
+//   std::size_t process(const Input *in, std::size_t count, Output *out);
+// returning the number of outputs written, at most count. A stage keeps its
+// state between batches, e.g. a filter or an aggregate.
+
+template <typename In, typename Out, typename Fn> struct MapStage {
+  using Input = In;
+  using Output = Out;
+
+  std::size_t process(const In *in, std::size_t count, Out *out) {
+    for (std::size_t i = 0; i < count; ++i)
+      out[i] = fn(in[i]);
+    return count;
+  }
+
+  Fn fn;
+};
+
+// Stage applying fn to every value, e.g. a calibration
+template <typename In, typename Out, typename Fn>
+MapStage<In, Out, Fn> map_stage(Fn fn) {
+  return MapStage<In, Out, Fn>{fn};
+}
+
+// Bounded single-producer/single-consumer queue of batches, written and read
+// in place. Both ends may move between threads, as long as every hand-over
+// synchronizes, e.g. through the claim of the pipeline task.
+
+template <typename T, std::size_t Batch, std::size_t Depth> class BatchQueue {
+  static_assert(Depth >= 2 && (Depth & (Depth - 1)) == 0,
+                "Depth must be a power of two");
+
+public:
+  struct Slot {
+    std::size_t count;
+    T values[Batch];
+  };
+
+  BatchQueue() : m_tail(0), m_head(0) {}
+  BatchQueue(const BatchQueue &) = delete;
+  BatchQueue &operator=(const BatchQueue &) = delete;
+
+  static constexpr std::size_t depth() { return Depth; }
+
+  // Producer side, nullptr while the queue is full
+  Slot *write_slot() {
+    const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_head.load(std::memory_order_acquire) == Depth)
+      return nullptr;
+    return &m_slots[tail & Mask];
+  }
+
+  void commit_write() {
+    m_tail.store(m_tail.load(std::memory_order_relaxed) + 1,
+                 std::memory_order_release);
+  }
+
+  // Consumer side, nullptr while the queue is empty
+  const Slot *read_slot() const {
+    const std::size_t head = m_head.load(std::memory_order_relaxed);
+    if (m_tail.load(std::memory_order_acquire) == head)
+      return nullptr;
+    return &m_slots[head & Mask];
+  }
+
+  void commit_read() {
+    m_head.store(m_head.load(std::memory_order_relaxed) + 1,
+                 std::memory_order_release);
+  }
+
+  // Approximate when called concurrently with the producer or the consumer
+  std::size_t size() const {
+    return m_tail.load(std::memory_order_acquire) -
+           m_head.load(std::memory_order_acquire);
+  }
+  bool empty() const { return size() == 0; }
+
+private:
+  static const std::size_t Mask = Depth - 1;
+
+  alignas(64) std::atomic<std::size_t> m_tail;
+  alignas(64) std::atomic<std::size_t> m_head;
+  alignas(64) Slot m_slots[Depth];
+};
+
+// Input of a stage from the batch of the previous one: the same unit is read
+// in place, another scale of the same dimension is converted a batch at a
+// time, and any other unit does not compile.
+
+template <typename Queued, typename Input, std::size_t Batch>
+struct StageInput {
+  static_assert(SameDimension<Queued, Input>::value &&
+                    std::is_constructible<Input, Queued>::value,
+                "Connected stages must have the same dimension");
+
+  const Input *take(const Queued *in, std::size_t count) {
+    unit_cast_n(in, count, converted);
+    return converted;
+  }
+
+  Input converted[Batch];
+};
+
+template <typename Input, std::size_t Batch>
+struct StageInput<Input, Input, Batch> {
+  const Input *take(const Input *in, std::size_t) { return in; }
+};
+
+// Whether every stage takes the output of the one before it: units of the
+// same dimension, never a raw number or a dimensionless unit in place of one
+template <typename... Stages> struct StagesConnect : std::true_type {};
+
+template <typename First, typename Second, typename... Rest>
+struct StagesConnect<First, Second, Rest...>
+    : std::integral_constant<
+          bool, SameDimension<typename First::Output,
+                              typename Second::Input>::value &&
+                    std::is_constructible<typename Second::Input,
+                                          typename First::Output>::value &&
+                    StagesConnect<Second, Rest...>::value> {};
+
+using PipelineCount = PhysicalUnit<std::uint64_t>;
+
+// Values processed, batches processed and the latency of every batch
+struct StageMetrics {
+  Counter<PipelineCount> values;
+  Counter<PipelineCount> batches;
+  ThreadLatencyHistograms<> latency;
+};
+
+// Chain of stages run in lanes, each lane a copy of the stages with bounded
+// batch queues between them. The values pushed into a lane come out of it in
+// order, and a full queue holds back the stage before it, up to push_n.
+// Every stage of every lane is a task run by one worker at a time; a worker
+// starts from tasks of its own and steals the others while they have work,
+// and sleeps after a number of rounds without any until a push, a pop or
+// stop() wakes it.
+// The lanes and the stage metrics are allocated at once from an arena, on
+// cache lines of their own.
+
+template <std::size_t Batch, std::size_t Depth, typename... Stages>
+class Pipeline {
+  static const std::size_t StageCount = sizeof...(Stages);
+  static_assert(StageCount > 0, "A pipeline needs a stage");
+  static_assert(StagesConnect<Stages...>::value,
+                "Connected stages must have the same dimension");
+
+  template <std::size_t I>
+  using Stage = typename std::tuple_element<I, std::tuple<Stages...>>::type;
+
+  // Queue I feeds stage I, the last one holds the outputs
+  template <std::size_t I, bool First = I == 0> struct QueueValue {
+    using type = typename Stage<0>::Input;
+  };
+  template <std::size_t I> struct QueueValue<I, false> {
+    using type = typename Stage<I - 1>::Output;
+  };
+  template <std::size_t I>
+  using Queue = BatchQueue<typename QueueValue<I>::type, Batch, Depth>;
+
+  template <typename Indices> struct LaneTypes {};
+  template <std::size_t... I> struct LaneTypes<std::index_sequence<I...>> {
+    using Queues = std::tuple<Queue<I>..., Queue<StageCount>>;
+    using Inputs = std::tuple<StageInput<typename QueueValue<I>::type,
+                                         typename Stage<I>::Input, Batch>...>;
+  };
+  using Indices = std::index_sequence_for<Stages...>;
+
+  struct Lane {
+    explicit Lane(const std::tuple<Stages...> &prototypes)
+        : stages(prototypes), taken(0) {
+      for (std::size_t s = 0; s < StageCount; ++s)
+        busy[s].store(false, std::memory_order_relaxed);
+    }
+
+    std::tuple<Stages...> stages;
+    typename LaneTypes<Indices>::Queues queues;
+    typename LaneTypes<Indices>::Inputs inputs;
+    std::atomic<bool> busy[StageCount];
+    std::size_t taken; // outputs popped from the front batch
+  };
+
+public:
+  using Input = typename Stage<0>::Input;
+  using Output = typename Stage<StageCount - 1>::Output;
+
+  // valid() is false if the lanes could not be allocated
+  explicit Pipeline(unsigned lanes, const Stages &...stages)
+      : m_arena(arena_bytes(lanes ? lanes : 1)), m_lanes(nullptr),
+        m_laneCount(0), m_metrics(nullptr), m_stop(false), m_sleepers(0),
+        m_wakes(0) {
+    const std::tuple<Stages...> prototypes(stages...);
+    m_metrics = m_arena.allocate_array<StageMetrics>(StageCount);
+    m_lanes = m_arena.allocate_array<Lane>(lanes ? lanes : 1);
+    if (!valid())
+      return;
+    for (std::size_t s = 0; s < StageCount; ++s)
+      new (m_metrics + s) StageMetrics();
+    for (m_laneCount = 0; m_laneCount < (lanes ? lanes : 1); ++m_laneCount)
+      new (m_lanes + m_laneCount) Lane(prototypes);
+  }
+  Pipeline(const Pipeline &) = delete;
+  Pipeline &operator=(const Pipeline &) = delete;
+  ~Pipeline() {
+    stop();
+    for (std::size_t l = 0; l < m_laneCount; ++l)
+      m_lanes[l].~Lane();
+    if (valid())
+      for (std::size_t s = 0; s < StageCount; ++s)
+        m_metrics[s].~StageMetrics();
+  }
+
+  bool valid() const { return m_lanes != nullptr && m_metrics != nullptr; }
+  std::size_t lanes() const { return m_laneCount; }
+  static constexpr std::size_t stages() { return StageCount; }
+
+  // Runs the tasks on the given number of worker threads until stop()
+  void start(unsigned threads) {
+    stop();
+    m_stop.store(false, std::memory_order_relaxed);
+    const std::size_t tasks = m_laneCount * StageCount;
+    for (unsigned w = 0; w < threads; ++w)
+      m_workers.emplace_back([this, w, threads, tasks]() {
+        const std::size_t home = tasks * w / threads;
+        for (int idle = 0;;) {
+          if (round(home)) {
+            idle = 0;
+            continue;
+          }
+          if (m_stop.load(std::memory_order_acquire))
+            return;
+          if (++idle < SpinRounds)
+            std::this_thread::yield();
+          else
+            park(home);
+        }
+      });
+  }
+
+  // Lets the workers finish the batches that can move, then joins them
+  void stop() {
+    m_stop.store(true, std::memory_order_release);
+    {
+      std::lock_guard<std::mutex> lock(m_parking);
+      m_wakes.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_wake.notify_all();
+    for (std::thread &worker : m_workers)
+      worker.join();
+    m_workers.clear();
+  }
+
+  // Runs one pass over the tasks on the calling thread, without workers;
+  // returns whether any batch moved
+  bool poll() { return round(0); }
+
+  // Producer side of a lane, one thread at a time; returns the number of
+  // values taken, less than count while the lane is full
+  std::size_t push_n(std::size_t lane, const Input *in, std::size_t count) {
+    Queue<0> &queue = std::get<0>(m_lanes[lane].queues);
+    std::size_t pushed = 0;
+    while (pushed < count) {
+      typename Queue<0>::Slot *slot = queue.write_slot();
+      if (slot == nullptr)
+        break;
+      const std::size_t n = count - pushed < Batch ? count - pushed : Batch;
+      for (std::size_t i = 0; i < n; ++i)
+        slot->values[i] = in[pushed + i];
+      slot->count = n;
+      queue.commit_write();
+      pushed += n;
+    }
+    if (pushed > 0)
+      wake();
+    return pushed;
+  }
+
+  // Consumer side of a lane, one thread at a time; returns the number of
+  // outputs popped
+  std::size_t pop_n(std::size_t lane, Output *out, std::size_t max) {
+    Lane &from = m_lanes[lane];
+    Queue<StageCount> &queue = std::get<StageCount>(from.queues);
+    std::size_t popped = 0;
+    bool freed = false;
+    while (popped < max) {
+      const typename Queue<StageCount>::Slot *slot = queue.read_slot();
+      if (slot == nullptr)
+        break;
+      const std::size_t left = slot->count - from.taken;
+      const std::size_t n = max - popped < left ? max - popped : left;
+      for (std::size_t i = 0; i < n; ++i)
+        out[popped + i] = slot->values[from.taken + i];
+      popped += n;
+      from.taken += n;
+      if (from.taken == slot->count) {
+        from.taken = 0;
+        queue.commit_read();
+        freed = true;
+      }
+    }
+    if (freed)
+      wake();
+    return popped;
+  }
+
+  // Whether no batch waits between the stages or on the way in
+  bool idle() const {
+    for (std::size_t l = 0; l < m_laneCount; ++l)
+      if (!inner_empty(m_lanes[l], Indices()))
+        return false;
+    return true;
+  }
+
+  const StageMetrics &metrics(std::size_t stage) const {
+    return m_metrics[stage];
+  }
+
+private:
+  using Step = bool (*)(Pipeline &, Lane &);
+
+  template <std::size_t I> static bool step(Pipeline &pipeline, Lane &lane) {
+    Queue<I> &in = std::get<I>(lane.queues);
+    Queue<I + 1> &out = std::get<I + 1>(lane.queues);
+    const typename Queue<I>::Slot *batch = in.read_slot();
+    if (batch == nullptr)
+      return false;
+    typename Queue<I + 1>::Slot *target = out.write_slot();
+    if (target == nullptr)
+      return false;
+    StageMetrics &metrics = pipeline.m_metrics[I];
+    {
+      ScopedTimer<ThreadLatencyHistograms<>> timer(metrics.latency);
+      const typename Stage<I>::Input *values =
+          std::get<I>(lane.inputs).take(batch->values, batch->count);
+      target->count = std::get<I>(lane.stages).process(values, batch->count,
+                                                       target->values);
+    }
+    metrics.values.add(PipelineCount(batch->count));
+    metrics.batches.add(PipelineCount(1));
+    in.commit_read();
+    if (target->count > 0)
+      out.commit_write();
+    return true;
+  }
+
+  template <std::size_t... I>
+  static const Step *steps(std::index_sequence<I...>) {
+    static const Step table[] = {&Pipeline::step<I>...};
+    return table;
+  }
+
+  template <std::size_t... I>
+  static bool inner_empty(const Lane &lane, std::index_sequence<I...>) {
+    const bool empty[] = {std::get<I>(lane.queues).empty()...};
+    for (bool queue : empty)
+      if (!queue)
+        return false;
+    return true;
+  }
+
+  // One pass over the tasks from the given one, a few batches per claim
+  bool round(std::size_t home) {
+    const Step *table = steps(Indices());
+    const std::size_t tasks = m_laneCount * StageCount;
+    bool moved = false;
+    for (std::size_t t = 0; t < tasks; ++t) {
+      const std::size_t task = (home + t) % tasks;
+      Lane &lane = m_lanes[task / StageCount];
+      std::atomic<bool> &busy = lane.busy[task % StageCount];
+      if (busy.load(std::memory_order_relaxed) ||
+          busy.exchange(true, std::memory_order_acquire))
+        continue;
+      for (int b = 0; b < ClaimBatches && table[task % StageCount](*this, lane);
+           ++b)
+        moved = true;
+      busy.store(false, std::memory_order_release);
+    }
+    return moved;
+  }
+
+  // Sleeps until a wake after the last look at the queues. The fences order
+  // the count of sleepers against the queue indices: either the last round
+  // sees the batch of a push or pop, or that push or pop sees the sleeper.
+  void park(std::size_t home) {
+    const unsigned wakes = m_wakes.load(std::memory_order_relaxed);
+    m_sleepers.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!round(home) && !m_stop.load(std::memory_order_acquire)) {
+      std::unique_lock<std::mutex> lock(m_parking);
+      while (m_wakes.load(std::memory_order_relaxed) == wakes)
+        m_wake.wait(lock);
+    }
+    m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  void wake() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleepers.load(std::memory_order_relaxed) == 0)
+      return;
+    {
+      std::lock_guard<std::mutex> lock(m_parking);
+      m_wakes.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_wake.notify_all();
+  }
+
+  static std::size_t arena_bytes(std::size_t lanes) {
+    return sizeof(Lane) * lanes + alignof(Lane) +
+           sizeof(StageMetrics) * StageCount + alignof(StageMetrics);
+  }
+
+  static const int ClaimBatches = 8;
+  static const int SpinRounds = 64;
+
+  MonotonicArena m_arena;
+  Lane *m_lanes;
+  std::size_t m_laneCount;
+  StageMetrics *m_metrics;
+  std::vector<std::thread> m_workers;
+  std::atomic<bool> m_stop;
+  std::atomic<unsigned> m_sleepers;
+  std::atomic<unsigned> m_wakes;
+  std::mutex m_parking;
+  std::condition_variable m_wake;
+};
+
+// Pipeline of the given stages, deducing their types
+template <std::size_t Batch, std::size_t Depth, typename... Stages>
+std::unique_ptr<Pipeline<Batch, Depth, Stages...>>
+make_pipeline(unsigned lanes, const Stages &...stages) {
+  return std::unique_ptr<Pipeline<Batch, Depth, Stages...>>(
+      new Pipeline<Batch, Depth, Stages...>(lanes, stages...));
+}
+
+}; // namespace units
@@ -0,0 +1,346 @@
+/*
+Copyright 2024 Nikola Jelic <nikola.jelic83@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the “Software”), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "phys_angle.hpp"
+#include "phys_circular.hpp"
+#include "phys_fastmath.hpp"
+#include "phys_units.hpp"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace units {
+
+// Counter-based generator, Philox4x32-10 (Salmon et al., SC'11)
+// A block of four 32-bit words is a pure function of the seed, the stream
+// and the block index, so any range of samples can be drawn on any thread
+// and the results do not depend on how the work is split. A draw number
+// gives the samples that need more words, e.g. by rejection, blocks of
+// their own.
+
+class Philox {
+public:
+  enum : std::size_t { Block = 256 };
+
+  constexpr explicit Philox(std::uint64_t seed, std::uint32_t stream = 0)
+      : m_key0(std::uint32_t(seed)), m_key1(std::uint32_t(seed >> 32)),
+        m_stream(stream) {}
+
+  std::uint32_t stream() const { return m_stream; }
+
+  // Words of count blocks from first, one array per word
+  void blocks(std::uint64_t first, std::uint32_t draw, std::size_t count,
+              std::uint32_t *w0, std::uint32_t *w1, std::uint32_t *w2,
+              std::uint32_t *w3) const {
+    for (std::size_t i = 0; i < count; ++i) {
+      std::uint32_t c0 = std::uint32_t(first + i);
+      std::uint32_t c1 = std::uint32_t((first + i) >> 32);
+      std::uint32_t c2 = draw, c3 = m_stream;
+      std::uint32_t k0 = m_key0, k1 = m_key1;
+      for (int round = 0; round < 10; ++round) {
+        const std::uint64_t p0 = std::uint64_t(0xD2511F53u) * c0;
+        const std::uint64_t p1 = std::uint64_t(0xCD9E8D57u) * c2;
+        c0 = std::uint32_t(p1 >> 32) ^ c1 ^ k0;
+        c2 = std::uint32_t(p0 >> 32) ^ c3 ^ k1;
+        c1 = std::uint32_t(p1);
+        c3 = std::uint32_t(p0);
+        k0 += 0x9E3779B9u;
+        k1 += 0xBB67AE85u;
+      }
+      w0[i] = c0;
+      w1[i] = c1;
+      w2[i] = c2;
+      w3[i] = c3;
+    }
+  }
+
+  // Two uniforms in [0, 1) with 52 bits per block, up to Block blocks,
+  // made by filling the mantissa of a double in [1, 2)
+  void uniforms(std::uint64_t first, std::size_t count, double *u,
+                double *v) const {
+    std::uint32_t w0[Block], w1[Block], w2[Block], w3[Block];
+    blocks(first, 0, count, w0, w1, w2, w3);
+    for (std::size_t i = 0; i < count; ++i) {
+      u[i] = unit(w0[i], w1[i]);
+      v[i] = unit(w2[i], w3[i]);
+    }
+  }
+
+  static double unit(std::uint32_t hi, std::uint32_t lo) {
+    return FastMath::from_bits(0x3ff0000000000000ull |
+                              (((std::uint64_t(hi) << 32) | lo) >> 12)) -
+           1;
+  }
+
+private:
+  std::uint32_t m_key0;
+  std::uint32_t m_key1;
+  std::uint32_t m_stream;
+};
+
+// Holding value of a sample, for integral units rounded to the nearest, or
+// down for the uniform draws so the samples stay within [low, high)
+template <typename Unit> struct RandomValue {
+  using ValueType = decltype(raw_value(Unit()));
+
+  static Unit nearest(double x) { return make(std::floor(x + 0.5), x); }
+  static Unit down(double x) { return make(std::floor(x), x); }
+
+private:
+  static Unit make(double integral, double x) {
+    return Unit(std::is_integral<ValueType>::value ? ValueType(integral)
+                                                   : ValueType(x));
+  }
+};
+
+// Angles below zero go up a turn before they are stored, as unsigned ones
+// cannot hold them
+template <typename V, typename F, bool H>
+struct RandomValue<AbsoluteAngle<V, F, H>> {
+  using Angle = AbsoluteAngle<V, F, H>;
+  using Wrap = CircleWrap<V>;
+  using Wide = typename Wrap::Wide;
+
+  static Angle nearest(double x) { return make(std::floor(x + 0.5), x); }
+  static Angle down(double x) { return make(std::floor(x), x); }
+
+private:
+  static Angle make(double integral, double x) {
+    return Angle(V(Wrap::store(Wide(std::is_integral<V>::value ? integral : x),
+                               Wide(Circle<Angle>::full()))));
+  }
+};
+
+// Distributions over unit types: the parameters may be given in any scale
+// of the dimension and are converted once, so the samples are drawn
+// directly in the scale of Unit. generate() writes the samples first to
+// first + count of a generator.
+
+template <typename Unit> class UniformDistribution {
+public:
+  // Values in [low, high)
+  template <typename P>
+  UniformDistribution(const P &low, const P &high)
+      : m_low(double(raw_value(Unit(low)))),
+        m_span(double(raw_value(Unit(high))) - m_low) {}
+
+  void generate(const Philox &rng, std::uint64_t first, std::size_t count,
+                Unit *out) const {
+    double u[Philox::Block], v[Philox::Block], x[Philox::Block];
+    for (std::size_t done = 0; done < count; done += Philox::Block) {
+      const std::size_t n = count - done < Philox::Block
+                                ? count - done
+                                : std::size_t(Philox::Block);
+      rng.uniforms(first + done, n, u, v);
+      for (std::size_t i = 0; i < n; ++i)
+        x[i] = m_low + u[i] * m_span;
+      for (std::size_t i = 0; i < n; ++i)
+        out[done + i] = RandomValue<Unit>::down(x[i]);
+    }
+  }
+
+private:
+  double m_low;
+  double m_span;
+};
+
+// Uniform headings over the whole turn, or over the arc from an angle
+template <typename V, typename F, bool H>
+class UniformDistribution<AbsoluteAngle<V, F, H>> {
+  using Angle = AbsoluteAngle<V, F, H>;
+
+public:
+  UniformDistribution()
+      : m_low(H ? -double(Circle<Angle>::full()) / 2 : 0.),
+        m_span(double(Circle<Angle>::full())) {}
+  template <typename P, typename A>
+  UniformDistribution(const P &from, const A &arc)
+      : m_low(double(Angle(from).value())),
+        m_span(double(PhysicalUnitAngle<V, F>(arc).value())) {}
+
+  void generate(const Philox &rng, std::uint64_t first, std::size_t count,
+                Angle *out) const {
+    double u[Philox::Block], v[Philox::Block], x[Philox::Block];
+    for (std::size_t done = 0; done < count; done += Philox::Block) {
+      const std::size_t n = count - done < Philox::Block
+                                ? count - done
+                                : std::size_t(Philox::Block);
+      rng.uniforms(first + done, n, u, v);
+      for (std::size_t i = 0; i < n; ++i)
+        x[i] = m_low + u[i] * m_span;
+      for (std::size_t i = 0; i < n; ++i)
+        out[done + i] = RandomValue<Angle>::down(x[i]);
+    }
+  }
+
+private:
+  double m_low;
+  double m_span;
+};
+
+// Normal noise around a mean, e.g. on TempKelvin, with the spread in the
+// difference unit, by the Box-Muller transform
+template <typename Unit> class NormalDistribution {
+public:
+  template <typename M, typename S>
+  NormalDistribution(const M &mean, const S &stddev)
+      : m_mean(double(raw_value(Unit(mean)))),
+        m_stddev(double(raw_value(typename DiffUnitType<Unit>::type(stddev)))) {
+  }
+
+  void generate(const Philox &rng, std::uint64_t first, std::size_t count,
+                Unit *out) const {
+    double u[Philox::Block], v[Philox::Block], x[Philox::Block];
+    for (std::size_t done = 0; done < count; done += Philox::Block) {
+      const std::size_t n = count - done < Philox::Block
+                                ? count - done
+                                : std::size_t(Philox::Block);
+      rng.uniforms(first + done, n, u, v);
+      for (std::size_t i = 0; i < n; ++i) {
+        const double r = FastMath::sqrt(-2 * FastMath::log(1 - u[i]));
+        double s, c;
+        FastMath::sincos(2 * FastMath::Pi * v[i], s, c);
+        x[i] = m_mean + m_stddev * r * c;
+      }
+      for (std::size_t i = 0; i < n; ++i)
+        out[done + i] = RandomValue<Unit>::nearest(x[i]);
+    }
+  }
+
+private:
+  double m_mean;
+  double m_stddev;
+};
+
+// Exponential waiting times with the given mean, e.g. request arrivals
+template <typename Unit> class ExponentialDistribution {
+public:
+  template <typename M>
+  explicit ExponentialDistribution(const M &mean)
+      : m_mean(double(raw_value(Unit(mean)))) {}
+
+  void generate(const Philox &rng, std::uint64_t first, std::size_t count,
+                Unit *out) const {
+    double u[Philox::Block], v[Philox::Block], x[Philox::Block];
+    for (std::size_t done = 0; done < count; done += Philox::Block) {
+      const std::size_t n = count - done < Philox::Block
+                                ? count - done
+                                : std::size_t(Philox::Block);
+      rng.uniforms(first + done, n, u, v);
+      for (std::size_t i = 0; i < n; ++i)
+        x[i] = -m_mean * FastMath::log(1 - u[i]);
+      for (std::size_t i = 0; i < n; ++i)
+        out[done + i] = RandomValue<Unit>::nearest(x[i]);
+    }
+  }
+
+private:
+  double m_mean;
+};
+
+// Angles around a mean direction with the concentration kappa, uniform for
+// kappa 0, by the rejection method of Best and Fisher. Every attempt of a
+// sample takes a block of its own, so the samples stay reproducible.
+template <typename Angle> class VonMisesDistribution {
+public:
+  template <typename P>
+  VonMisesDistribution(const P &mean, double kappa)
+      : m_mean(double(Angle(mean).value()) * AngleRadians<Angle>::scale),
+        m_kappa(kappa) {
+    const double tau = 1 + std::sqrt(1 + 4 * kappa * kappa);
+    const double rho = (tau - std::sqrt(2 * tau)) / (2 * kappa);
+    m_r = (1 + rho * rho) / (2 * rho);
+  }
+
+  void generate(const Philox &rng, std::uint64_t first, std::size_t count,
+                Angle *out) const {
+    for (std::size_t i = 0; i < count; ++i)
+      out[i] = RandomValue<Angle>::nearest(sample(rng, first + i) /
+                                        AngleRadians<Angle>::scale);
+  }
+
+private:
+  double sample(const Philox &rng, std::uint64_t index) const {
+    std::uint32_t w[4];
+    if (m_kappa < 1e-9) {
+      rng.blocks(index, 0, 1, w, w + 1, w + 2, w + 3);
+      return m_mean + (2 * Philox::unit(w[0], w[1]) - 1) * FastMath::Pi;
+    }
+    for (std::uint32_t draw = 0;; ++draw) {
+      rng.blocks(index, draw, 1, w, w + 1, w + 2, w + 3);
+      const double u1 = w[0] * (1. / 4294967296.);
+      const double u2 = (w[1] + 1.) * (1. / 4294967296.);
+      const double z = std::cos(FastMath::Pi * u1);
+      const double f = (1 + m_r * z) / (m_r + z);
+      const double c = m_kappa * (m_r - f);
+      if (c * (2 - c) - u2 > 0 || std::log(c / u2) + 1 - c >= 0)
+        return m_mean + (w[2] & 1 ? 1 : -1) * std::acos(f);
+    }
+  }
+
+  double m_mean;
+  double m_kappa;
+  double m_r;
+};
+
+// Samples first to first + count of a distribution, split between threads;
+// the output is the same for any number of threads
+template <typename Distribution, typename Unit>
+void draw_n(const Distribution &distribution, const Philox &rng,
+            std::uint64_t first, std::size_t count, Unit *out,
+            unsigned threads = 1) {
+  batch_parallel(count, threads, [&](std::size_t at, std::size_t n) {
+    distribution.generate(rng, first + at, n, out + at);
+  });
+}
+
+// Sequential draws from one stream, e.g. per thread or per simulated entity
+class RandomStream {
+public:
+  constexpr explicit RandomStream(std::uint64_t seed, std::uint32_t stream = 0)
+      : m_rng(seed, stream), m_position(0) {}
+
+  const Philox &generator() const { return m_rng; }
+  std::uint64_t position() const { return m_position; }
+  void seek(std::uint64_t position) { m_position = position; }
+
+  template <typename Distribution, typename Unit>
+  void draw(const Distribution &distribution, Unit *out, std::size_t count) {
+    distribution.generate(m_rng, m_position, count, out);
+    m_position += count;
+  }
+
+  template <typename Unit, typename Distribution>
+  Unit draw(const Distribution &distribution) {
+    Unit sample;
+    draw(distribution, &sample, 1);
+    return sample;
+  }
+
+private:
+  Philox m_rng;
+  std::uint64_t m_position;
+};
+
+}; // namespace units
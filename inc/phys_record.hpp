@@ -0,0 +1,269 @@
+/*
+Copyright 2024 Nikola Jelic <nikola.jelic83@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the “Software”), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "phys_units.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace units {
+
+// Monotonic arena: allocations bump a pointer and are never freed one by one
+// The memory is either a caller provided buffer, which never allocates, or
+// heap blocks of a given size, chained as needed. release() rewinds to the
+// start in constant time and keeps the blocks for reuse, the destructor
+// frees them.
+
+class MonotonicArena {
+public:
+  MonotonicArena(void *buffer, std::size_t bytes)
+      : m_first(nullptr), m_current(nullptr), m_blockBytes(0),
+        m_buffer(static_cast<unsigned char *>(buffer)), m_bufferBytes(bytes) {
+    release();
+  }
+
+  explicit MonotonicArena(std::size_t blockBytes = 64 * 1024)
+      : m_first(nullptr), m_current(nullptr), m_blockBytes(blockBytes),
+        m_buffer(nullptr), m_bufferBytes(0) {
+    release();
+  }
+
+  MonotonicArena(const MonotonicArena &) = delete;
+  MonotonicArena &operator=(const MonotonicArena &) = delete;
+
+  ~MonotonicArena() {
+    while (m_first) {
+      Block *next = m_first->next;
+      std::free(m_first);
+      m_first = next;
+    }
+  }
+
+  // Returns nullptr when a fixed buffer is exhausted or the heap fails
+  void *allocate(std::size_t bytes, std::size_t align) {
+    for (;;) {
+      const std::uintptr_t aligned =
+          (std::uintptr_t(m_next) + align - 1) & ~std::uintptr_t(align - 1);
+      if (m_next && aligned + bytes <= std::uintptr_t(m_end)) {
+        m_next = reinterpret_cast<unsigned char *>(aligned + bytes);
+        return reinterpret_cast<void *>(aligned);
+      }
+      if (!next_block(bytes + align))
+        return nullptr;
+    }
+  }
+
+  template <typename T> T *allocate_array(std::size_t count) {
+    return static_cast<T *>(allocate(sizeof(T) * count, alignof(T)));
+  }
+
+  // Units left unset, to be written before they are read. The arena never
+  // runs destructors, so the units must not need them.
+  template <typename Unit> Unit *allocate_uninitialized(std::size_t count) {
+    static_assert(std::is_trivially_destructible<Unit>::value,
+                  "Arena units are never destroyed");
+    Unit *units = allocate_array<Unit>(count);
+    if (units)
+      for (std::size_t i = 0; i < count; ++i)
+        ::new (static_cast<void *>(units + i)) Unit(Uninitialized());
+    return units;
+  }
+
+  void release() {
+    m_current = nullptr;
+    m_next = m_buffer;
+    m_end = m_buffer + m_bufferBytes;
+  }
+
+private:
+  struct Block {
+    Block *next;
+    std::size_t bytes;
+    unsigned char *begin() {
+      return reinterpret_cast<unsigned char *>(this + 1);
+    }
+  };
+
+  // Moves to the next chained block, allocating it if needed
+  bool next_block(std::size_t bytes) {
+    if (m_blockBytes == 0)
+      return false;
+    Block *block = m_current ? m_current->next : m_first;
+    if (!block || block->bytes < bytes) {
+      const std::size_t size = bytes > m_blockBytes ? bytes : m_blockBytes;
+      Block *fresh = static_cast<Block *>(std::malloc(sizeof(Block) + size));
+      if (!fresh)
+        return false;
+      fresh->bytes = size;
+      fresh->next = block;
+      (m_current ? m_current->next : m_first) = fresh;
+      block = fresh;
+    }
+    m_current = block;
+    m_next = block->begin();
+    m_end = block->begin() + block->bytes;
+    return true;
+  }
+
+  Block *m_first;
+  Block *m_current;
+  std::size_t m_blockBytes;
+  unsigned char *m_buffer;
+  std::size_t m_bufferBytes;
+  unsigned char *m_next;
+  unsigned char *m_end;
+};
+
+// Columnar batch of records with a compile-time schema of unit types
+// Each column is one array of holding values allocated from an arena, so
+// appending rows does not allocate, columns can be handed to the bulk
+// kernels as they are, and the memory of all the batches of an arena is
+// released at once by MonotonicArena::release(). A slice shares the columns
+// of its batch; it is full, so rows cannot be appended to it.
+
+template <typename... Columns> class RecordBatch {
+public:
+  enum : std::size_t { ColumnCount = sizeof...(Columns) };
+  template <std::size_t I>
+  using Column = typename std::tuple_element<I, std::tuple<Columns...>>::type;
+  template <std::size_t I>
+  using ColumnValue = decltype(raw_value(Column<I>()));
+
+  // Read-only view of one row
+  class Row {
+  public:
+    template <std::size_t I> Column<I> get() const {
+      return m_batch->template get<I>(m_row);
+    }
+
+  private:
+    friend class RecordBatch;
+    Row(const RecordBatch *batch, std::size_t row)
+        : m_batch(batch), m_row(row) {}
+
+    const RecordBatch *m_batch;
+    std::size_t m_row;
+  };
+
+  // valid() is false if the arena could not provide the columns
+  RecordBatch(MonotonicArena &arena, std::size_t capacity)
+      : m_columns(arena.allocate_array<decltype(raw_value(Columns()))>(
+            capacity)...),
+        m_size(0), m_capacity(capacity) {
+    if (!valid())
+      m_capacity = 0;
+  }
+
+  bool valid() const { return all_allocated(Indices()); }
+  std::size_t size() const { return m_size; }
+  std::size_t capacity() const { return m_capacity; }
+  bool full() const { return m_size == m_capacity; }
+
+  // Drops the rows and keeps the columns
+  void clear() { m_size = 0; }
+
+  bool append(const Columns &...values) {
+    if (full())
+      return false;
+    store(Indices(), values...);
+    ++m_size;
+    return true;
+  }
+
+  // Writes values of one column after the last row; the rows are added by
+  // commit() once every column is written. Returns the number written.
+  template <std::size_t I>
+  std::size_t append_column(const Column<I> *values, std::size_t count) {
+    const std::size_t room = m_capacity - m_size;
+    count = count < room ? count : room;
+    ColumnValue<I> *out = column<I>() + m_size;
+    for (std::size_t i = 0; i < count; ++i)
+      out[i] = raw_value(values[i]);
+    return count;
+  }
+
+  std::size_t commit(std::size_t count) {
+    const std::size_t room = m_capacity - m_size;
+    count = count < room ? count : room;
+    m_size += count;
+    return count;
+  }
+
+  template <std::size_t I> ColumnValue<I> *column() {
+    return std::get<I>(m_columns);
+  }
+
+  template <std::size_t I> const ColumnValue<I> *column() const {
+    return std::get<I>(m_columns);
+  }
+
+  template <std::size_t I> Column<I> get(std::size_t row) const {
+    return Column<I>(std::get<I>(m_columns)[row]);
+  }
+
+  Row row(std::size_t row) const { return Row(this, row); }
+
+  RecordBatch slice(std::size_t offset, std::size_t count) const {
+    offset = offset < m_size ? offset : m_size;
+    count = count < m_size - offset ? count : m_size - offset;
+    return RecordBatch(shift(Indices(), offset), count);
+  }
+
+private:
+  using Indices = std::index_sequence_for<Columns...>;
+  using Pointers = std::tuple<decltype(raw_value(Columns())) *...>;
+
+  RecordBatch(const Pointers &columns, std::size_t count)
+      : m_columns(columns), m_size(count), m_capacity(count) {}
+
+  template <std::size_t... I>
+  bool all_allocated(std::index_sequence<I...>) const {
+    const bool allocated[] = {true, std::get<I>(m_columns) != nullptr...};
+    for (bool column : allocated)
+      if (!column)
+        return false;
+    return true;
+  }
+
+  template <std::size_t... I>
+  void store(std::index_sequence<I...>, const Columns &...values) {
+    const int expand[] = {
+        0, (std::get<I>(m_columns)[m_size] = raw_value(values), 0)...};
+    (void)expand;
+  }
+
+  template <std::size_t... I>
+  Pointers shift(std::index_sequence<I...>, std::size_t offset) const {
+    return Pointers(std::get<I>(m_columns) + offset...);
+  }
+
+  Pointers m_columns;
+  std::size_t m_size;
+  std::size_t m_capacity;
+};
+
+}; // namespace units
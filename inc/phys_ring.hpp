@@ -0,0 +1,208 @@
+/*
+Copyright 2024 Nikola Jelic <nikola.jelic83@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the “Software”), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "phys_units.hpp"
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace units {
+
+// A unit value with its timestamp, e.g. TimedSample<TimeStamp, Pascal>
+// Converts to a TimedSample of other scales, field by field.
+
+template <typename Time, typename Unit> struct TimedSample {
+  using TimeType = Time;
+  using ValueType = Unit;
+
+  TimedSample() = default;
+  constexpr TimedSample(const Time &t, const Unit &v) : time(t), value(v) {}
+  template <typename T, typename U>
+  constexpr explicit TimedSample(const TimedSample<T, U> &other)
+      : time(other.time), value(other.value) {}
+
+  Time time;
+  Unit value;
+};
+
+// Fixed-capacity single-producer/single-consumer ring
+// The producer and the consumer indices live on separate cache lines, and
+// each side caches the index of the other, so the shared lines are only read
+// when the ring looks full or empty. pop_n converts into any type
+// constructible from the sample, e.g. another scale of the same unit.
+
+template <typename Sample, std::size_t Capacity> class SpscRing {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of two");
+  static_assert(std::is_trivially_copyable<Sample>::value,
+                "Samples must be trivially copyable");
+
+public:
+  SpscRing() : m_tail(0), m_cachedHead(0), m_head(0), m_cachedTail(0) {}
+  SpscRing(const SpscRing &) = delete;
+  SpscRing &operator=(const SpscRing &) = delete;
+
+  static constexpr std::size_t capacity() { return Capacity; }
+
+  // Producer side, returns the number of samples pushed
+  std::size_t push_n(const Sample *in, std::size_t count) {
+    const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (Capacity - (tail - m_cachedHead) < count)
+      m_cachedHead = m_head.load(std::memory_order_acquire);
+    const std::size_t space = Capacity - (tail - m_cachedHead);
+    const std::size_t n = count < space ? count : space;
+    const std::size_t start = tail & Mask;
+    const std::size_t first = n < Capacity - start ? n : Capacity - start;
+    for (std::size_t i = 0; i < first; ++i)
+      m_buffer[start + i] = in[i];
+    for (std::size_t i = first; i < n; ++i)
+      m_buffer[i - first] = in[i];
+    m_tail.store(tail + n, std::memory_order_release);
+    return n;
+  }
+
+  bool push(const Sample &sample) { return push_n(&sample, 1) == 1; }
+
+  // Consumer side, returns the number of samples popped
+  template <typename Out> std::size_t pop_n(Out *out, std::size_t max) {
+    const std::size_t head = m_head.load(std::memory_order_relaxed);
+    if (m_cachedTail - head < max)
+      m_cachedTail = m_tail.load(std::memory_order_acquire);
+    const std::size_t ready = m_cachedTail - head;
+    const std::size_t n = max < ready ? max : ready;
+    const std::size_t start = head & Mask;
+    const std::size_t first = n < Capacity - start ? n : Capacity - start;
+    for (std::size_t i = 0; i < first; ++i)
+      out[i] = Out(m_buffer[start + i]);
+    for (std::size_t i = first; i < n; ++i)
+      out[i] = Out(m_buffer[i - first]);
+    m_head.store(head + n, std::memory_order_release);
+    return n;
+  }
+
+  template <typename Out> bool pop(Out &sample) {
+    return pop_n(&sample, 1) == 1;
+  }
+
+  // Approximate when called concurrently with the producer or the consumer
+  std::size_t size() const {
+    return m_tail.load(std::memory_order_acquire) -
+           m_head.load(std::memory_order_acquire);
+  }
+  bool empty() const { return size() == 0; }
+
+private:
+  static const std::size_t Mask = Capacity - 1;
+
+  alignas(64) std::atomic<std::size_t> m_tail;
+  std::size_t m_cachedHead;
+  alignas(64) std::atomic<std::size_t> m_head;
+  std::size_t m_cachedTail;
+  alignas(64) Sample m_buffer[Capacity];
+};
+
+// Fixed-capacity multi-producer/single-consumer ring
+// Producers reserve a range of slots with a compare-and-swap on the tail and
+// mark every slot ready with its sequence number once it is written, so a
+// slow producer only holds back the samples after its own.
+
+template <typename Sample, std::size_t Capacity> class MpscRing {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of two");
+  static_assert(std::is_trivially_copyable<Sample>::value,
+                "Samples must be trivially copyable");
+
+public:
+  MpscRing() : m_tail(0), m_head(0) {
+    for (std::size_t i = 0; i < Capacity; ++i)
+      m_ready[i].store(0, std::memory_order_relaxed);
+  }
+  MpscRing(const MpscRing &) = delete;
+  MpscRing &operator=(const MpscRing &) = delete;
+
+  static constexpr std::size_t capacity() { return Capacity; }
+
+  // Producer side, any thread, returns the number of samples pushed
+  std::size_t push_n(const Sample *in, std::size_t count) {
+    std::size_t tail = m_tail.load(std::memory_order_relaxed);
+    std::size_t n;
+    for (;;) {
+      const std::size_t head = m_head.load(std::memory_order_acquire);
+      const std::size_t used = tail - head;
+      if (used > Capacity) {
+        // The consumer passed our copy of the tail, reload it
+        tail = m_tail.load(std::memory_order_relaxed);
+        continue;
+      }
+      n = count < Capacity - used ? count : Capacity - used;
+      if (n == 0)
+        return 0;
+      if (m_tail.compare_exchange_weak(tail, tail + n,
+                                       std::memory_order_relaxed))
+        break;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+      const std::size_t pos = tail + i;
+      m_buffer[pos & Mask] = in[i];
+      m_ready[pos & Mask].store(pos + 1, std::memory_order_release);
+    }
+    return n;
+  }
+
+  bool push(const Sample &sample) { return push_n(&sample, 1) == 1; }
+
+  // Consumer side, returns the number of samples popped
+  template <typename Out> std::size_t pop_n(Out *out, std::size_t max) {
+    const std::size_t head = m_head.load(std::memory_order_relaxed);
+    std::size_t n = 0;
+    while (n < max && m_ready[(head + n) & Mask].load(
+                          std::memory_order_acquire) == head + n + 1) {
+      out[n] = Out(m_buffer[(head + n) & Mask]);
+      ++n;
+    }
+    if (n > 0)
+      m_head.store(head + n, std::memory_order_release);
+    return n;
+  }
+
+  template <typename Out> bool pop(Out &sample) {
+    return pop_n(&sample, 1) == 1;
+  }
+
+  // Approximate when called concurrently with the producers or the consumer
+  std::size_t size() const {
+    return m_tail.load(std::memory_order_acquire) -
+           m_head.load(std::memory_order_acquire);
+  }
+  bool empty() const { return size() == 0; }
+
+private:
+  static const std::size_t Mask = Capacity - 1;
+
+  alignas(64) std::atomic<std::size_t> m_tail;
+  alignas(64) std::atomic<std::size_t> m_head;
+  alignas(64) std::atomic<std::size_t> m_ready[Capacity];
+  alignas(64) Sample m_buffer[Capacity];
+};
+
+}; // namespace units
@@ -0,0 +1,172 @@
+/*
+Copyright 2024 Nikola Jelic <nikola.jelic83@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the “Software”), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "phys_angle.hpp"
+#include "phys_units.hpp"
+#include <ratio>
+
+namespace units {
+namespace si {
+
+// Catalogue of the SI base and derived units, the holding type defaults to
+// double and the factor selects the prefix, e.g. Length<int, std::milli>
+
+template <typename V = double, typename F = std::ratio<1>>
+using Length = PhysicalUnit<V, F, std::ratio<1>>;
+template <typename V = double, typename F = std::ratio<1>>
+using Mass = PhysicalUnit<V, F, std::ratio<0>, std::ratio<1>>;
+template <typename V = double, typename F = std::ratio<1>>
+using Time = PhysicalUnit<V, F, std::ratio<0>, std::ratio<0>, std::ratio<1>>;
+template <typename V = double, typename F = std::ratio<1>>
+using Current = PhysicalUnit<V, F, std::ratio<0>, std::ratio<0>, std::ratio<0>,
+                             std::ratio<1>>;
+template <typename V = double, typename F = std::ratio<1>>
+using Temperature =
+    PhysicalUnit<V, F, std::ratio<0>, std::ratio<0>, std::ratio<0>,
+                 std::ratio<0>, std::ratio<1>>;
+template <typename V = double, typename F = std::ratio<1>>
+using Amount = PhysicalUnit<V, F, std::ratio<0>, std::ratio<0>, std::ratio<0>,
+                            std::ratio<0>, std::ratio<0>, std::ratio<1>>;
+template <typename V = double, typename F = std::ratio<1>>
+using LuminousIntensity =
+    PhysicalUnit<V, F, std::ratio<0>, std::ratio<0>, std::ratio<0>,
+                 std::ratio<0>, std::ratio<0>, std::ratio<0>, std::ratio<1>>;
+template <typename V = double, typename F = RadianRatio>
+using Angle = PhysicalUnitAngle<V, F>;
+
+template <typename V = double, typename F = std::ratio<1>>
+using Area = PhysicalUnit<V, F, std::ratio<2>>;
+template <typename V = double, typename F = std::ratio<1>>
+using Volume = PhysicalUnit<V, F, std::ratio<3>>;
+template <typename V = double, typename F = std::ratio<1>>
+using Frequency =
+    PhysicalUnit<V, F, std::ratio<0>, std::ratio<0>, std::ratio<-1>>;
+template <typename V = double, typename F = std::ratio<1>>
+using Velocity =
+    PhysicalUnit<V, F, std::ratio<1>, std::ratio<0>, std::ratio<-1>>;
+template <typename V = double, typename F = std::ratio<1>>
+using Acceleration =
+    PhysicalUnit<V, F, std::ratio<1>, std::ratio<0>, std::ratio<-2>>;
+template <typename V = double, typename F = std::ratio<1>>
+using Force = PhysicalUnit<V, F, std::ratio<1>, std::ratio<1>, std::ratio<-2>>;
+template <typename V = double, typename F = std::ratio<1>>
+using Pressure =
+    PhysicalUnit<V, F, std::ratio<-1>, std::ratio<1>, std::ratio<-2>>;
+template <typename V = double, typename F = std::ratio<1>>
+using Energy = PhysicalUnit<V, F, std::ratio<2>, std::ratio<1>, std::ratio<-2>>;
+template <typename V = double, typename F = std::ratio<1>>
+using Power = PhysicalUnit<V, F, std::ratio<2>, std::ratio<1>, std::ratio<-3>>;
+template <typename V = double, typename F = std::ratio<1>>
+using Charge = PhysicalUnit<V, F, std::ratio<0>, std::ratio<0>, std::ratio<1>,
+                            std::ratio<1>>;
+template <typename V = double, typename F = std::ratio<1>>
+using Voltage = PhysicalUnit<V, F, std::ratio<2>, std::ratio<1>,
+                             std::ratio<-3>, std::ratio<-1>>;
+template <typename V = double, typename F = std::ratio<1>>
+using Capacitance = PhysicalUnit<V, F, std::ratio<-2>, std::ratio<-1>,
+                                 std::ratio<4>, std::ratio<2>>;
+template <typename V = double, typename F = std::ratio<1>>
+using Resistance = PhysicalUnit<V, F, std::ratio<2>, std::ratio<1>,
+                                std::ratio<-3>, std::ratio<-2>>;
+template <typename V = double, typename F = std::ratio<1>>
+using Conductance = PhysicalUnit<V, F, std::ratio<-2>, std::ratio<-1>,
+                                 std::ratio<3>, std::ratio<2>>;
+template <typename V = double, typename F = std::ratio<1>>
+using MagneticFlux = PhysicalUnit<V, F, std::ratio<2>, std::ratio<1>,
+                                  std::ratio<-2>, std::ratio<-1>>;
+template <typename V = double, typename F = std::ratio<1>>
+using MagneticFluxDensity = PhysicalUnit<V, F, std::ratio<0>, std::ratio<1>,
+                                         std::ratio<-2>, std::ratio<-1>>;
+template <typename V = double, typename F = std::ratio<1>>
+using Inductance = PhysicalUnit<V, F, std::ratio<2>, std::ratio<1>,
+                                std::ratio<-2>, std::ratio<-2>>;
+
+// Named units
+
+template <typename V = double> using Meter = Length<V>;
+template <typename V = double> using KiloMeter = Length<V, std::kilo>;
+template <typename V = double> using CentiMeter = Length<V, std::centi>;
+template <typename V = double> using MilliMeter = Length<V, std::milli>;
+template <typename V = double> using KiloGram = Mass<V>;
+template <typename V = double> using Gram = Mass<V, std::milli>;
+template <typename V = double> using Second = Time<V>;
+template <typename V = double> using MilliSecond = Time<V, std::milli>;
+template <typename V = double> using MicroSecond = Time<V, std::micro>;
+template <typename V = double> using NanoSecond = Time<V, std::nano>;
+template <typename V = double> using Minute = Time<V, std::ratio<60>>;
+template <typename V = double> using Hour = Time<V, std::ratio<3600>>;
+template <typename V = double> using Ampere = Current<V>;
+template <typename V = double> using MilliAmpere = Current<V, std::milli>;
+template <typename V = double> using Kelvin = Temperature<V>;
+template <typename V = double> using Mole = Amount<V>;
+template <typename V = double> using Candela = LuminousIntensity<V>;
+template <typename V = double> using Radian = Angle<V>;
+template <typename V = double> using Degree = Angle<V, std::ratio<1>>;
+
+template <typename V = double> using SquareMeter = Area<V>;
+template <typename V = double> using CubicMeter = Volume<V>;
+template <typename V = double> using Liter = Volume<V, std::milli>;
+template <typename V = double> using Hertz = Frequency<V>;
+template <typename V = double> using KiloHertz = Frequency<V, std::kilo>;
+template <typename V = double> using MegaHertz = Frequency<V, std::mega>;
+template <typename V = double> using MeterPerSecond = Velocity<V>;
+template <typename V = double>
+using KiloMeterPerHour = Velocity<V, std::ratio<1000, 3600>>;
+template <typename V = double> using MeterPerSecondSquared = Acceleration<V>;
+template <typename V = double> using Newton = Force<V>;
+template <typename V = double> using Pascal = Pressure<V>;
+template <typename V = double> using HectoPascal = Pressure<V, std::hecto>;
+template <typename V = double> using Bar = Pressure<V, std::ratio<100000>>;
+template <typename V = double> using Joule = Energy<V>;
+template <typename V = double> using KiloJoule = Energy<V, std::kilo>;
+template <typename V = double>
+using WattHour = Energy<V, std::ratio<3600>>;
+template <typename V = double> using Watt = Power<V>;
+template <typename V = double> using KiloWatt = Power<V, std::kilo>;
+template <typename V = double> using Coulomb = Charge<V>;
+template <typename V = double> using Volt = Voltage<V>;
+template <typename V = double> using MilliVolt = Voltage<V, std::milli>;
+template <typename V = double> using Farad = Capacitance<V>;
+template <typename V = double> using MicroFarad = Capacitance<V, std::micro>;
+template <typename V = double> using Ohm = Resistance<V>;
+template <typename V = double> using KiloOhm = Resistance<V, std::kilo>;
+template <typename V = double> using Siemens = Conductance<V>;
+template <typename V = double> using Weber = MagneticFlux<V>;
+template <typename V = double> using Tesla = MagneticFluxDensity<V>;
+template <typename V = double> using Henry = Inductance<V>;
+
+// Absolute temperatures, differences are in Kelvin
+
+template <typename V = double>
+using TempKelvin =
+    AbsolutePhysicalUnit<V, std::ratio<1>, V, std::ratio<0>, std::ratio<0>,
+                         std::ratio<0>, std::ratio<0>, std::ratio<0>,
+                         std::ratio<1>>;
+template <typename V = double>
+using TempCelsius =
+    AbsolutePhysicalUnit<V, std::ratio<1>, V, std::ratio<27315, 100>,
+                         std::ratio<0>, std::ratio<0>, std::ratio<0>,
+                         std::ratio<0>, std::ratio<1>>;
+
+}; // namespace si
+}; // namespace units
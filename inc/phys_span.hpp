@@ -0,0 +1,250 @@
+/*
+Copyright 2024 Nikola Jelic <nikola.jelic83@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the “Software”), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "phys_units.hpp"
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace units {
+
+// A unit is layout compatible with its holding value when it has the same
+// size and alignment and is a standard layout, trivially copyable wrapper of
+// it, so an array of values can be accessed as an array of units. Units with
+// virtual members, like AbsoluteAngle, are not.
+
+template <typename Unit> struct UnitLayout {
+  using ValueType = typename std::remove_const<Unit>::type::ValueType;
+  static constexpr bool compatible =
+      std::is_standard_layout<Unit>::value &&
+      std::is_trivially_copyable<Unit>::value &&
+      sizeof(Unit) == sizeof(ValueType) && alignof(Unit) == alignof(ValueType);
+};
+
+// Allocator whose value initialization of units, as in the count constructor
+// or resize() of a vector, leaves them unset instead of writing zeros, e.g.
+// for scratch buffers filled by a batch function. Copies and explicit values
+// construct as usual, and so do types without the Uninitialized constructor.
+
+template <typename T> class UninitializedAllocator {
+public:
+  using value_type = T;
+
+  UninitializedAllocator() = default;
+  template <typename U>
+  constexpr UninitializedAllocator(const UninitializedAllocator<U> &) {}
+
+  T *allocate(std::size_t count) { return std::allocator<T>().allocate(count); }
+  void deallocate(T *data, std::size_t count) {
+    std::allocator<T>().deallocate(data, count);
+  }
+
+  template <typename U>
+  typename std::enable_if<std::is_constructible<U, Uninitialized>::value>::type
+  construct(U *at) {
+    ::new (static_cast<void *>(at)) U(Uninitialized());
+  }
+
+  template <typename U, typename... Args>
+  void construct(U *at, Args &&...args) {
+    ::new (static_cast<void *>(at)) U(std::forward<Args>(args)...);
+  }
+
+  template <typename U>
+  constexpr bool operator==(const UninitializedAllocator<U> &) const {
+    return true;
+  }
+  template <typename U>
+  constexpr bool operator!=(const UninitializedAllocator<U> &) const {
+    return false;
+  }
+};
+
+template <typename Unit>
+using UninitializedVector = std::vector<Unit, UninitializedAllocator<Unit>>;
+
+// Non-owning view of raw values from a driver, shared memory or another
+// library as units, without copying. A const unit gives a read-only view.
+// The elements are the units themselves, so the span plugs into the batch
+// functions taking unit pointers and into the standard algorithms.
+
+template <typename Unit> class QuantitySpan {
+  static_assert(UnitLayout<Unit>::compatible,
+                "The unit must have the layout of its holding value");
+
+public:
+  using ValueType = typename UnitLayout<Unit>::ValueType;
+  using RawType = typename std::conditional<std::is_const<Unit>::value,
+                                            const ValueType, ValueType>::type;
+  using iterator = Unit *;
+
+  constexpr QuantitySpan() : m_data(nullptr), m_size(0) {}
+  QuantitySpan(RawType *raw, std::size_t size)
+      : m_data(reinterpret_cast<Unit *>(raw)), m_size(size) {}
+  constexpr QuantitySpan(Unit *data, std::size_t size)
+      : m_data(data), m_size(size) {}
+  template <typename U, typename = typename std::enable_if<std::is_same<
+                            const U, Unit>::value>::type>
+  constexpr QuantitySpan(const QuantitySpan<U> &other)
+      : m_data(other.data()), m_size(other.size()) {}
+
+  constexpr Unit *data() const { return m_data; }
+  RawType *raw() const { return reinterpret_cast<RawType *>(m_data); }
+  constexpr std::size_t size() const { return m_size; }
+  constexpr bool empty() const { return m_size == 0; }
+  constexpr Unit *begin() const { return m_data; }
+  constexpr Unit *end() const { return m_data + m_size; }
+  constexpr Unit &operator[](std::size_t i) const { return m_data[i]; }
+
+  // Clamped to the end of the span
+  QuantitySpan subspan(std::size_t offset, std::size_t count) const {
+    offset = offset < m_size ? offset : m_size;
+    count = count < m_size - offset ? count : m_size - offset;
+    return QuantitySpan(m_data + offset, count);
+  }
+
+private:
+  Unit *m_data;
+  std::size_t m_size;
+};
+
+template <typename Unit, typename V>
+QuantitySpan<Unit> quantity_span(V *raw, std::size_t size) {
+  return QuantitySpan<Unit>(raw, size);
+}
+
+// Lazy view of a span in another scale of the same dimension: the factor and
+// the offset are applied on every access, or a block at a time with copy()
+// and for_each_block(), which hand converted blocks to batch functions.
+
+template <typename To, typename From> class RescaledView {
+public:
+  using Source = typename std::remove_const<From>::type;
+  static const std::size_t Block = 256;
+
+  class const_iterator {
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = To;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const To *;
+    using reference = To;
+
+    constexpr const_iterator() : m_at(nullptr) {}
+    constexpr explicit const_iterator(const Source *at) : m_at(at) {}
+
+    To operator*() const { return To(*m_at); }
+    To operator[](difference_type n) const { return To(m_at[n]); }
+    const_iterator &operator++() {
+      ++m_at;
+      return *this;
+    }
+    const_iterator operator++(int) { return const_iterator(m_at++); }
+    const_iterator &operator--() {
+      --m_at;
+      return *this;
+    }
+    const_iterator operator--(int) { return const_iterator(m_at--); }
+    const_iterator &operator+=(difference_type n) {
+      m_at += n;
+      return *this;
+    }
+    const_iterator &operator-=(difference_type n) {
+      m_at -= n;
+      return *this;
+    }
+    const_iterator operator+(difference_type n) const {
+      return const_iterator(m_at + n);
+    }
+    friend const_iterator operator+(difference_type n, const_iterator it) {
+      return it + n;
+    }
+    const_iterator operator-(difference_type n) const {
+      return const_iterator(m_at - n);
+    }
+    difference_type operator-(const const_iterator &rhs) const {
+      return m_at - rhs.m_at;
+    }
+    bool operator==(const const_iterator &rhs) const {
+      return m_at == rhs.m_at;
+    }
+    bool operator!=(const const_iterator &rhs) const {
+      return m_at != rhs.m_at;
+    }
+    bool operator<(const const_iterator &rhs) const {
+      return m_at < rhs.m_at;
+    }
+    bool operator>(const const_iterator &rhs) const {
+      return m_at > rhs.m_at;
+    }
+    bool operator<=(const const_iterator &rhs) const {
+      return m_at <= rhs.m_at;
+    }
+    bool operator>=(const const_iterator &rhs) const {
+      return m_at >= rhs.m_at;
+    }
+
+  private:
+    const Source *m_at;
+  };
+
+  constexpr explicit RescaledView(const QuantitySpan<const Source> &source)
+      : m_source(source) {}
+
+  constexpr std::size_t size() const { return m_source.size(); }
+  constexpr bool empty() const { return m_source.empty(); }
+  constexpr const QuantitySpan<const Source> &source() const {
+    return m_source;
+  }
+  To operator[](std::size_t i) const { return To(m_source[i]); }
+  const_iterator begin() const { return const_iterator(m_source.begin()); }
+  const_iterator end() const { return const_iterator(m_source.end()); }
+
+  // Converts up to count units from first on, returns the number converted
+  std::size_t copy(std::size_t first, std::size_t count, To *out) const {
+    const QuantitySpan<const Source> part = m_source.subspan(first, count);
+    unit_cast_n(part.data(), part.size(), out);
+    return part.size();
+  }
+
+  // Calls body(const To *, size_t count) for consecutive converted blocks
+  template <typename Body> void for_each_block(Body body) const {
+    To block[Block];
+    for (std::size_t first = 0; first < size(); first += Block)
+      body(static_cast<const To *>(block), copy(first, Block, block));
+  }
+
+private:
+  QuantitySpan<const Source> m_source;
+};
+
+template <typename To, typename From>
+RescaledView<To, From> as(const QuantitySpan<From> &source) {
+  return RescaledView<To, From>(source);
+}
+
+}; // namespace units
@@ -0,0 +1,231 @@
+/*
+Copyright 2024 Nikola Jelic <nikola.jelic83@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the “Software”), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "phys_units.hpp"
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace units {
+
+// Running count, mean, variance and extremes (Welford), mergeable (Chan et al.)
+
+template <typename Unit> class RunningStats {
+public:
+  using SampleType = Unit;
+  using ValueType = typename Unit::ValueType;
+  using CalcType = typename ResultingType<ValueType>::type;
+  using MeanType = typename RebindValueType<Unit, CalcType>::type;
+  using DiffType =
+      typename RebindValueType<typename DiffUnitType<Unit>::type,
+                               CalcType>::type;
+  using VarianceType = decltype(DiffType() * DiffType());
+
+  RunningStats()
+      : m_count(0), m_mean(0), m_m2(0),
+        m_min(std::numeric_limits<ValueType>::max()),
+        m_max(std::numeric_limits<ValueType>::lowest()) {}
+
+  void push(const Unit &sample) {
+    const ValueType val = sample.value();
+    const CalcType delta = CalcType(val) - m_mean;
+    ++m_count;
+    m_mean += delta / CalcType(m_count);
+    m_m2 += delta * (CalcType(val) - m_mean);
+    m_min = val < m_min ? val : m_min;
+    m_max = val > m_max ? val : m_max;
+  }
+
+  void merge(const RunningStats &other) {
+    if (other.m_count == 0)
+      return;
+    const uint64_t total = m_count + other.m_count;
+    const CalcType delta = other.m_mean - m_mean;
+    const CalcType weight = CalcType(other.m_count) / CalcType(total);
+    m_m2 += other.m_m2 + delta * delta * CalcType(m_count) * weight;
+    m_mean += delta * weight;
+    m_count = total;
+    m_min = other.m_min < m_min ? other.m_min : m_min;
+    m_max = other.m_max > m_max ? other.m_max : m_max;
+  }
+
+  void reset() { *this = RunningStats(); }
+
+  uint64_t count() const { return m_count; }
+  MeanType mean() const { return MeanType(m_mean); }
+  VarianceType variance() const {
+    return VarianceType(m_count ? m_m2 / CalcType(m_count) : CalcType(0));
+  }
+  VarianceType sample_variance() const {
+    return VarianceType(m_count > 1 ? m_m2 / CalcType(m_count - 1)
+                                    : CalcType(0));
+  }
+  DiffType stddev() const {
+    return DiffType(std::sqrt(variance().value()));
+  }
+  Unit min() const { return Unit(m_count ? m_min : ValueType(0)); }
+  Unit max() const { return Unit(m_count ? m_max : ValueType(0)); }
+
+private:
+  uint64_t m_count;
+  CalcType m_mean;
+  CalcType m_m2;
+  ValueType m_min;
+  ValueType m_max;
+};
+
+// Exponential moving average, the first sample seeds the average
+
+template <typename Unit> class ExpMovingAverage {
+public:
+  using SampleType = Unit;
+  using CalcType = typename ResultingType<typename Unit::ValueType>::type;
+  using MeanType = typename RebindValueType<Unit, CalcType>::type;
+
+  explicit ExpMovingAverage(CalcType alpha)
+      : m_alpha(alpha), m_value(0), m_seeded(false) {}
+
+  void push(const Unit &sample) {
+    const CalcType val = CalcType(sample.value());
+    m_value = m_seeded ? m_value + m_alpha * (val - m_value) : val;
+    m_seeded = true;
+  }
+
+  void reset() {
+    m_value = 0;
+    m_seeded = false;
+  }
+
+  CalcType alpha() const { return m_alpha; }
+  bool seeded() const { return m_seeded; }
+  MeanType value() const { return MeanType(m_value); }
+
+private:
+  CalcType m_alpha;
+  CalcType m_value;
+  bool m_seeded;
+};
+
+// Streaming quantile estimate with five markers (P-square, Jain & Chlamtac)
+// The markers cannot be merged; keep one estimator per stream.
+
+template <typename Unit> class P2Quantile {
+public:
+  using SampleType = Unit;
+  using CalcType = typename ResultingType<typename Unit::ValueType>::type;
+  using MeanType = typename RebindValueType<Unit, CalcType>::type;
+
+  explicit P2Quantile(CalcType quantile) : m_count(0) {
+    m_increment[0] = 0;
+    m_increment[1] = quantile / 2;
+    m_increment[2] = quantile;
+    m_increment[3] = (1 + quantile) / 2;
+    m_increment[4] = 1;
+    for (int i = 0; i < 5; ++i) {
+      m_height[i] = 0;
+      m_position[i] = i + 1;
+      m_desired[i] = 1 + 4 * m_increment[i];
+    }
+  }
+
+  void push(const Unit &sample) {
+    const CalcType val = CalcType(sample.value());
+    if (m_count < 5) {
+      int i = int(m_count++);
+      for (; i > 0 && m_height[i - 1] > val; --i)
+        m_height[i] = m_height[i - 1];
+      m_height[i] = val;
+      return;
+    }
+    ++m_count;
+
+    int cell;
+    if (val < m_height[0]) {
+      m_height[0] = val;
+      cell = 0;
+    } else if (val >= m_height[4]) {
+      m_height[4] = val;
+      cell = 3;
+    } else {
+      cell = 0;
+      while (val >= m_height[cell + 1])
+        ++cell;
+    }
+    for (int i = cell + 1; i < 5; ++i)
+      ++m_position[i];
+    for (int i = 0; i < 5; ++i)
+      m_desired[i] += m_increment[i];
+
+    for (int i = 1; i < 4; ++i) {
+      const CalcType diff = m_desired[i] - CalcType(m_position[i]);
+      if ((diff >= 1 && m_position[i + 1] - m_position[i] > 1) ||
+          (diff <= -1 && m_position[i - 1] - m_position[i] < -1)) {
+        const int dir = diff > 0 ? 1 : -1;
+        CalcType height = parabolic(i, dir);
+        if (!(m_height[i - 1] < height && height < m_height[i + 1]))
+          height = linear(i, dir);
+        m_height[i] = height;
+        m_position[i] += dir;
+      }
+    }
+  }
+
+  uint64_t count() const { return m_count; }
+
+  MeanType value() const {
+    if (m_count == 0)
+      return MeanType(CalcType(0));
+    if (m_count <= 5) {
+      const int idx = int(std::round(m_increment[2] * CalcType(m_count - 1)));
+      return MeanType(m_height[idx]);
+    }
+    return MeanType(m_height[2]);
+  }
+
+private:
+  CalcType parabolic(int i, int dir) const {
+    const CalcType d = CalcType(dir);
+    const CalcType nPrev = CalcType(m_position[i - 1]);
+    const CalcType nCur = CalcType(m_position[i]);
+    const CalcType nNext = CalcType(m_position[i + 1]);
+    return m_height[i] +
+           d / (nNext - nPrev) *
+               ((nCur - nPrev + d) * (m_height[i + 1] - m_height[i]) /
+                    (nNext - nCur) +
+                (nNext - nCur - d) * (m_height[i] - m_height[i - 1]) /
+                    (nCur - nPrev));
+  }
+
+  CalcType linear(int i, int dir) const {
+    return m_height[i] + CalcType(dir) * (m_height[i + dir] - m_height[i]) /
+                             CalcType(m_position[i + dir] - m_position[i]);
+  }
+
+  uint64_t m_count;
+  CalcType m_height[5];
+  int64_t m_position[5];
+  CalcType m_desired[5];
+  CalcType m_increment[5];
+};
+
+}; // namespace units
@@ -19,12 +19,343 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
+#pragma once
+
 #include "phys_units.hpp"
-#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ratio>
+#include <type_traits>
+#if !defined(PHYS_UNITS_NO_STD_STRING)
 #include <string>
+#endif
+
+namespace units {
+
+inline const char *si_unit_name(int index) {
+  static const char *const names[] = {"m", "kg",  "s",  "A",
+                                      "K", "mol", "cd", "deg"};
+  return names[index];
+}
+
+// Formatting into a caller provided buffer, without the heap, exceptions or
+// std::string, for small targets. The text is the one of std::to_string and
+// is truncated to the buffer, which is always terminated.
+
+class FormatBuffer {
+public:
+  FormatBuffer(char *buffer, std::size_t size)
+      : m_begin(buffer), m_next(buffer), m_end(buffer + (size ? size - 1 : 0)) {
+    if (size > 0)
+      *buffer = 0;
+  }
+
+  std::size_t size() const { return std::size_t(m_next - m_begin); }
+
+  void append(char c) {
+    if (m_next < m_end) {
+      *m_next++ = c;
+      *m_next = 0;
+    }
+  }
+
+  void append(const char *text) {
+    while (*text)
+      append(*text++);
+  }
+
+  void append_integer(std::intmax_t value) {
+    if (value < 0)
+      append('-');
+    append_unsigned(value < 0 ? 0 - std::uintmax_t(value)
+                              : std::uintmax_t(value));
+  }
+
+  void append_unsigned(std::uintmax_t value, int digits = 1) {
+    char text[24];
+    int count = 0;
+    while (value > 0 || count < digits) {
+      text[count++] = char('0' + value % 10);
+      value /= 10;
+    }
+    while (count > 0)
+      append(text[--count]);
+  }
+
+  // Six decimals rounded from the exact binary value, half way cases to even,
+  // as printf("%f")
+  void append_fixed(double value) {
+    if (value != value)
+      return append("nan");
+    if (value < 0 || (value == 0 && 1 / value < 0)) {
+      append('-');
+      value = -value;
+    }
+    if (value > 1.7976931348623157e308)
+      return append("inf");
+    // value = mantissa * 2^shift, with a mantissa of 53 bits
+    int exponent = 0;
+    const std::uint64_t mantissa =
+        std::uint64_t(std::ldexp(std::frexp(value, &exponent), 53));
+    const int shift = exponent - 53;
+    if (shift >= 0) {
+      append_shifted(mantissa, shift);
+      return append(".000000");
+    }
+    const int bits = -shift;
+    std::uint64_t integral = bits < 64 ? mantissa >> bits : 0;
+    std::uint64_t micros = round_micros(
+        bits < 64 ? mantissa & ((std::uint64_t(1) << bits) - 1) : mantissa,
+        bits);
+    if (micros == 1000000) {
+      ++integral;
+      micros = 0;
+    }
+    append_unsigned(integral);
+    append('.');
+    append_unsigned(micros, 6);
+  }
+
+  // Six decimals and the exponent, rounded from the exact binary value, half
+  // way cases to even, as printf("%e")
+  void append_scientific(double value) {
+    if (value != value)
+      return append("nan");
+    if (value < 0 || (value == 0 && 1 / value < 0)) {
+      append('-');
+      value = -value;
+    }
+    if (value > 1.7976931348623157e308)
+      return append("inf");
+    int exponent = 0;
+    std::uint64_t digits = 0;
+    if (value > 0) {
+      int binary = 0;
+      std::uint64_t mantissa =
+          std::uint64_t(std::ldexp(std::frexp(value, &binary), 53));
+      int shift = binary - 53;
+      for (; shift < 0 && (mantissa & 1) == 0; ++shift)
+        mantissa >>= 1;
+      // Up to 767 digits, a mantissa of 53 bits times 5^1074
+      std::uint32_t chunks[86];
+      const int used = decimal_chunks(mantissa, shift, chunks);
+      int top = 1;
+      for (std::uint32_t rest = chunks[used - 1]; rest >= 10; rest /= 10)
+        ++top;
+      exponent = top - 1 + 9 * (used - 1) + (shift < 0 ? shift : 0);
+      // The first eight significant digits and whether any other follows
+      int taken = 0;
+      bool tail = false;
+      for (int c = used - 1; c >= 0; --c) {
+        const int width = c == used - 1 ? top : 9;
+        const int take = 8 - taken < width ? 8 - taken : width;
+        std::uint32_t power = 1;
+        for (int d = take; d < width; ++d)
+          power *= 10;
+        const std::uint32_t chunk = chunks[c];
+        for (int d = 0; d < take; ++d)
+          digits *= 10;
+        digits += chunk / power;
+        taken += take;
+        tail = tail || chunk % power != 0;
+      }
+      for (; taken < 8; ++taken)
+        digits *= 10;
+      const std::uint64_t last = digits % 10;
+      digits /= 10;
+      if (last > 5 || (last == 5 && (tail || (digits & 1))))
+        ++digits;
+      if (digits >= 10000000) {
+        digits /= 10;
+        ++exponent;
+      }
+    }
+    append_unsigned(digits / 1000000);
+    append('.');
+    append_unsigned(digits % 1000000, 6);
+    append('e');
+    append(exponent < 0 ? '-' : '+');
+    append_unsigned(std::uintmax_t(exponent < 0 ? -exponent : exponent), 2);
+  }
+
+  template <typename V>
+  typename std::enable_if<std::is_integral<V>::value>::type
+  append_value(V value) {
+    if (std::is_signed<V>::value)
+      append_integer(std::intmax_t(value));
+    else
+      append_unsigned(std::uintmax_t(value));
+  }
+
+  template <typename V>
+  typename std::enable_if<std::is_floating_point<V>::value>::type
+  append_value(V value) {
+    append_fixed(double(value));
+  }
+
+private:
+  // fraction / 2^bits in millionths, rounded half way to even; the product
+  // of the fraction and a million takes 73 bits, kept as high and low words
+  static std::uint64_t round_micros(std::uint64_t fraction, int bits) {
+    if (bits > 74)
+      return 0;
+    const std::uint64_t low = (fraction & 0xffffffffu) * 1000000;
+    const std::uint64_t high = (fraction >> 32) * 1000000;
+    const std::uint64_t lo = low + (high << 32);
+    const std::uint64_t hi = (high >> 32) + (lo < low ? 1 : 0);
+    std::uint64_t micros, restHi, restLo, halfHi, halfLo;
+    if (bits >= 64) {
+      micros = hi >> (bits - 64);
+      restHi = hi & ((std::uint64_t(1) << (bits - 64)) - 1);
+      restLo = lo;
+      halfHi = bits > 64 ? std::uint64_t(1) << (bits - 65) : 0;
+      halfLo = bits > 64 ? 0 : std::uint64_t(1) << 63;
+    } else {
+      micros = (lo >> bits) | (hi << (64 - bits));
+      restHi = 0;
+      restLo = lo & ((std::uint64_t(1) << bits) - 1);
+      halfHi = 0;
+      halfLo = std::uint64_t(1) << (bits - 1);
+    }
+    const bool above = restHi > halfHi || (restHi == halfHi && restLo > halfLo);
+    const bool half = restHi == halfHi && restLo == halfLo;
+    return micros + ((above || (half && (micros & 1))) ? 1 : 0);
+  }
+
+  // mantissa * 2^shift in chunks of nine decimal digits, least significant
+  // first. A negative shift gives mantissa * 5^-shift instead, the digits of
+  // the value times 10^-shift.
+  static int decimal_chunks(std::uint64_t mantissa, int shift,
+                            std::uint32_t *chunks) {
+    int used = 0;
+    for (; mantissa > 0; mantissa /= 1000000000)
+      chunks[used++] = std::uint32_t(mantissa % 1000000000);
+    for (int left = shift < 0 ? -shift : shift; left > 0;) {
+      // 2^16 and 5^13 keep a chunk times the factor within 64 bits
+      const int step = shift < 0 ? (left < 13 ? left : 13)
+                                 : (left < 16 ? left : 16);
+      std::uint64_t factor = 1;
+      for (int i = 0; i < step; ++i)
+        factor *= shift < 0 ? 5 : 2;
+      std::uint64_t carry = 0;
+      for (int c = 0; c < used; ++c) {
+        const std::uint64_t next = chunks[c] * factor + carry;
+        chunks[c] = std::uint32_t(next % 1000000000);
+        carry = next / 1000000000;
+      }
+      for (; carry > 0; carry /= 1000000000)
+        chunks[used++] = std::uint32_t(carry % 1000000000);
+      left -= step;
+    }
+    return used;
+  }
+
+  // mantissa * 2^shift in decimal
+  void append_shifted(std::uint64_t mantissa, int shift) {
+    if (shift < 11)
+      return append_unsigned(mantissa << shift);
+    std::uint32_t chunks[36];
+    const int used = decimal_chunks(mantissa, shift, chunks);
+    append_unsigned(chunks[used - 1]);
+    for (int c = used - 2; c >= 0; --c)
+      append_unsigned(chunks[c], 9);
+  }
+
+  char *m_begin;
+  char *m_next;
+  char *m_end;
+};
+
+template <typename Factor> const char *prefix_symbol() {
+  return std::is_same<Factor, std::atto>::value    ? "a"
+         : std::is_same<Factor, std::femto>::value ? "f"
+         : std::is_same<Factor, std::pico>::value  ? "p"
+         : std::is_same<Factor, std::nano>::value  ? "n"
+         : std::is_same<Factor, std::micro>::value ? "u"
+         : std::is_same<Factor, std::milli>::value ? "m"
+         : std::is_same<Factor, std::centi>::value ? "c"
+         : std::is_same<Factor, std::deci>::value  ? "d"
+         : std::is_same<Factor, std::deca>::value  ? "da"
+         : std::is_same<Factor, std::hecto>::value ? "h"
+         : std::is_same<Factor, std::kilo>::value  ? "k"
+         : std::is_same<Factor, std::mega>::value  ? "M"
+         : std::is_same<Factor, std::giga>::value  ? "G"
+         : std::is_same<Factor, std::tera>::value  ? "T"
+         : std::is_same<Factor, std::peta>::value  ? "P"
+         : std::is_same<Factor, std::exa>::value   ? "E"
+                                                   : nullptr;
+}
+
+template <typename Factor> void format_prefix(FormatBuffer &out) {
+  if (prefix_symbol<Factor>())
+    out.append(prefix_symbol<Factor>());
+  else if (Factor::num != 1 || Factor::den != 1) {
+    out.append_integer(Factor::num);
+    out.append('/');
+    out.append_integer(Factor::den);
+  }
+}
+
+template <int Index, typename... Dims> struct DimFormat {
+  static void append(FormatBuffer &, bool) {}
+};
+
+template <int Index, typename Dim, typename... Dims>
+struct DimFormat<Index, Dim, Dims...> {
+  static void append(FormatBuffer &out, bool tail) {
+    if (Dim::num != 0) {
+      if (tail)
+        out.append(' ');
+      out.append(si_unit_name(Index));
+      if (Dim::num != 1 || Dim::den != 1) {
+        out.append('^');
+        out.append_integer(Dim::num);
+        if (Dim::den != 1) {
+          out.append('/');
+          out.append_integer(Dim::den);
+        }
+      }
+      tail = true;
+    }
+    DimFormat<Index + 1, Dims...>::append(out, tail);
+  }
+};
+
+// Volts
+template <>
+struct DimFormat<0, std::ratio<2>, std::ratio<1>, std::ratio<-3>,
+                 std::ratio<-1>, std::ratio<0>, std::ratio<0>, std::ratio<0>,
+                 std::ratio<0>> {
+  static void append(FormatBuffer &out, bool) { out.append('V'); }
+};
+
+// Returns the length of the text, without the terminating zero
+template <typename V, typename Factor, typename... Dims>
+std::size_t format_unit(const PhysicalUnit<V, Factor, Dims...> &val,
+                        char *buffer, std::size_t size) {
+  FormatBuffer out(buffer, size);
+  out.append_value(val.value());
+  format_prefix<Factor>(out);
+  DimFormat<0, Dims...>::append(out, false);
+  return out.size();
+}
+
+template <typename V, typename Factor, typename DV, typename Offset,
+          typename... Dims>
+std::size_t
+format_unit(const AbsolutePhysicalUnit<V, Factor, DV, Offset, Dims...> &val,
+            char *buffer, std::size_t size) {
+  FormatBuffer out(buffer, size);
+  out.append_value(val.value());
+  format_prefix<Factor>(out);
+  DimFormat<0, Dims...>::append(out, false);
+  return out.size();
+}
 
-static std::array<std::string, 8> si_unit_names = {"m", "kg",  "s",  "A",
-                                                   "K", "mol", "cd", "deg"};
+}; // namespace units
+
+#if !defined(PHYS_UNITS_NO_STD_STRING)
 
 template <typename Factor> std::string unit_prefix() {
   if (Factor::num == 1 && Factor::den == 1)
@@ -35,37 +366,37 @@ template <typename Factor> std::string unit_prefix() {
 
 // helpers
 
-template <> std::string unit_prefix<std::atto>() { return "a"; }
+template <> inline std::string unit_prefix<std::atto>() { return "a"; }
 
-template <> std::string unit_prefix<std::femto>() { return "f"; }
+template <> inline std::string unit_prefix<std::femto>() { return "f"; }
 
-template <> std::string unit_prefix<std::pico>() { return "p"; }
+template <> inline std::string unit_prefix<std::pico>() { return "p"; }
 
-template <> std::string unit_prefix<std::nano>() { return "n"; }
+template <> inline std::string unit_prefix<std::nano>() { return "n"; }
 
-template <> std::string unit_prefix<std::micro>() { return "u"; }
+template <> inline std::string unit_prefix<std::micro>() { return "u"; }
 
-template <> std::string unit_prefix<std::milli>() { return "m"; }
+template <> inline std::string unit_prefix<std::milli>() { return "m"; }
 
-template <> std::string unit_prefix<std::centi>() { return "c"; }
+template <> inline std::string unit_prefix<std::centi>() { return "c"; }
 
-template <> std::string unit_prefix<std::deci>() { return "d"; }
+template <> inline std::string unit_prefix<std::deci>() { return "d"; }
 
-template <> std::string unit_prefix<std::deca>() { return "da"; }
+template <> inline std::string unit_prefix<std::deca>() { return "da"; }
 
-template <> std::string unit_prefix<std::hecto>() { return "h"; }
+template <> inline std::string unit_prefix<std::hecto>() { return "h"; }
 
-template <> std::string unit_prefix<std::kilo>() { return "k"; }
+template <> inline std::string unit_prefix<std::kilo>() { return "k"; }
 
-template <> std::string unit_prefix<std::mega>() { return "M"; }
+template <> inline std::string unit_prefix<std::mega>() { return "M"; }
 
-template <> std::string unit_prefix<std::giga>() { return "G"; }
+template <> inline std::string unit_prefix<std::giga>() { return "G"; }
 
-template <> std::string unit_prefix<std::tera>() { return "T"; }
+template <> inline std::string unit_prefix<std::tera>() { return "T"; }
 
-template <> std::string unit_prefix<std::peta>() { return "P"; }
+template <> inline std::string unit_prefix<std::peta>() { return "P"; }
 
-template <> std::string unit_prefix<std::exa>() { return "E"; }
+template <> inline std::string unit_prefix<std::exa>() { return "E"; }
 
 template <int Index> std::string dim_to_string(bool) { return ""; }
 
@@ -75,19 +406,18 @@ std::string dim_to_string(bool tail = false) {
   if (Dim::num == 0)
     result = "";
   else {
-    result = (tail ? " " : "") + si_unit_names[Index];
-    if (Dim::num != 1 || Dim::den != 1) {
+    result = (tail ? " " : "") + std::string(units::si_unit_name(Index));
+    if (Dim::num != 1 || Dim::den != 1)
       result += "^" + std::to_string(Dim::num) +
-                (Dim::den == 1 ? "" : "/" + Dim::den);
-      tail = true;
-    }
+                (Dim::den == 1 ? "" : "/" + std::to_string(Dim::den));
+    tail = true;
   }
   return result + dim_to_string<Index + 1, Dims...>(tail);
 }
 
 // Volts
 template <>
-std::string
+inline std::string
 dim_to_string<0, std::ratio<2>, std::ratio<1>, std::ratio<-3>, std::ratio<-1>,
               std::ratio<0>, std::ratio<0>, std::ratio<0>, std::ratio<0>>(
     bool) {
@@ -102,11 +432,13 @@ std::string to_string(const units::PhysicalUnit<V, Factor, Dims...> &val) {
          dim_to_string<0, Dims...>();
 }
 
-template <typename V, typename DV, typename Offset, typename Factor,
+template <typename V, typename Factor, typename DV, typename Offset,
           typename... Dims>
 std::string to_string(
-    const units::AbsolutePhysicalUnit<V, DV, Offset, Factor, Dims...> &val) {
+    const units::AbsolutePhysicalUnit<V, Factor, DV, Offset, Dims...> &val) {
   return std::to_string(val.value()) + unit_prefix<Factor>() +
          dim_to_string<0, Dims...>();
 }
 }; // namespace std
+
+#endif
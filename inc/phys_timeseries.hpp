@@ -0,0 +1,454 @@
+/*
+Copyright 2024 Nikola Jelic <nikola.jelic83@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the “Software”), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "phys_units.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace units {
+
+// Runtime record of a unit type: holding type, conversion factor, offset and
+// the dimension exponents, in the same order as the template parameters
+
+struct UnitDescriptor {
+  enum Kind : uint8_t { Signed = 0, Unsigned = 1, Floating = 2 };
+  static const int Dims = 8;
+
+  uint8_t kind;
+  uint8_t size;
+  uint8_t absolute;
+  int64_t factor[2];
+  int64_t offset[2];
+  int64_t dims[Dims][2];
+
+  bool operator==(const UnitDescriptor &rhs) const {
+    bool same = kind == rhs.kind && size == rhs.size &&
+                absolute == rhs.absolute && factor[0] == rhs.factor[0] &&
+                factor[1] == rhs.factor[1] && offset[0] == rhs.offset[0] &&
+                offset[1] == rhs.offset[1];
+    for (int d = 0; d < Dims; ++d)
+      same = same && dims[d][0] == rhs.dims[d][0] &&
+             dims[d][1] == rhs.dims[d][1];
+    return same;
+  }
+  bool operator!=(const UnitDescriptor &rhs) const { return !(*this == rhs); }
+
+  template <typename V, typename F, typename O, typename... Ds>
+  static UnitDescriptor make(bool isAbsolute) {
+    static_assert(std::is_arithmetic<V>::value,
+                  "Only arithmetic holding types can be stored");
+    UnitDescriptor desc;
+    std::memset(&desc, 0, sizeof(desc));
+    desc.kind = std::is_floating_point<V>::value ? Floating
+                : std::is_signed<V>::value       ? Signed
+                                                 : Unsigned;
+    desc.size = uint8_t(sizeof(V));
+    desc.absolute = isAbsolute;
+    desc.factor[0] = F::num;
+    desc.factor[1] = F::den;
+    desc.offset[0] = O::num;
+    desc.offset[1] = O::den;
+    const int64_t nums[] = {Ds::num...};
+    const int64_t dens[] = {Ds::den...};
+    for (int d = 0; d < Dims; ++d) {
+      desc.dims[d][0] = d < int(sizeof...(Ds)) ? nums[d] : 0;
+      desc.dims[d][1] = d < int(sizeof...(Ds)) ? dens[d] : 1;
+    }
+    return desc;
+  }
+};
+
+template <typename Unit> struct DescribeUnit {};
+
+template <typename V, typename F, typename... Ds>
+struct DescribeUnit<PhysicalUnit<V, F, Ds...>> {
+  static UnitDescriptor get() {
+    return UnitDescriptor::make<V, F, std::ratio<0>, Ds...>(false);
+  }
+};
+
+template <typename V, typename F, typename D, typename O, typename... Ds>
+struct DescribeUnit<AbsolutePhysicalUnit<V, F, D, O, Ds...>> {
+  static UnitDescriptor get() {
+    return UnitDescriptor::make<V, F, O, Ds...>(true);
+  }
+};
+
+// Append-only bit stream, least significant bit first
+
+class BitStream {
+public:
+  BitStream() : m_bits(0) {}
+
+  void write(uint64_t value, unsigned width) {
+    if (width == 0)
+      return;
+    value &= mask(width);
+    const unsigned offset = unsigned(m_bits % 64);
+    if (offset == 0)
+      m_words.push_back(0);
+    m_words.back() |= value << offset;
+    if (offset + width > 64)
+      m_words.push_back(value >> (64 - offset));
+    m_bits += width;
+  }
+
+  uint64_t read(uint64_t &pos, unsigned width) const {
+    if (width == 0)
+      return 0;
+    const std::size_t word = std::size_t(pos / 64);
+    const unsigned offset = unsigned(pos % 64);
+    uint64_t value = m_words[word] >> offset;
+    if (offset + width > 64)
+      value |= m_words[word + 1] << (64 - offset);
+    pos += width;
+    return value & mask(width);
+  }
+
+  uint64_t bits() const { return m_bits; }
+  const std::vector<uint64_t> &words() const { return m_words; }
+  void assign(const uint64_t *words, std::size_t count, uint64_t bits) {
+    m_words.assign(words, words + count);
+    m_bits = bits;
+  }
+
+  static uint64_t mask(unsigned width) {
+    return width >= 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+  }
+
+private:
+  std::vector<uint64_t> m_words;
+  uint64_t m_bits;
+};
+
+inline unsigned leading_zeros(uint64_t val) {
+#if defined(__GNUC__)
+  return val ? unsigned(__builtin_clzll(val)) : 64;
+#else
+  unsigned count = 0;
+  for (uint64_t bit = uint64_t(1) << 63; bit && !(val & bit); bit >>= 1)
+    ++count;
+  return count;
+#endif
+}
+
+inline unsigned trailing_zeros(uint64_t val) {
+#if defined(__GNUC__)
+  return val ? unsigned(__builtin_ctzll(val)) : 64;
+#else
+  unsigned count = 0;
+  for (; count < 64 && !(val & (uint64_t(1) << count)); ++count) {
+  }
+  return count;
+#endif
+}
+
+// One chunk of a time series; integral values are stored as zigzag
+// delta-of-delta in bit-packed blocks of 64, floating values with the XOR
+// scheme from Facebook's Gorilla
+
+class TimeSeriesChunk {
+public:
+  enum : unsigned { BlockSize = 64 };
+
+  explicit TimeSeriesChunk(const UnitDescriptor &desc)
+      : m_desc(desc), m_count(0), m_prev(0), m_prevDelta(0), m_leading(0),
+        m_trailing(0), m_pending(0), m_sealed(false), m_block() {}
+
+  const UnitDescriptor &descriptor() const { return m_desc; }
+  std::size_t size() const { return std::size_t(m_count); }
+
+  // Encoded size in bytes, header included
+  std::size_t bytes() const {
+    return sizeof(UnitDescriptor) + 2 * sizeof(uint64_t) +
+           std::size_t((m_stream.bits() + 7) / 8) +
+           std::size_t(m_pending) * sizeof(uint64_t);
+  }
+
+  // Returns false when Unit does not match or the chunk is sealed
+  template <typename Unit> bool append(const Unit &sample) {
+    if (m_sealed || DescribeUnit<Unit>::get() != m_desc)
+      return false;
+    append_bits(to_bits(raw_value(sample)));
+    return true;
+  }
+
+  // Decodes all values into out, which must hold size() elements; returns
+  // zero when Unit does not match the unit the chunk was written with
+  template <typename Unit> std::size_t decode(Unit *out) const {
+    if (DescribeUnit<Unit>::get() != m_desc)
+      return 0;
+    if (m_desc.kind == UnitDescriptor::Floating)
+      decode_xor(out);
+    else
+      decode_delta(out);
+    return size();
+  }
+
+  // Sealed copy in a flat buffer of 64-bit words and back
+  std::vector<uint64_t> serialize() const {
+    TimeSeriesChunk sealed(*this);
+    sealed.flush();
+    std::vector<uint64_t> out(header_words());
+    std::memcpy(out.data(), &m_desc, sizeof(UnitDescriptor));
+    out[header_words() - 2] = m_count;
+    out[header_words() - 1] = sealed.m_stream.bits();
+    const std::vector<uint64_t> &words = sealed.m_stream.words();
+    out.insert(out.end(), words.begin(), words.end());
+    return out;
+  }
+
+  static bool deserialize(const uint64_t *data, std::size_t count,
+                          TimeSeriesChunk &chunk) {
+    if (count < header_words())
+      return false;
+    UnitDescriptor desc;
+    std::memcpy(&desc, data, sizeof(UnitDescriptor));
+    const uint64_t bits = data[header_words() - 1];
+    if ((bits + 63) / 64 != count - header_words())
+      return false;
+    chunk = TimeSeriesChunk(desc);
+    chunk.m_count = data[header_words() - 2];
+    chunk.m_stream.assign(data + header_words(), count - header_words(), bits);
+    chunk.m_sealed = true;
+    return true;
+  }
+
+private:
+  static std::size_t header_words() {
+    return (sizeof(UnitDescriptor) + 7) / 8 + 2;
+  }
+
+  template <typename V>
+  static typename std::enable_if<std::is_integral<V>::value, uint64_t>::type
+  to_bits(V val) {
+    return uint64_t(val);
+  }
+
+  template <typename V>
+  static typename std::enable_if<std::is_floating_point<V>::value,
+                                 uint64_t>::type
+  to_bits(V val) {
+    typename std::conditional<sizeof(V) == 4, uint32_t, uint64_t>::type bits;
+    std::memcpy(&bits, &val, sizeof(V));
+    return bits;
+  }
+
+  template <typename V>
+  static typename std::enable_if<std::is_integral<V>::value, V>::type
+  from_bits(uint64_t bits) {
+    return V(bits);
+  }
+
+  template <typename V>
+  static typename std::enable_if<std::is_floating_point<V>::value, V>::type
+  from_bits(uint64_t bits) {
+    typename std::conditional<sizeof(V) == 4, uint32_t, uint64_t>::type raw(
+        bits);
+    V val;
+    std::memcpy(&val, &raw, sizeof(V));
+    return val;
+  }
+
+  unsigned value_bits() const { return unsigned(m_desc.size) * 8; }
+
+  void append_bits(uint64_t bits) {
+    if (m_sealed)
+      return;
+    if (m_count == 0) {
+      m_stream.write(bits, value_bits());
+    } else if (m_desc.kind == UnitDescriptor::Floating) {
+      append_xor(bits);
+    } else {
+      const uint64_t delta = bits - m_prev;
+      const int64_t dod = int64_t(delta - m_prevDelta);
+      m_block[m_pending++] = (uint64_t(dod) << 1) ^ uint64_t(dod >> 63);
+      m_prevDelta = delta;
+      if (m_pending == BlockSize)
+        flush();
+    }
+    m_prev = bits;
+    ++m_count;
+  }
+
+  void flush() {
+    if (m_pending == 0)
+      return;
+    uint64_t all = 0;
+    for (unsigned i = 0; i < m_pending; ++i)
+      all |= m_block[i];
+    const unsigned width = 64 - leading_zeros(all);
+    m_stream.write(width, 7);
+    for (unsigned i = 0; i < m_pending; ++i)
+      m_stream.write(m_block[i], width);
+    m_pending = 0;
+  }
+
+  void append_xor(uint64_t bits) {
+    const uint64_t diff = bits ^ m_prev;
+    if (diff == 0) {
+      m_stream.write(0, 1);
+      return;
+    }
+    m_stream.write(1, 1);
+    const unsigned width = value_bits();
+    unsigned leading = leading_zeros(diff) - (64 - width);
+    const unsigned trailing = trailing_zeros(diff);
+    leading = leading > 31 ? 31 : leading;
+    if (m_count > 1 && leading >= m_leading && trailing >= m_trailing) {
+      m_stream.write(0, 1);
+      m_stream.write(diff >> m_trailing, width - m_leading - m_trailing);
+      return;
+    }
+    const unsigned meaningful = width - leading - trailing;
+    m_stream.write(1, 1);
+    m_stream.write(leading, 5);
+    m_stream.write(meaningful - 1, 6);
+    m_stream.write(diff >> trailing, meaningful);
+    m_leading = leading;
+    m_trailing = trailing;
+  }
+
+  template <typename Unit> void decode_delta(Unit *out) const {
+    using V = decltype(raw_value(Unit()));
+    if (m_count == 0)
+      return;
+    uint64_t pos = 0;
+    uint64_t value = m_stream.read(pos, value_bits());
+    if (m_desc.kind == UnitDescriptor::Signed && value_bits() < 64)
+      value = uint64_t(int64_t(value << (64 - value_bits())) >>
+                       (64 - value_bits()));
+    out[0] = Unit(from_bits<V>(value));
+    uint64_t delta = 0;
+    std::size_t idx = 1;
+    uint64_t zigzag[BlockSize];
+    const std::size_t total = std::size_t(m_count);
+    const std::size_t packed = total - 1 - m_pending;
+    while (idx < total) {
+      unsigned len;
+      const uint64_t *block;
+      if (idx - 1 < packed) {
+        const unsigned width = unsigned(m_stream.read(pos, 7));
+        const std::size_t left = packed - (idx - 1);
+        len = left < std::size_t(BlockSize) ? unsigned(left) : BlockSize;
+        for (unsigned i = 0; i < len; ++i)
+          zigzag[i] = m_stream.read(pos, width);
+        block = zigzag;
+      } else {
+        len = m_pending;
+        block = m_block;
+      }
+      for (unsigned i = 0; i < len; ++i) {
+        const uint64_t dod = (block[i] >> 1) ^ (~(block[i] & 1) + 1);
+        delta += dod;
+        value += delta;
+        out[idx++] = Unit(from_bits<V>(value));
+      }
+    }
+  }
+
+  template <typename Unit> void decode_xor(Unit *out) const {
+    using V = decltype(raw_value(Unit()));
+    if (m_count == 0)
+      return;
+    const unsigned width = value_bits();
+    uint64_t pos = 0;
+    uint64_t value = m_stream.read(pos, width);
+    out[0] = Unit(from_bits<V>(value));
+    unsigned leading = 0, trailing = 0;
+    for (std::size_t i = 1; i < m_count; ++i) {
+      if (m_stream.read(pos, 1)) {
+        if (m_stream.read(pos, 1)) {
+          leading = unsigned(m_stream.read(pos, 5));
+          const unsigned meaningful = unsigned(m_stream.read(pos, 6)) + 1;
+          trailing = width - leading - meaningful;
+        }
+        value ^= m_stream.read(pos, width - leading - trailing) << trailing;
+      }
+      out[i] = Unit(from_bits<V>(value));
+    }
+  }
+
+  UnitDescriptor m_desc;
+  uint64_t m_count;
+  BitStream m_stream;
+  uint64_t m_prev;
+  uint64_t m_prevDelta;
+  unsigned m_leading;
+  unsigned m_trailing;
+  unsigned m_pending;
+  bool m_sealed;
+  uint64_t m_block[BlockSize];
+};
+
+// Chunked, append-only series of one unit type
+
+template <typename Unit> class TimeSeries {
+public:
+  explicit TimeSeries(std::size_t chunkSize = 4096) : m_chunkSize(chunkSize) {}
+
+  void append(const Unit &sample) {
+    if (m_chunks.empty() || m_chunks.back().size() >= m_chunkSize)
+      m_chunks.push_back(TimeSeriesChunk(DescribeUnit<Unit>::get()));
+    m_chunks.back().append(sample);
+  }
+
+  template <typename It> void append(It first, It last) {
+    for (; first != last; ++first)
+      append(*first);
+  }
+
+  std::size_t size() const {
+    std::size_t total = 0;
+    for (const TimeSeriesChunk &chunk : m_chunks)
+      total += chunk.size();
+    return total;
+  }
+
+  std::size_t bytes() const {
+    std::size_t total = 0;
+    for (const TimeSeriesChunk &chunk : m_chunks)
+      total += chunk.bytes();
+    return total;
+  }
+
+  const std::vector<TimeSeriesChunk> &chunks() const { return m_chunks; }
+
+  // Decodes everything into out, which must hold size() elements
+  std::size_t decode(Unit *out) const {
+    std::size_t total = 0;
+    for (const TimeSeriesChunk &chunk : m_chunks)
+      total += chunk.decode(out + total);
+    return total;
+  }
+
+private:
+  std::size_t m_chunkSize;
+  std::vector<TimeSeriesChunk> m_chunks;
+};
+
+}; // namespace units
@@ -0,0 +1,340 @@
+/*
+Copyright 2024 Nikola Jelic <nikola.jelic83@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the “Software”), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "phys_chrono.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+// Define PHYS_UNITS_NO_TSC to read std::chrono::steady_clock instead of the
+// CPU cycle counter
+#if !defined(PHYS_UNITS_NO_TSC) && (defined(__x86_64__) || defined(__i386__))
+#define PHYS_UNITS_TICK_TSC 1
+#include <x86intrin.h>
+#elif !defined(PHYS_UNITS_NO_TSC) && defined(__aarch64__)
+#define PHYS_UNITS_TICK_CNTVCT 1
+#endif
+
+namespace units {
+
+using NanoSeconds = PhysicalUnit<int64_t, std::nano, std::ratio<0>,
+                                 std::ratio<0>, std::ratio<1>>;
+
+// Cheapest monotonic tick source available, calibrated against steady_clock
+
+class TickClock {
+public:
+  using Ticks = uint64_t;
+
+  static Ticks now() {
+#if defined(PHYS_UNITS_TICK_TSC)
+    return __rdtsc();
+#elif defined(PHYS_UNITS_TICK_CNTVCT)
+    uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return Ticks(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now().time_since_epoch())
+                     .count());
+#endif
+  }
+
+  // A stop read before the start, e.g. on another core whose counter lags,
+  // counts as no time rather than wrapping around
+  static NanoSeconds elapsed(Ticks start, Ticks stop) {
+    const int64_t ticks = int64_t(stop - start);
+    return NanoSeconds(ticks > 0 ? int64_t(double(ticks) * ns_per_tick()) : 0);
+  }
+
+  static double ns_per_tick() {
+    static const double value = calibrate();
+    return value;
+  }
+
+private:
+  static double calibrate() {
+#if defined(PHYS_UNITS_TICK_TSC)
+    using namespace std::chrono;
+    const steady_clock::time_point begin = steady_clock::now();
+    const Ticks first = now();
+    steady_clock::time_point end;
+    do {
+      end = steady_clock::now();
+    } while (end - begin < milliseconds(10));
+    const Ticks last = now();
+    return double(duration_cast<nanoseconds>(end - begin).count()) /
+           double(last - first);
+#elif defined(PHYS_UNITS_TICK_CNTVCT)
+    uint64_t frequency;
+    asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+    return 1e9 / double(frequency);
+#else
+    return 1.;
+#endif
+  }
+};
+
+// Start/stop probe
+
+class TimingProbe {
+public:
+  TimingProbe() : m_start(0) {}
+  void start() { m_start = TickClock::now(); }
+  NanoSeconds stop() const {
+    return TickClock::elapsed(m_start, TickClock::now());
+  }
+
+private:
+  TickClock::Ticks m_start;
+};
+
+// Records the lifetime of the scope into any sink with record(NanoSeconds)
+
+template <typename Sink> class ScopedTimer {
+public:
+  explicit ScopedTimer(Sink &sink) : m_sink(sink), m_start(TickClock::now()) {}
+  ScopedTimer(const ScopedTimer &) = delete;
+  ScopedTimer &operator=(const ScopedTimer &) = delete;
+  ~ScopedTimer() {
+    m_sink.record(TickClock::elapsed(m_start, TickClock::now()));
+  }
+
+private:
+  Sink &m_sink;
+  TickClock::Ticks m_start;
+};
+
+template <int Slots> class ThreadLatencyHistograms;
+
+// Power of two buckets: bucket b holds durations in [2^(b-1), 2^b) ns
+
+class LatencyHistogram {
+public:
+  static const int Buckets = 64;
+
+  LatencyHistogram() { reset(); }
+
+  static int bucket(int64_t ns) {
+    if (ns <= 0)
+      return 0;
+#if defined(__GNUC__)
+    return 64 - __builtin_clzll(uint64_t(ns));
+#else
+    int result = 0;
+    for (uint64_t v = uint64_t(ns); v; v >>= 1)
+      ++result;
+    return result;
+#endif
+  }
+
+  static NanoSeconds bucket_limit(int b) {
+    return NanoSeconds(int64_t((uint64_t(1) << b) - 1));
+  }
+
+  void record(const NanoSeconds &duration) {
+    const int64_t ns = duration.value();
+    ++m_buckets[bucket(ns)];
+    ++m_count;
+    m_sum += ns;
+    m_min = ns < m_min ? ns : m_min;
+    m_max = ns > m_max ? ns : m_max;
+  }
+
+  void merge(const LatencyHistogram &other) {
+    for (int b = 0; b < Buckets; ++b)
+      m_buckets[b] += other.m_buckets[b];
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+    m_min = other.m_min < m_min ? other.m_min : m_min;
+    m_max = other.m_max > m_max ? other.m_max : m_max;
+  }
+
+  void reset() {
+    for (int b = 0; b < Buckets; ++b)
+      m_buckets[b] = 0;
+    m_count = 0;
+    m_sum = 0;
+    m_min = std::numeric_limits<int64_t>::max();
+    m_max = std::numeric_limits<int64_t>::min();
+  }
+
+  uint64_t count() const { return m_count; }
+  uint64_t bucket_count(int b) const { return m_buckets[b]; }
+  NanoSeconds min() const { return NanoSeconds(m_count ? m_min : 0); }
+  NanoSeconds max() const { return NanoSeconds(m_count ? m_max : 0); }
+  NanoSeconds mean() const {
+    return NanoSeconds(m_count ? m_sum / int64_t(m_count) : 0);
+  }
+
+  // Upper limit of the bucket holding the given fraction of the samples
+  NanoSeconds percentile(double fraction) const {
+    if (m_count == 0)
+      return NanoSeconds(0);
+    uint64_t rank = uint64_t(std::ceil(fraction * double(m_count)));
+    rank = rank == 0 ? 1 : rank;
+    uint64_t seen = 0;
+    for (int b = 0; b < Buckets; ++b) {
+      seen += m_buckets[b];
+      if (seen >= rank) {
+        const int64_t limit = bucket_limit(b).value();
+        return NanoSeconds(limit < m_max ? limit : m_max);
+      }
+    }
+    return max();
+  }
+
+private:
+  template <int Slots> friend class ThreadLatencyHistograms;
+
+  uint64_t m_buckets[Buckets];
+  uint64_t m_count;
+  int64_t m_sum;
+  int64_t m_min;
+  int64_t m_max;
+};
+
+// Small index of the calling thread for picking a shard. A thread takes the
+// lowest free slot on its first call and gives it back when it exits, so the
+// slots stay below the number of threads alive at once.
+
+class ThreadSlot {
+public:
+  ThreadSlot() {
+    Pool &pool = shared_pool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    if (pool.free.empty()) {
+      m_slot = pool.next++;
+    } else {
+      std::pop_heap(pool.free.begin(), pool.free.end(),
+                    std::greater<unsigned>());
+      m_slot = pool.free.back();
+      pool.free.pop_back();
+    }
+  }
+  ThreadSlot(const ThreadSlot &) = delete;
+  ThreadSlot &operator=(const ThreadSlot &) = delete;
+
+  ~ThreadSlot() {
+    Pool &pool = shared_pool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    pool.free.push_back(m_slot);
+    std::push_heap(pool.free.begin(), pool.free.end(),
+                   std::greater<unsigned>());
+  }
+
+  unsigned value() const { return m_slot; }
+
+private:
+  struct Pool {
+    std::mutex mutex;
+    std::vector<unsigned> free;
+    unsigned next = 0;
+  };
+
+  static Pool &shared_pool() {
+    static Pool pool;
+    return pool;
+  }
+
+  unsigned m_slot;
+};
+
+inline unsigned thread_slot() {
+  thread_local ThreadSlot slot;
+  return slot.value();
+}
+
+// Per-thread histogram shards, each on its own cache lines, merged on demand
+
+template <int Slots = 64> class ThreadLatencyHistograms {
+public:
+  ThreadLatencyHistograms() { reset(); }
+  ThreadLatencyHistograms(const ThreadLatencyHistograms &) = delete;
+  ThreadLatencyHistograms &operator=(const ThreadLatencyHistograms &) = delete;
+
+  void record(const NanoSeconds &duration) {
+    const int64_t ns = duration.value();
+    Shard &shard = m_shards[thread_slot() % Slots];
+    shard.buckets[LatencyHistogram::bucket(ns)].fetch_add(
+        1, std::memory_order_relaxed);
+    shard.count.fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(ns, std::memory_order_relaxed);
+    int64_t seen = shard.min.load(std::memory_order_relaxed);
+    while (ns < seen && !shard.min.compare_exchange_weak(
+                            seen, ns, std::memory_order_relaxed)) {
+    }
+    seen = shard.max.load(std::memory_order_relaxed);
+    while (ns > seen && !shard.max.compare_exchange_weak(
+                            seen, ns, std::memory_order_relaxed)) {
+    }
+  }
+
+  LatencyHistogram snapshot() const {
+    LatencyHistogram result;
+    for (int s = 0; s < Slots; ++s) {
+      const Shard &shard = m_shards[s];
+      LatencyHistogram part;
+      for (int b = 0; b < LatencyHistogram::Buckets; ++b)
+        part.m_buckets[b] = shard.buckets[b].load(std::memory_order_relaxed);
+      part.m_count = shard.count.load(std::memory_order_relaxed);
+      part.m_sum = shard.sum.load(std::memory_order_relaxed);
+      part.m_min = shard.min.load(std::memory_order_relaxed);
+      part.m_max = shard.max.load(std::memory_order_relaxed);
+      result.merge(part);
+    }
+    return result;
+  }
+
+  void reset() {
+    for (int s = 0; s < Slots; ++s) {
+      Shard &shard = m_shards[s];
+      for (int b = 0; b < LatencyHistogram::Buckets; ++b)
+        shard.buckets[b].store(0, std::memory_order_relaxed);
+      shard.count.store(0, std::memory_order_relaxed);
+      shard.sum.store(0, std::memory_order_relaxed);
+      shard.min.store(std::numeric_limits<int64_t>::max(),
+                      std::memory_order_relaxed);
+      shard.max.store(std::numeric_limits<int64_t>::min(),
+                      std::memory_order_relaxed);
+    }
+  }
+
+private:
+  struct alignas(64) Shard {
+    std::atomic<uint64_t> buckets[LatencyHistogram::Buckets];
+    std::atomic<uint64_t> count;
+    std::atomic<int64_t> sum;
+    std::atomic<int64_t> min;
+    std::atomic<int64_t> max;
+  };
+
+  Shard m_shards[Slots];
+};
+
+}; // namespace units
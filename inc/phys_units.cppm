@@ -0,0 +1,87 @@
+/*
+Copyright 2024 Nikola Jelic <nikola.jelic83@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the “Software”), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// C++20 module interface: import phys_units; instead of the includes.
+// The standard headers are parsed once here, in the global module fragment,
+// and the library headers are exported with C++ language linkage so the
+// module and the headers can be mixed in one program.
+
+module;
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ratio>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if !defined(PHYS_UNITS_NO_TSC) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#endif
+
+export module phys_units;
+
+export extern "C++" {
+#include "phys_units.hpp"
+#include "phys_angle.hpp"
+#include "phys_math.hpp"
+#include "phys_string.hpp"
+#include "phys_si.hpp"
+#include "phys_dim.hpp"
+#include "phys_chrono.hpp"
+#include "phys_stats.hpp"
+#include "phys_timing.hpp"
+#include "phys_lookup.hpp"
+#include "phys_calculus.hpp"
+#include "phys_vector.hpp"
+#include "phys_timeseries.hpp"
+#include "phys_algorithm.hpp"
+#include "phys_ring.hpp"
+#include "phys_filter.hpp"
+#include "phys_field.hpp"
+#include "phys_record.hpp"
+#include "phys_span.hpp"
+#include "phys_fixed.hpp"
+#include "phys_metrics.hpp"
+#include "phys_pipeline.hpp"
+#include "phys_fastmath.hpp"
+#include "phys_geodesy.hpp"
+#include "phys_circular.hpp"
+#include "phys_random.hpp"
+#include "phys_histogram.hpp"
+}
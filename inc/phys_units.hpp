@@ -22,10 +22,83 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #pragma once
 
 #include <cmath>
+#include <cstddef>
 #include <ratio>
+#include <type_traits>
 
 namespace units {
 
+template <typename T> struct ResultingType {
+  using type = typename std::conditional<std::is_floating_point<T>::value, T,
+                                         double>::type;
+};
+
+// Holding types with their own rescaling, e.g. fixed point, provide a
+// nested Rescale<Ratio, Bias>::apply used instead of the arithmetic below
+
+template <typename T, typename Enable = void>
+struct HasRescale : std::false_type {};
+
+template <typename T>
+struct HasRescale<
+    T, typename std::conditional<
+           false, typename T::template Rescale<std::ratio<1>, std::ratio<0>>,
+           void>::type> : std::true_type {};
+
+// Conversion between two scales of the same dimension, with the ratio and
+// the offset folded into a single constant scale and bias in the compile time
+// Floating point values take one multiply-add. Integral values keep the exact
+// truncating arithmetic, where the constant division is lowered to a
+// multiply and shift by the compiler.
+
+template <typename FromFactor, typename FromOffset, typename ToFactor,
+          typename ToOffset>
+struct AbsoluteRescale {
+  using Ratio = std::ratio_divide<FromFactor, ToFactor>;
+  using Bias =
+      std::ratio_divide<std::ratio_subtract<FromOffset, ToOffset>, ToFactor>;
+
+  template <typename To, typename From>
+  static constexpr typename std::enable_if<
+      std::is_floating_point<decltype(From() * To())>::value &&
+          !HasRescale<To>::value,
+      To>::type
+  apply(From value) {
+    using Tmp = decltype(value * To());
+    return Bias::num == 0
+               ? To(Tmp(value) * (Tmp(Ratio::num) / Tmp(Ratio::den)))
+               : To(Tmp(value) * (Tmp(Ratio::num) / Tmp(Ratio::den)) +
+                    Tmp(Bias::num) / Tmp(Bias::den));
+  }
+
+  template <typename To, typename From>
+  static constexpr typename std::enable_if<
+      !std::is_floating_point<decltype(From() * To())>::value &&
+          !HasRescale<To>::value,
+      To>::type
+  apply(From value) {
+    using Tmp = decltype(value * To());
+    return Bias::num == 0 ? To(Tmp(value) * Ratio::num / Ratio::den)
+                          : To(Tmp(value) * Ratio::num / Ratio::den +
+                               Tmp(Bias::num) / Bias::den);
+  }
+
+  template <typename To, typename From>
+  static constexpr typename std::enable_if<HasRescale<To>::value, To>::type
+  apply(From value) {
+    return To::template Rescale<Ratio, Bias>::apply(To(value));
+  }
+};
+
+template <typename FromFactor, typename ToFactor>
+using UnitRescale =
+    AbsoluteRescale<FromFactor, std::ratio<0>, ToFactor, std::ratio<0>>;
+
+// Tag of the constructors leaving the value unset, for buffers that are
+// written before they are read, e.g. Meter m{units::Uninitialized{}}. The
+// default constructors keep setting zero.
+struct Uninitialized {};
+
 template <typename ValType, typename Factor = std::ratio<1>,
           typename LenDim = std::ratio<0>, typename MassDim = std::ratio<0>,
           typename TimeDim = std::ratio<0>, typename ElcurDim = std::ratio<0>,
@@ -37,15 +110,14 @@ public:
   using ConvFactor = Factor;
   constexpr explicit PhysicalUnit(ValType initialValue)
       : m_value(initialValue) {}
-  PhysicalUnit() : m_value(0) {}
+  constexpr PhysicalUnit() : m_value(0) {}
+  explicit PhysicalUnit(Uninitialized) {}
   template <typename V, typename F>
   /* converting constructor */
   constexpr explicit PhysicalUnit(
       const PhysicalUnit<V, F, LenDim, MassDim, TimeDim, ElcurDim, TempDim,
-                         AmmDim, LumDim, AngleDim> &val) {
-    using outRatio = std::ratio_divide<F, Factor>;
-    m_value = decltype(val.value() * m_value)(val.value()) * outRatio::num /
-              outRatio::den;
+                         AmmDim, LumDim, AngleDim> &val)
+      : m_value(UnitRescale<F, Factor>::template apply<ValType>(val.value())) {
   }
 
   template <typename V>
@@ -103,6 +175,7 @@ public:
   constexpr explicit PhysicalUnit(ValType initialValue)
       : m_value(initialValue) {}
   constexpr PhysicalUnit() : m_value(0) {}
+  explicit PhysicalUnit(Uninitialized) {}
   constexpr operator ValType() const {
     return m_value * Factor::num / Factor::den;
   }
@@ -239,26 +312,24 @@ template <typename ValType, typename Factor = std::ratio<1>,
 class AbsolutePhysicalUnit {
 public:
   using ValueType = ValType;
+  using ConvFactor = Factor;
+  using ConvOffset = Offset;
   using DiffPhysicalUnit =
       PhysicalUnit<DiffType, Factor, LenDim, MassDim, TimeDim, ElcurDim,
                    TempDim, AmmDim, LumDim>;
   constexpr explicit AbsolutePhysicalUnit(ValType initialValue)
       : m_value(initialValue) {}
   constexpr AbsolutePhysicalUnit() : m_value(0) {}
+  explicit AbsolutePhysicalUnit(Uninitialized) {}
 
-  constexpr AbsolutePhysicalUnit(const AbsolutePhysicalUnit &val)
-      : m_value(val.value()) {}
+  constexpr AbsolutePhysicalUnit(const AbsolutePhysicalUnit &val) = default;
 
   template <typename V, typename F, typename D, typename O>
-  explicit AbsolutePhysicalUnit(
+  constexpr explicit AbsolutePhysicalUnit(
       const AbsolutePhysicalUnit<V, F, D, O, LenDim, MassDim, TimeDim, ElcurDim,
-                                 TempDim, AmmDim, LumDim> &val) {
-    using outRatio = std::ratio_divide<F, Factor>;
-    using outOffset = std::ratio_divide<std::ratio_subtract<O, Offset>, Factor>;
-    using tmpType = decltype(val.value() * m_value);
-    m_value = tmpType(val.value()) * outRatio::num / outRatio::den +
-              tmpType(outOffset::num) / outOffset::den;
-  }
+                                 TempDim, AmmDim, LumDim> &val)
+      : m_value(AbsoluteRescale<F, O, Factor, Offset>::template apply<ValType>(
+            val.value())) {}
 
   template <typename V>
   AbsolutePhysicalUnit const &
@@ -304,17 +375,27 @@ public:
   constexpr ValType value() const { return m_value; }
 
 protected:
-  virtual void setValue(const ValType &val) { m_value = val; }
+  // Not virtual, which keeps the class trivially copyable and as large as
+  // ValType
+  void setValue(const ValType &val) { m_value = val; }
 
 private:
   ValType m_value;
 };
 
 template <typename ToType, typename... Ts>
-ToType unit_cast(const AbsolutePhysicalUnit<Ts...> &fromType) {
+constexpr ToType unit_cast(const AbsolutePhysicalUnit<Ts...> &fromType) {
   return ToType(fromType);
 }
 
+// Batch conversion, e.g. a whole buffer of readings from one scale to another
+
+template <typename ToType, typename FromType>
+void unit_cast_n(const FromType *in, std::size_t count, ToType *out) {
+  for (std::size_t i = 0; i < count; ++i)
+    out[i] = ToType(in[i]);
+}
+
 template <typename... Ts>
 inline constexpr bool operator==(const AbsolutePhysicalUnit<Ts...> &lhs,
                                  const AbsolutePhysicalUnit<Ts...> &rhs) {
@@ -351,6 +432,68 @@ inline constexpr bool operator>(const AbsolutePhysicalUnit<Ts...> &lhs,
   return lhs.value() > rhs.value();
 }
 
+// Type helpers for the generic algorithms over both unit classes
+
+template <typename Unit, typename V> struct RebindValueType {};
+
+template <typename V, typename OldV, typename... Ts>
+struct RebindValueType<PhysicalUnit<OldV, Ts...>, V> {
+  using type = PhysicalUnit<V, Ts...>;
+};
+
+template <typename V, typename OldV, typename F, typename D, typename... Ts>
+struct RebindValueType<AbsolutePhysicalUnit<OldV, F, D, Ts...>, V> {
+  using type = AbsolutePhysicalUnit<V, F, V, Ts...>;
+};
+
+template <typename T>
+constexpr typename std::enable_if<std::is_arithmetic<T>::value, T>::type
+raw_value(const T &val) {
+  return val;
+}
+
+template <typename T>
+constexpr typename T::ValueType raw_value(const T &val) {
+  return val.value();
+}
+
+template <typename Unit> struct DiffUnitType {
+  using type = Unit;
+};
+
+template <typename... Ts> struct DiffUnitType<AbsolutePhysicalUnit<Ts...>> {
+  using type = typename AbsolutePhysicalUnit<Ts...>::DiffPhysicalUnit;
+};
+
+// The eight dimension exponents of a unit class, reduced so that equal
+// exponents give the same type; arithmetic types have none
+
+template <typename... Exponents> struct DimensionList {};
+
+template <typename Unit> struct UnitDimension {};
+
+template <typename V, typename F, typename... Dims>
+struct UnitDimension<PhysicalUnit<V, F, Dims...>> {
+  using type = DimensionList<typename Dims::type...>;
+};
+
+template <typename V, typename F, typename D, typename O, typename... Dims>
+struct UnitDimension<AbsolutePhysicalUnit<V, F, D, O, Dims...>> {
+  using type = DimensionList<typename Dims::type..., std::ratio<0>>;
+};
+
+// Whether two unit classes measure the same dimension, whatever their scale,
+// value type or offset
+template <typename From, typename To, typename = void>
+struct SameDimension : std::false_type {};
+
+template <typename From, typename To>
+struct SameDimension<
+    From, To,
+    typename std::enable_if<std::is_same<
+        typename UnitDimension<From>::type,
+        typename UnitDimension<To>::type>::value>::type> : std::true_type {};
+
 template <typename... Ts>
 constexpr AbsolutePhysicalUnit<Ts...>
 operator+(const typename AbsolutePhysicalUnit<Ts...>::DiffUnitType &lhs,
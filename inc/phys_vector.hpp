@@ -0,0 +1,312 @@
+/*
+Copyright 2024 Nikola Jelic <nikola.jelic83@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the “Software”), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "phys_angle.hpp"
+#include "phys_math.hpp"
+#include "phys_units.hpp"
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace units {
+
+// Three component quantity; the components can be units or plain numbers
+
+template <typename Unit> class Vec3 {
+public:
+  using UnitType = Unit;
+  constexpr Vec3() : m_x(), m_y(), m_z() {}
+  constexpr Vec3(const Unit &x, const Unit &y, const Unit &z)
+      : m_x(x), m_y(y), m_z(z) {}
+  template <typename Other>
+  constexpr explicit Vec3(const Vec3<Other> &val)
+      : m_x(Unit(val.x())), m_y(Unit(val.y())), m_z(Unit(val.z())) {}
+
+  constexpr Unit x() const { return m_x; }
+  constexpr Unit y() const { return m_y; }
+  constexpr Unit z() const { return m_z; }
+
+  Vec3 const &operator+=(const Vec3 &rhs) {
+    m_x += rhs.m_x;
+    m_y += rhs.m_y;
+    m_z += rhs.m_z;
+    return *this;
+  }
+
+  Vec3 const &operator-=(const Vec3 &rhs) {
+    m_x -= rhs.m_x;
+    m_y -= rhs.m_y;
+    m_z -= rhs.m_z;
+    return *this;
+  }
+
+  constexpr Vec3 operator-() const { return Vec3(-m_x, -m_y, -m_z); }
+
+private:
+  Unit m_x;
+  Unit m_y;
+  Unit m_z;
+};
+
+template <typename U1, typename U2>
+constexpr bool operator==(const Vec3<U1> &lhs, const Vec3<U2> &rhs) {
+  return lhs.x() == rhs.x() && lhs.y() == rhs.y() && lhs.z() == rhs.z();
+}
+
+template <typename U1, typename U2>
+constexpr bool operator!=(const Vec3<U1> &lhs, const Vec3<U2> &rhs) {
+  return !(lhs == rhs);
+}
+
+template <typename U1, typename U2>
+constexpr auto operator+(const Vec3<U1> &lhs, const Vec3<U2> &rhs)
+    -> Vec3<decltype(lhs.x() + rhs.x())> {
+  return Vec3<decltype(lhs.x() + rhs.x())>(
+      lhs.x() + rhs.x(), lhs.y() + rhs.y(), lhs.z() + rhs.z());
+}
+
+template <typename U1, typename U2>
+constexpr auto operator-(const Vec3<U1> &lhs, const Vec3<U2> &rhs)
+    -> Vec3<decltype(lhs.x() - rhs.x())> {
+  return Vec3<decltype(lhs.x() - rhs.x())>(
+      lhs.x() - rhs.x(), lhs.y() - rhs.y(), lhs.z() - rhs.z());
+}
+
+template <typename S, typename U>
+constexpr auto operator*(const S &lhs, const Vec3<U> &rhs)
+    -> Vec3<decltype(lhs * rhs.x())> {
+  return Vec3<decltype(lhs * rhs.x())>(lhs * rhs.x(), lhs * rhs.y(),
+                                       lhs * rhs.z());
+}
+
+template <typename U, typename S>
+constexpr auto operator*(const Vec3<U> &lhs, const S &rhs)
+    -> Vec3<decltype(lhs.x() * rhs)> {
+  return Vec3<decltype(lhs.x() * rhs)>(lhs.x() * rhs, lhs.y() * rhs,
+                                       lhs.z() * rhs);
+}
+
+template <typename U, typename S>
+constexpr auto operator/(const Vec3<U> &lhs, const S &rhs)
+    -> Vec3<decltype(lhs.x() / rhs)> {
+  return Vec3<decltype(lhs.x() / rhs)>(lhs.x() / rhs, lhs.y() / rhs,
+                                       lhs.z() / rhs);
+}
+
+template <typename U1, typename U2>
+constexpr auto dot(const Vec3<U1> &lhs, const Vec3<U2> &rhs)
+    -> decltype(lhs.x() * rhs.x()) {
+  return lhs.x() * rhs.x() + lhs.y() * rhs.y() + lhs.z() * rhs.z();
+}
+
+template <typename U1, typename U2>
+constexpr auto cross(const Vec3<U1> &lhs, const Vec3<U2> &rhs)
+    -> Vec3<decltype(lhs.x() * rhs.x())> {
+  return Vec3<decltype(lhs.x() * rhs.x())>(
+      lhs.y() * rhs.z() - lhs.z() * rhs.y(),
+      lhs.z() * rhs.x() - lhs.x() * rhs.z(),
+      lhs.x() * rhs.y() - lhs.y() * rhs.x());
+}
+
+template <typename U>
+auto norm(const Vec3<U> &val) -> decltype(std::sqrt(dot(val, val))) {
+  return std::sqrt(dot(val, val));
+}
+
+// Direction of the vector as plain numbers, the unit cancels out
+
+template <typename U>
+Vec3<typename ResultingType<decltype(raw_value(U()))>::type>
+normalized(const Vec3<U> &val) {
+  using R = typename ResultingType<decltype(raw_value(U()))>::type;
+  const R length = R(raw_value(norm(val)));
+  return Vec3<R>(R(raw_value(val.x())) / length, R(raw_value(val.y())) / length,
+                 R(raw_value(val.z())) / length);
+}
+
+// Rotation matrix around a unit axis, for any angle type with sin and cos
+
+template <typename R> class Rotation3 {
+public:
+  template <typename Angle>
+  Rotation3(const Vec3<R> &axis, const Angle &angle) {
+    const R c = R(std::cos(angle)), s = R(std::sin(angle)), t = 1 - c;
+    const R x = axis.x(), y = axis.y(), z = axis.z();
+    m_row[0] = Vec3<R>(t * x * x + c, t * x * y - s * z, t * x * z + s * y);
+    m_row[1] = Vec3<R>(t * x * y + s * z, t * y * y + c, t * y * z - s * x);
+    m_row[2] = Vec3<R>(t * x * z - s * y, t * y * z + s * x, t * z * z + c);
+  }
+
+  const Vec3<R> &row(int i) const { return m_row[i]; }
+
+  template <typename U>
+  auto operator()(const Vec3<U> &val) const -> Vec3<decltype(R() * val.x())> {
+    return Vec3<decltype(R() * val.x())>(
+        dot(m_row[0], val), dot(m_row[1], val), dot(m_row[2], val));
+  }
+
+private:
+  Vec3<R> m_row[3];
+};
+
+template <typename U, typename R, typename Angle>
+auto rotate(const Vec3<U> &val, const Vec3<R> &axis, const Angle &angle)
+    -> Vec3<decltype(R() * val.x())> {
+  return Rotation3<R>(axis, angle)(val);
+}
+
+// Structure of arrays form for large batches; the kernels below work on the
+// holding values with the conversion factors folded into constants
+
+template <typename Unit> class Vec3Array {
+public:
+  using UnitType = Unit;
+  using ValueType = decltype(raw_value(Unit()));
+
+  explicit Vec3Array(std::size_t size = 0) : m_x(size), m_y(size), m_z(size) {}
+
+  std::size_t size() const { return m_x.size(); }
+  void resize(std::size_t size) {
+    m_x.resize(size);
+    m_y.resize(size);
+    m_z.resize(size);
+  }
+
+  Vec3<Unit> get(std::size_t i) const {
+    return Vec3<Unit>(Unit(m_x[i]), Unit(m_y[i]), Unit(m_z[i]));
+  }
+  void set(std::size_t i, const Vec3<Unit> &val) {
+    m_x[i] = raw_value(val.x());
+    m_y[i] = raw_value(val.y());
+    m_z[i] = raw_value(val.z());
+  }
+
+  ValueType *x_data() { return m_x.data(); }
+  ValueType *y_data() { return m_y.data(); }
+  ValueType *z_data() { return m_z.data(); }
+  const ValueType *x_data() const { return m_x.data(); }
+  const ValueType *y_data() const { return m_y.data(); }
+  const ValueType *z_data() const { return m_z.data(); }
+
+private:
+  std::vector<ValueType> m_x;
+  std::vector<ValueType> m_y;
+  std::vector<ValueType> m_z;
+};
+
+template <typename U1, typename U2>
+void dot_n(const Vec3Array<U1> &lhs, const Vec3Array<U2> &rhs,
+           decltype(dot(Vec3<U1>(), Vec3<U2>())) *out) {
+  using Out = decltype(dot(Vec3<U1>(), Vec3<U2>()));
+  const auto *__restrict ax = lhs.x_data();
+  const auto *__restrict ay = lhs.y_data();
+  const auto *__restrict az = lhs.z_data();
+  const auto *__restrict bx = rhs.x_data();
+  const auto *__restrict by = rhs.y_data();
+  const auto *__restrict bz = rhs.z_data();
+  const std::size_t count = lhs.size();
+  for (std::size_t i = 0; i < count; ++i)
+    out[i] = Out(ax[i] * bx[i] + ay[i] * by[i] + az[i] * bz[i]);
+}
+
+template <typename U1, typename U2>
+void cross_n(const Vec3Array<U1> &lhs, const Vec3Array<U2> &rhs,
+             Vec3Array<typename decltype(cross(Vec3<U1>(),
+                                               Vec3<U2>()))::UnitType> &out) {
+  out.resize(lhs.size());
+  const auto *__restrict ax = lhs.x_data();
+  const auto *__restrict ay = lhs.y_data();
+  const auto *__restrict az = lhs.z_data();
+  const auto *__restrict bx = rhs.x_data();
+  const auto *__restrict by = rhs.y_data();
+  const auto *__restrict bz = rhs.z_data();
+  auto *__restrict cx = out.x_data();
+  auto *__restrict cy = out.y_data();
+  auto *__restrict cz = out.z_data();
+  const std::size_t count = lhs.size();
+  for (std::size_t i = 0; i < count; ++i) {
+    cx[i] = ay[i] * bz[i] - az[i] * by[i];
+    cy[i] = az[i] * bx[i] - ax[i] * bz[i];
+    cz[i] = ax[i] * by[i] - ay[i] * bx[i];
+  }
+}
+
+template <typename U>
+void norm_n(const Vec3Array<U> &val, decltype(norm(Vec3<U>())) *out) {
+  using Out = decltype(norm(Vec3<U>()));
+  using R = decltype(raw_value(Out()));
+  const auto *__restrict x = val.x_data();
+  const auto *__restrict y = val.y_data();
+  const auto *__restrict z = val.z_data();
+  const std::size_t count = val.size();
+  for (std::size_t i = 0; i < count; ++i)
+    out[i] = Out(std::sqrt(R(x[i] * x[i] + y[i] * y[i] + z[i] * z[i])));
+}
+
+// acc += rate * step, e.g. positions from velocities over a time step
+// The scale and the products are floating point, integral accumulators are
+// rounded once when stored.
+
+template <typename U1, typename U2, typename S>
+void multiply_add_n(Vec3Array<U1> &acc, const Vec3Array<U2> &rate,
+                    const S &step) {
+  using V = typename Vec3Array<U1>::ValueType;
+  using R = typename ResultingType<V>::type;
+  using Acc = typename RebindValueType<U1, R>::type;
+  using Rate = typename RebindValueType<U2, R>::type;
+  const R scale = raw_value(Acc(Rate(R(1)) * step));
+  const auto store = [](R sum) {
+    return std::is_integral<V>::value ? V(std::floor(sum + R(0.5))) : V(sum);
+  };
+  auto *__restrict ax = acc.x_data();
+  auto *__restrict ay = acc.y_data();
+  auto *__restrict az = acc.z_data();
+  const auto *__restrict rx = rate.x_data();
+  const auto *__restrict ry = rate.y_data();
+  const auto *__restrict rz = rate.z_data();
+  const std::size_t count = acc.size();
+  for (std::size_t i = 0; i < count; ++i) {
+    ax[i] = store(R(ax[i]) + R(rx[i]) * scale);
+    ay[i] = store(R(ay[i]) + R(ry[i]) * scale);
+    az[i] = store(R(az[i]) + R(rz[i]) * scale);
+  }
+}
+
+template <typename U, typename R>
+void rotate_n(Vec3Array<U> &val, const Rotation3<R> &rotation) {
+  const Vec3<R> r0 = rotation.row(0), r1 = rotation.row(1),
+                r2 = rotation.row(2);
+  auto *__restrict x = val.x_data();
+  auto *__restrict y = val.y_data();
+  auto *__restrict z = val.z_data();
+  const std::size_t count = val.size();
+  for (std::size_t i = 0; i < count; ++i) {
+    const R vx = x[i], vy = y[i], vz = z[i];
+    x[i] = r0.x() * vx + r0.y() * vy + r0.z() * vz;
+    y[i] = r1.x() * vx + r1.y() * vy + r1.z() * vz;
+    z[i] = r2.x() * vx + r2.y() * vy + r2.z() * vz;
+  }
+}
+
+}; // namespace units
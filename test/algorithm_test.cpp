@@ -0,0 +1,107 @@
+#include "phys_algorithm.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+using TimeStampMicroSeconds =
+    units::AbsolutePhysicalUnit<int64_t, std::micro, int64_t, std::ratio<0>,
+                                std::ratio<0>, std::ratio<0>, std::ratio<1>>;
+using Meter = units::PhysicalUnit<double, std::ratio<1>, std::ratio<1>>;
+using MilliBar = units::PhysicalUnit<int16_t, std::ratio<100>, std::ratio<-1>,
+                                     std::ratio<1>, std::ratio<-2>>;
+using Gram = units::PhysicalUnit<float, std::milli, std::ratio<0>,
+                                 std::ratio<1>>;
+
+template <typename Unit> bool sorted_like_std(std::vector<Unit> values) {
+  std::vector<Unit> expected = values;
+  std::stable_sort(expected.begin(), expected.end(),
+                   [](const Unit &a, const Unit &b) { return a < b; });
+  units::radix_sort(values.data(), values.size());
+  for (std::size_t i = 0; i < values.size(); ++i)
+    if (std::memcmp(&values[i], &expected[i], sizeof(Unit)) != 0)
+      return false;
+  return true;
+}
+
+TEST(AlgorithmTests, Hash) {
+  std::unordered_set<Meter> distances = {Meter(1.), Meter(2.), Meter(1.)};
+  EXPECT_EQ(distances.size(), 2u);
+  EXPECT_EQ(distances.count(Meter(2.)), 1u);
+  std::unordered_set<TimeStampMicroSeconds> stamps;
+  stamps.insert(TimeStampMicroSeconds(42));
+  EXPECT_EQ(stamps.count(TimeStampMicroSeconds(42)), 1u);
+  EXPECT_EQ(std::hash<TimeStampMicroSeconds>()(TimeStampMicroSeconds(7)),
+            std::hash<int64_t>()(7));
+}
+
+TEST(AlgorithmTests, RadixSortIntegral) {
+  std::mt19937_64 rng(7);
+  std::vector<TimeStampMicroSeconds> stamps;
+  const int64_t start = 1704067200000000;
+  for (int i = 0; i < 10000; ++i)
+    stamps.push_back(
+        TimeStampMicroSeconds(start + int64_t(rng() % 3600000000)));
+  EXPECT_TRUE(sorted_like_std(stamps));
+
+  std::vector<MilliBar> pressures;
+  for (int i = 0; i < 5000; ++i)
+    pressures.push_back(MilliBar(int16_t(rng())));
+  pressures.push_back(MilliBar(std::numeric_limits<int16_t>::min()));
+  pressures.push_back(MilliBar(std::numeric_limits<int16_t>::max()));
+  EXPECT_TRUE(sorted_like_std(pressures));
+
+  std::vector<MilliBar> same(100, MilliBar(5));
+  EXPECT_TRUE(sorted_like_std(same));
+  EXPECT_TRUE(sorted_like_std(std::vector<MilliBar>()));
+}
+
+TEST(AlgorithmTests, RadixSortFloating) {
+  std::mt19937_64 rng(11);
+  std::normal_distribution<double> normal(0., 1000.);
+  std::vector<Meter> distances;
+  for (int i = 0; i < 10000; ++i)
+    distances.push_back(Meter(normal(rng)));
+  distances.push_back(Meter(std::numeric_limits<double>::infinity()));
+  distances.push_back(Meter(-std::numeric_limits<double>::infinity()));
+  distances.push_back(Meter(std::numeric_limits<double>::denorm_min()));
+  distances.push_back(Meter(0.));
+  EXPECT_TRUE(sorted_like_std(distances));
+
+  std::vector<Gram> masses;
+  for (int i = 0; i < 1000; ++i)
+    masses.push_back(Gram(float(normal(rng))));
+  EXPECT_TRUE(sorted_like_std(masses));
+
+  Meter zeros[] = {Meter(0.), Meter(-0.), Meter(1.)};
+  units::radix_sort(zeros, 3);
+  EXPECT_TRUE(std::signbit(zeros[0].value()));
+  EXPECT_FALSE(std::signbit(zeros[1].value()));
+}
+
+TEST(AlgorithmTests, LowerBound) {
+  std::mt19937_64 rng(3);
+  for (std::size_t size : {0, 1, 2, 3, 17, 1000}) {
+    std::vector<TimeStampMicroSeconds> sorted;
+    for (std::size_t i = 0; i < size; ++i)
+      sorted.push_back(TimeStampMicroSeconds(int64_t(rng() % 500)));
+    units::radix_sort(sorted.data(), sorted.size());
+    std::vector<TimeStampMicroSeconds> keys;
+    for (int i = 0; i < 100; ++i)
+      keys.push_back(TimeStampMicroSeconds(int64_t(rng() % 520) - 10));
+    std::vector<std::size_t> found(keys.size());
+    units::lower_bound_n(sorted.data(), sorted.size(), keys.data(), keys.size(),
+                         found.data());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+      const std::size_t expected =
+          std::lower_bound(sorted.begin(), sorted.end(), keys[i]) -
+          sorted.begin();
+      EXPECT_EQ(found[i], expected) << "size " << size << " key " << i;
+    }
+  }
+}
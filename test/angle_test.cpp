@@ -139,3 +139,15 @@ TEST(CommonAngleTests, AngleNormalisationNegativeHalfIntervalFloat) {
   shared = units::AbsoluteAngle<double>(-270);
   EXPECT_EQ(shared.value(), 90);
 }
+
+TEST(CommonAngleTests, AbsoluteAngleDifferences) {
+  using Heading = units::AbsoluteAngle<double>;
+  using Turn = units::PhysicalUnitAngle<double, std::ratio<1>>;
+  const Heading north(350), east(80);
+  EXPECT_EQ((east - north).value(), -270);
+  EXPECT_EQ((north + Turn(20)).value(), 10);
+  EXPECT_EQ((east - Turn(90)).value(), 350);
+  EXPECT_TRUE(east < north);
+  EXPECT_EQ(north, Heading(-10));
+  EXPECT_NE(north, east);
+}
@@ -82,6 +82,11 @@ TEST(AbsPhysUnitsTests, BasicOperations) {
   EXPECT_TRUE(ts1 >= ts2);
   TimeStampMilliSeconds tsm = units::unit_cast<TimeStampMilliSeconds>(ts2);
   EXPECT_EQ(tsm.value(), 4856000);
+  static_assert(std::is_trivially_copyable<TimeStampMilliSeconds>::value &&
+                    sizeof(TimeStampMilliSeconds) == sizeof(int64_t),
+                "Timestamps must be as cheap as their holding type");
+  static_assert(!std::is_polymorphic<TimeStampMilliSeconds>::value,
+                "Absolute units have no virtual table");
 }
 
 using TempKelvin =
@@ -125,6 +130,33 @@ TEST(TemperatureTests, ZeroFahrenheit) {
   EXPECT_NEAR(c1.value(), -17.78, 0.01);
 }
 
+TEST(TemperatureTests, CompileTimeConversion) {
+  constexpr TempFahrenheit f(TempCelsius(100.));
+  static_assert(f.value() > 211.99 && f.value() < 212.01,
+                "Conversion must be usable in constant expressions");
+  constexpr CentiMeter cm(Meter(3));
+  static_assert(cm.value() == 300, "Conversion must be constexpr");
+}
+
+TEST(TemperatureTests, BatchConversion) {
+  const TempCelsius celsius[] = {TempCelsius(-40.), TempCelsius(0.),
+                                 TempCelsius(37.), TempCelsius(100.),
+                                 TempCelsius(-273.15)};
+  TempFahrenheit fahrenheit[5];
+  TempKelvin kelvin[5];
+  units::unit_cast_n(celsius, 5, fahrenheit);
+  units::unit_cast_n(fahrenheit, 5, kelvin);
+  const double expected_f[] = {-40., 32., 98.6, 212., -459.67};
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_NEAR(fahrenheit[i].value(), expected_f[i], 0.000001);
+    EXPECT_NEAR(kelvin[i].value(), celsius[i].value() + 273.15, 0.000001);
+  }
+  const TimeStampSeconds seconds[] = {TimeStampSeconds(1), TimeStampSeconds(7)};
+  TimeStampMilliSeconds millis[2];
+  units::unit_cast_n(seconds, 2, millis);
+  EXPECT_EQ(millis[1].value(), 7000);
+}
+
 TEST(ComplexTests, SimpleArithmetics) {
   units::PhysicalUnit<std::complex<double>, std::ratio<1>, std::ratio<0>,
                       std::ratio<0>, std::ratio<0>, std::ratio<1>>
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+namespace bench {
+
+template <typename T> inline void do_not_optimize(const T &value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Runs the body the given number of times and returns nanoseconds per call
+template <typename Body> double ns_per_op(long iterations, Body body) {
+  body();
+  const auto begin = std::chrono::steady_clock::now();
+  for (long i = 0; i < iterations; ++i)
+    body();
+  const auto end = std::chrono::steady_clock::now();
+  return double(std::chrono::duration_cast<std::chrono::nanoseconds>(end -
+                                                                     begin)
+                    .count()) /
+         double(iterations);
+}
+
+inline bool report(const char *name, double value, const char *unit,
+                   double budget) {
+  const bool pass = budget <= 0 || value <= budget;
+  std::printf("%-40s %12.2f %-10s %s\n", name, value, unit,
+              budget <= 0 ? "" : (pass ? "PASS" : "FAIL"));
+  return pass;
+}
+
+}; // namespace bench
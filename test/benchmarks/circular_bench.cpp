@@ -0,0 +1,89 @@
+#include "bench.hpp"
+#include "phys_circular.hpp"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using Heading = units::AbsoluteAngle<double>;
+using Bam = units::AbsoluteAngle<std::int32_t, std::ratio<360, 65536>>;
+
+// Heading smoothing of a fleet per tick, against the usual branching loop
+static const std::size_t vehicles = 100000;
+static const double alpha = 0.2;
+static const double overhead_budget = 1.2;
+
+int main() {
+  bool pass = true;
+  std::vector<Heading> smoothed(vehicles), readings(vehicles);
+  std::vector<Bam> bamSmoothed(vehicles), bamReadings(vehicles);
+  std::uint32_t seed = 12345;
+  for (std::size_t i = 0; i < vehicles; ++i) {
+    seed = seed * 1664525u + 1013904223u;
+    smoothed[i] = Heading((seed >> 8) % 36000 * 0.01);
+    bamSmoothed[i] = Bam(std::int32_t(seed >> 16));
+    seed = seed * 1664525u + 1013904223u;
+    readings[i] = Heading((seed >> 8) % 36000 * 0.01);
+    bamReadings[i] = Bam(std::int32_t(seed >> 16));
+  }
+
+  const double branching = bench::ns_per_op(20, [&]() {
+    for (std::size_t i = 0; i < vehicles; ++i) {
+      double d = readings[i].value() - smoothed[i].value();
+      if (d > 180)
+        d -= 360;
+      else if (d < -180)
+        d += 360;
+      smoothed[i] = Heading(smoothed[i].value() + alpha * d);
+    }
+    bench::do_not_optimize(smoothed[0]);
+  }) / vehicles;
+  bench::report("branching loop, double degrees", branching, "ns/heading", 0);
+
+  const double batch = bench::ns_per_op(20, [&]() {
+    units::interpolate_n(smoothed.data(), readings.data(), vehicles, alpha,
+                         smoothed.data());
+    bench::do_not_optimize(smoothed[0]);
+  }) / vehicles;
+  pass &= bench::report("interpolate_n, double degrees", batch, "ns/heading",
+                        overhead_budget * branching);
+
+  const double bamBranching = bench::ns_per_op(20, [&]() {
+    for (std::size_t i = 0; i < vehicles; ++i) {
+      std::int32_t d = bamReadings[i].value() - bamSmoothed[i].value();
+      if (d >= 32768)
+        d -= 65536;
+      else if (d < -32768)
+        d += 65536;
+      bamSmoothed[i] = Bam(bamSmoothed[i].value() +
+                           std::int32_t(std::lround(alpha * d)));
+    }
+    bench::do_not_optimize(bamSmoothed[0]);
+  }) / vehicles;
+  bench::report("branching loop, binary angles", bamBranching, "ns/heading",
+                0);
+
+  const double bamBatch = bench::ns_per_op(20, [&]() {
+    units::interpolate_n(bamSmoothed.data(), bamReadings.data(), vehicles,
+                         alpha, bamSmoothed.data());
+    bench::do_not_optimize(bamSmoothed[0]);
+  }) / vehicles;
+  pass &= bench::report("interpolate_n, binary angles", bamBatch,
+                        "ns/heading", overhead_budget * bamBranching);
+
+  const double naiveMean = bench::ns_per_op(20, [&]() {
+    double s = 0, c = 0;
+    for (std::size_t i = 0; i < vehicles; ++i) {
+      s += std::sin(readings[i].value() * 0.017453292519943295);
+      c += std::cos(readings[i].value() * 0.017453292519943295);
+    }
+    bench::do_not_optimize(std::atan2(s, c));
+  }) / vehicles;
+  bench::report("std::sin and std::cos mean", naiveMean, "ns/heading", 0);
+
+  const double mean = bench::ns_per_op(20, [&]() {
+    bench::do_not_optimize(units::circular_mean(readings.data(), vehicles));
+  }) / vehicles;
+  pass &= bench::report("circular_mean", mean, "ns/heading", naiveMean);
+
+  return pass ? 0 : 1;
+}
@@ -0,0 +1,81 @@
+#include "bench.hpp"
+#include "phys_field.hpp"
+#include "phys_si.hpp"
+#include <thread>
+#include <vector>
+
+using Pascal = units::si::Pascal<float>;
+using Meter = units::si::Meter<float>;
+using Derivative = units::FieldDerivative<Pascal, Meter>;
+
+// The typed stencil may be at most 20% slower than the hand-written loop
+static const double overhead_budget = 1.2;
+
+template <std::size_t Rank>
+double hand_written(const std::size_t (&extents)[Rank], long iterations) {
+  const std::size_t nx = extents[0], ny = extents[1];
+  const std::size_t nz = Rank == 3 ? extents[2] : 1;
+  const std::ptrdiff_t sy = std::ptrdiff_t(nx + 2);
+  const std::ptrdiff_t sz = sy * std::ptrdiff_t(ny + 2);
+  const std::size_t halo = Rank == 3 ? 1 : 0;
+  std::vector<float> in(std::size_t(sz) * (nz + 2 * halo), 1.f);
+  std::vector<float> out(in.size());
+  const float scale = 1.f / (0.5f * 0.5f);
+  return bench::ns_per_op(iterations, [&]() {
+    for (std::size_t z = halo; z < nz + halo; ++z)
+      for (std::size_t y = 1; y <= ny; ++y) {
+        const float *src = in.data() + std::ptrdiff_t(z) * sz +
+                           std::ptrdiff_t(y) * sy + 1;
+        float *dst = out.data() + (src - in.data());
+        for (std::size_t i = 0; i < nx; ++i) {
+          float sum = src[i - 1] + src[i + 1] + src[i - sy] + src[i + sy] -
+                      float(2 * Rank) * src[i];
+          if (Rank == 3)
+            sum += src[i - sz] + src[i + sz];
+          dst[i] = sum * scale;
+        }
+      }
+    bench::do_not_optimize(out[out.size() / 2]);
+  });
+}
+
+template <std::size_t Rank>
+double typed(const std::size_t (&extents)[Rank], long iterations,
+             unsigned threads) {
+  units::Field<Pascal, Rank> in(extents, Pascal(1.f));
+  units::Field<Derivative::LaplacianUnit, Rank> out(extents);
+  const units::StencilExecutor executor(threads);
+  return bench::ns_per_op(iterations, [&]() {
+    units::laplacian(in, Meter(0.5f), out, executor);
+    bench::do_not_optimize(out.data()[0]);
+  });
+}
+
+int main() {
+  bool pass = true;
+  const unsigned threads = std::thread::hardware_concurrency();
+
+  const std::size_t plane[2] = {2048, 2048};
+  const double cells2 = 2048. * 2048.;
+  double hand = hand_written(plane, 20);
+  bench::report("hand-written 2D Laplacian", hand / cells2, "ns/cell", 0);
+  double ns = typed(plane, 20, 1);
+  pass &= bench::report("Field<Pascal, 2> Laplacian", ns / cells2, "ns/cell",
+                        hand * overhead_budget / cells2);
+  ns = typed(plane, 20, threads);
+  bench::report("Field<Pascal, 2> Laplacian, all threads", ns / cells2,
+                "ns/cell", 0);
+
+  const std::size_t volume[3] = {160, 160, 160};
+  const double cells3 = 160. * 160. * 160.;
+  hand = hand_written(volume, 20);
+  bench::report("hand-written 3D Laplacian", hand / cells3, "ns/cell", 0);
+  ns = typed(volume, 20, 1);
+  pass &= bench::report("Field<Pascal, 3> Laplacian", ns / cells3, "ns/cell",
+                        hand * overhead_budget / cells3);
+  ns = typed(volume, 20, threads);
+  bench::report("Field<Pascal, 3> Laplacian, all threads", ns / cells3,
+                "ns/cell", 0);
+
+  return pass ? 0 : 1;
+}
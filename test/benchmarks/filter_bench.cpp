@@ -0,0 +1,139 @@
+#include "bench.hpp"
+#include "phys_filter.hpp"
+#include <vector>
+
+using Pascal = units::si::Pascal<float>;
+using AdcCounts = units::PhysicalUnit<int16_t, std::ratio<1, 4096>,
+                                      std::ratio<2>, std::ratio<1>,
+                                      std::ratio<-3>, std::ratio<-1>>;
+
+// The typed kernels may be at most 20% slower than the hand-written loops
+static const double overhead_budget = 1.2;
+
+enum : std::size_t { Taps = 32, Samples = 1 << 16, Block = 64 };
+
+// The block loop of FirFilter written over raw arrays: the history and the
+// block share one line, and the outputs of a block are accumulated one tap
+// at a time
+template <typename Acc, typename Coef, typename T, typename Output>
+static void hand_fir(const Coef *coef, T *line, const T *in, std::size_t count,
+                     T *out, Output output) {
+  for (std::size_t at = 0; at < count; at += Block) {
+    const std::size_t n = count - at < Block ? count - at : Block;
+    for (std::size_t j = 0; j < n; ++j)
+      line[Taps - 1 + j] = in[at + j];
+    Acc acc[Block] = {};
+    for (std::size_t k = 0; k < Taps; ++k) {
+      const Acc c = Acc(coef[k]);
+      const T *src = line + Taps - 1 - k;
+      for (std::size_t j = 0; j < n; ++j)
+        acc[j] += c * Acc(src[j]);
+    }
+    for (std::size_t j = 0; j < n; ++j)
+      out[at + j] = output(acc[j]);
+    for (std::size_t i = 0; i < Taps - 1; ++i)
+      line[i] = line[n + i];
+  }
+}
+
+int main() {
+  const long iterations = 50;
+  bool pass = true;
+
+  const auto taps = units::fir_lowpass<Taps>(units::si::Hertz<>(50.),
+                                             units::si::KiloHertz<>(1.));
+  std::vector<Pascal> in(Samples), out(Samples);
+  std::vector<float> rawIn(Samples), rawOut(Samples);
+  std::vector<AdcCounts> adcIn(Samples), adcOut(Samples);
+  std::vector<int16_t> rawAdcIn(Samples), rawAdcOut(Samples);
+  for (std::size_t i = 0; i < Samples; ++i) {
+    rawIn[i] = float(i % 251) - 125.f;
+    in[i] = Pascal(rawIn[i]);
+    rawAdcIn[i] = int16_t(i * 977);
+    adcIn[i] = AdcCounts(rawAdcIn[i]);
+  }
+
+  // Raw coefficients for the hand-written loops
+  float coef[Taps];
+  int32_t fixedCoef[Taps];
+  for (std::size_t k = 0; k < Taps; ++k) {
+    coef[k] = float(double(taps[k]));
+    fixedCoef[k] = int32_t(std::lround(double(taps[k]) * 16384));
+  }
+  float line[Taps - 1 + Block] = {};
+  int16_t fixedLine[Taps - 1 + Block] = {};
+  double hand = bench::ns_per_op(iterations, [&]() {
+    hand_fir<float>(coef, line, rawIn.data(), Samples, rawOut.data(),
+                    [](float acc) { return acc; });
+    bench::do_not_optimize(rawOut[Samples - 1]);
+  });
+  bench::report("hand-written FIR, 32 taps, float", hand / Samples, "ns/sample",
+                0);
+  units::FirFilter<Pascal, Taps> fir(taps);
+  double ns = bench::ns_per_op(iterations, [&]() {
+    fir.process(in.data(), Samples, out.data());
+    bench::do_not_optimize(out[Samples - 1]);
+  });
+  pass &= bench::report("FirFilter, 32 taps, float", ns / Samples, "ns/sample",
+                        hand * overhead_budget / Samples);
+
+  hand = bench::ns_per_op(iterations, [&]() {
+    hand_fir<int64_t>(fixedCoef, fixedLine, rawAdcIn.data(), Samples,
+                      rawAdcOut.data(), [](int64_t acc) {
+                        acc = (acc + 8192) >> 14;
+                        return int16_t(acc < -32768 ? -32768
+                                                    : (acc > 32767 ? 32767
+                                                                   : acc));
+                      });
+    bench::do_not_optimize(rawAdcOut[Samples - 1]);
+  });
+  bench::report("hand-written FIR, 32 taps, Q14", hand / Samples, "ns/sample",
+                0);
+  units::FirFilter<AdcCounts, Taps> fixedFir(taps);
+  ns = bench::ns_per_op(iterations, [&]() {
+    fixedFir.process(adcIn.data(), Samples, adcOut.data());
+    bench::do_not_optimize(adcOut[Samples - 1]);
+  });
+  pass &= bench::report("FirFilter, 32 taps, Q14", ns / Samples, "ns/sample",
+                        hand * overhead_budget / Samples);
+
+  const units::Biquad sections[2] = {
+      units::lowpass(units::si::Hertz<>(50.), units::si::KiloHertz<>(1.)),
+      units::highpass(units::si::Hertz<>(1.), units::si::KiloHertz<>(1.))};
+  float b[2][5], state[2][4] = {};
+  for (int s = 0; s < 2; ++s) {
+    b[s][0] = float(double(sections[s].b0));
+    b[s][1] = float(double(sections[s].b1));
+    b[s][2] = float(double(sections[s].b2));
+    b[s][3] = float(-double(sections[s].a1));
+    b[s][4] = float(-double(sections[s].a2));
+  }
+  hand = bench::ns_per_op(iterations, [&]() {
+    for (std::size_t i = 0; i < Samples; ++i) {
+      float x = rawIn[i];
+      for (int s = 0; s < 2; ++s) {
+        const float y = b[s][0] * x + b[s][1] * state[s][0] +
+                        b[s][2] * state[s][1] + b[s][3] * state[s][2] +
+                        b[s][4] * state[s][3];
+        state[s][1] = state[s][0];
+        state[s][0] = x;
+        state[s][3] = state[s][2];
+        state[s][2] = y;
+        x = y;
+      }
+      rawOut[i] = x;
+    }
+    bench::do_not_optimize(rawOut[Samples - 1]);
+  });
+  bench::report("hand-written 2 biquads, float", hand / Samples, "ns/sample",
+                0);
+  units::BiquadFilter<Pascal, 2> biquad(sections);
+  ns = bench::ns_per_op(iterations, [&]() {
+    biquad.process(in.data(), Samples, out.data());
+    bench::do_not_optimize(out[Samples - 1]);
+  });
+  pass &= bench::report("BiquadFilter, 2 sections, float", ns / Samples,
+                        "ns/sample", hand * overhead_budget / Samples);
+
+  return pass ? 0 : 1;
+}
@@ -0,0 +1,66 @@
+#include "bench.hpp"
+#include "phys_fixed.hpp"
+#include "phys_si.hpp"
+#include <cstdint>
+#include <vector>
+
+using Q16 = units::Fixed<int32_t, 16>;
+using Volt = units::si::Volt<Q16>;
+using VoltFloat = units::si::Volt<float>;
+
+// The typed fixed point loop may be this much slower than the hand-written
+static const double overhead_budget = 1.2;
+
+int main() {
+  const std::size_t Samples = 1 << 20;
+  const long iterations = 20;
+  bool pass = true;
+
+  std::vector<int32_t> raw(Samples);
+  std::vector<Volt> volts(Samples);
+  std::vector<VoltFloat> floats(Samples);
+  for (std::size_t i = 0; i < Samples; ++i) {
+    raw[i] = int32_t(i * 2654435761u % 655360) - 327680;
+    volts[i] = Volt(Q16::from_raw(raw[i]));
+    floats[i] = VoltFloat(float(raw[i]) / 65536.f);
+  }
+
+  // First order low-pass followed by a gain, as in a control loop
+  const int32_t k = 3277, gain = 98304;
+  double hand = bench::ns_per_op(iterations, [&]() {
+    int32_t y = 0, out = 0;
+    for (std::size_t i = 0; i < Samples; ++i) {
+      y += int32_t((int64_t(k) * (raw[i] - y) + (1 << 15)) >> 16);
+      out ^= int32_t((int64_t(gain) * y + (1 << 15)) >> 16);
+    }
+    bench::do_not_optimize(out);
+  });
+  bench::report("hand-written Q16.16", hand / Samples, "ns/sample", 0);
+
+  double ns = bench::ns_per_op(iterations, [&]() {
+    const Q16 kq = Q16::from_raw(k), gq = Q16::from_raw(gain);
+    Volt y;
+    int32_t out = 0;
+    for (std::size_t i = 0; i < Samples; ++i) {
+      y += Volt(kq * (volts[i] - y));
+      out ^= Volt(gq * y).value().raw();
+    }
+    bench::do_not_optimize(out);
+  });
+  pass &= bench::report("Volt<Fixed<int32_t, 16>>", ns / Samples, "ns/sample",
+                        hand * overhead_budget / Samples);
+
+  ns = bench::ns_per_op(iterations, [&]() {
+    const float kf = float(k) / 65536.f, gf = float(gain) / 65536.f;
+    VoltFloat y(0.f);
+    float out = 0;
+    for (std::size_t i = 0; i < Samples; ++i) {
+      y += kf * (floats[i] - y);
+      out += (gf * y).value();
+    }
+    bench::do_not_optimize(out);
+  });
+  bench::report("Volt<float>, hardware FPU", ns / Samples, "ns/sample", 0);
+
+  return pass ? 0 : 1;
+}
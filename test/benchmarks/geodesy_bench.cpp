@@ -0,0 +1,95 @@
+#include "bench.hpp"
+#include "phys_geodesy.hpp"
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using Latitude = units::AbsoluteAngle<double, std::ratio<1>, true>;
+using RadianLatitude = units::AbsoluteAngle<double, units::RadianRatio, true>;
+using Meter = units::si::Meter<double>;
+
+// 50M distance evaluations per second, which takes a few cores at the
+// SSE2 baseline or a single core built with -march=native (AVX2 and FMA)
+static const double distance_target_ns = 20.;
+
+int main() {
+  const std::size_t count = 1 << 20;
+  const long iterations = 10;
+  const unsigned threads = std::thread::hardware_concurrency();
+  bool pass = true;
+
+  std::vector<double> p1(count), l1(count), p2(count), l2(count), raw(count);
+  std::vector<Latitude> lat1(count), lon1(count), lat2(count), lon2(count);
+  std::vector<RadianLatitude> rlat1(count), rlon1(count), rlat2(count),
+      rlon2(count);
+  std::vector<Meter> out(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    p1[i] = double(i % 17000) / 100. - 85.;
+    l1[i] = double(i % 35000) / 100. - 175.;
+    p2[i] = double(i * 7 % 17000) / 100. - 85.;
+    l2[i] = double(i * 13 % 35000) / 100. - 175.;
+    lat1[i] = Latitude(p1[i]);
+    lon1[i] = Latitude(l1[i]);
+    lat2[i] = Latitude(p2[i]);
+    lon2[i] = Latitude(l2[i]);
+    rlat1[i] = RadianLatitude(p1[i] / 57.296);
+    rlon1[i] = RadianLatitude(l1[i] / 57.296);
+    rlat2[i] = RadianLatitude(p2[i] / 57.296);
+    rlon2[i] = RadianLatitude(l2[i] / 57.296);
+  }
+
+  const double rad = units::FastMath::Pi / 180;
+  double ns = bench::ns_per_op(iterations, [&]() {
+    for (std::size_t i = 0; i < count; ++i) {
+      const double sdp = std::sin((p2[i] - p1[i]) * rad / 2);
+      const double sdl = std::sin((l2[i] - l1[i]) * rad / 2);
+      const double a = sdp * sdp + std::cos(p1[i] * rad) *
+                                       std::cos(p2[i] * rad) * sdl * sdl;
+      raw[i] = 2 * std::asin(std::sqrt(a)) * units::Earth::MeanRadius;
+    }
+    bench::do_not_optimize(raw[count - 1]);
+  });
+  bench::report("hand-written haversine, std::", ns / count, "ns/pair", 0);
+  const double hand = ns;
+
+  ns = bench::ns_per_op(iterations, [&]() {
+    units::haversine_n(lat1.data(), lon1.data(), lat2.data(), lon2.data(),
+                       count, out.data());
+    bench::do_not_optimize(out[count - 1]);
+  });
+  pass &= bench::report("haversine_n, degrees", ns / count, "ns/pair",
+                        hand / count);
+
+  ns = bench::ns_per_op(iterations, [&]() {
+    units::haversine_n(rlat1.data(), rlon1.data(), rlat2.data(), rlon2.data(),
+                       count, out.data());
+    bench::do_not_optimize(out[count - 1]);
+  });
+  bench::report("haversine_n, radians", ns / count, "ns/pair", 0);
+
+  ns = bench::ns_per_op(iterations, [&]() {
+    units::haversine_n(lat1.data(), lon1.data(), lat2.data(), lon2.data(),
+                       count, out.data(), threads);
+    bench::do_not_optimize(out[count - 1]);
+  });
+  bench::report("haversine_n, all threads", ns / count, "ns/pair", 0);
+  std::printf("%-40s %12.2f M pairs/s, target %.0f M pairs/s\n", "",
+              1000. / (ns / count), 1000. / distance_target_ns);
+
+  std::vector<units::AbsoluteAngle<double>> bearings(count);
+  ns = bench::ns_per_op(iterations, [&]() {
+    units::bearing_n(lat1.data(), lon1.data(), lat2.data(), lon2.data(), count,
+                     bearings.data());
+    bench::do_not_optimize(bearings[count - 1]);
+  });
+  bench::report("bearing_n", ns / count, "ns/pair", 0);
+
+  ns = bench::ns_per_op(1, [&]() {
+    units::vincenty_n(lat1.data(), lon1.data(), lat2.data(), lon2.data(),
+                      count, out.data());
+    bench::do_not_optimize(out[count - 1]);
+  });
+  bench::report("vincenty_n", ns / count, "ns/pair", 0);
+
+  return pass ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+#include "bench.hpp"
+#include "phys_histogram.hpp"
+#include "phys_si.hpp"
+#include "phys_timing.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using NanoSecond = units::si::NanoSecond<std::int64_t>;
+using MicroSecond = units::si::MicroSecond<float>;
+using Second = units::si::Second<double>;
+
+// 500M samples per second and core, for the vectorized binnings
+static const double insert_budget_ns = 2.;
+// The log-linear buckets, 32 per power of two, may take up to twice as long
+// as the power of two buckets of LatencyHistogram
+static const double log_linear_budget = 2.;
+
+int main() {
+  const std::size_t Samples = 1 << 20;
+  const long iterations = 20;
+  const unsigned cores = std::thread::hardware_concurrency();
+  bool pass = true;
+
+  // Latencies spread over four decades, from 100 ns on
+  std::vector<NanoSecond> latencies(Samples);
+  std::vector<Second> seconds(Samples);
+  std::vector<MicroSecond> micro(Samples);
+  std::uint64_t state = 88172645463325252ull;
+  for (std::size_t i = 0; i < Samples; ++i) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    const std::int64_t ns = 100 + std::int64_t(state % (1u << (state >> 60)));
+    latencies[i] = NanoSecond(ns);
+    seconds[i] = Second(double(ns) * 1e-9);
+    micro[i] = MicroSecond(float(ns) * 1e-3f);
+  }
+
+  units::LatencyHistogram latency;
+  double ns = bench::ns_per_op(iterations, [&]() {
+    for (const NanoSecond &sample : latencies)
+      latency.record(units::NanoSeconds(sample.value()));
+    bench::do_not_optimize(latency);
+  });
+  bench::report("LatencyHistogram, one by one", ns / Samples, "ns/sample", 0);
+  const double coarse = ns / Samples;
+
+  units::Histogram<units::LogLinearBins<NanoSecond>> logLinear;
+  ns = bench::ns_per_op(iterations, [&]() {
+    logLinear.insert_n(latencies.data(), Samples);
+    bench::do_not_optimize(logLinear);
+  });
+  pass &= bench::report("LogLinearBins, insert_n", ns / Samples, "ns/sample",
+                        coarse * log_linear_budget);
+
+  ns = bench::ns_per_op(iterations, [&]() {
+    logLinear.insert_n(seconds.data(), Samples);
+    bench::do_not_optimize(logLinear);
+  });
+  pass &= bench::report("LogLinearBins, insert_n of Second", ns / Samples,
+                        "ns/sample", coarse * log_linear_budget);
+
+  using Linear = units::LinearBins<MicroSecond, 100>;
+  units::Histogram<Linear> linear(Linear(MicroSecond(0.f), MicroSecond(500.f)));
+  ns = bench::ns_per_op(iterations, [&]() {
+    linear.insert_n(micro.data(), Samples);
+    bench::do_not_optimize(linear);
+  });
+  pass &= bench::report("LinearBins, insert_n", ns / Samples, "ns/sample",
+                        insert_budget_ns);
+
+  // Sixteen edges: a binary search over raw doubles against the typed edges
+  MicroSecond edges[16];
+  double rawEdges[16];
+  for (int e = 0; e < 16; ++e) {
+    edges[e] = MicroSecond(float(1 << e) * 0.25f);
+    rawEdges[e] = double(edges[e].value());
+  }
+  std::uint64_t counts[17] = {};
+  const double searched = bench::ns_per_op(iterations, [&]() {
+    for (const MicroSecond &sample : micro)
+      ++counts[std::upper_bound(rawEdges, rawEdges + 16,
+                                double(sample.value())) -
+               rawEdges];
+    bench::do_not_optimize(counts[8]);
+  });
+  bench::report("std::upper_bound on raw doubles", searched / Samples,
+                "ns/sample", 0);
+
+  using Edges = units::EdgeBins<MicroSecond, 16>;
+  units::Histogram<Edges> edged{Edges(edges)};
+  ns = bench::ns_per_op(iterations, [&]() {
+    edged.insert_n(micro.data(), Samples);
+    bench::do_not_optimize(edged);
+  });
+  pass &= bench::report("EdgeBins, insert_n", ns / Samples, "ns/sample",
+                        searched / Samples);
+
+  // Every thread inserts all the samples into its shard
+  const unsigned threads = cores > 4 ? cores : 4;
+  units::ThreadHistograms<units::LogLinearBins<NanoSecond>> shards;
+  ns = bench::ns_per_op(2, [&]() {
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t)
+      workers.emplace_back([&]() {
+        for (int pass = 0; pass < 4; ++pass)
+          shards.insert_n(latencies.data(), Samples);
+      });
+    for (std::thread &worker : workers)
+      worker.join();
+  });
+  bench::report("ThreadHistograms, all threads",
+                double(threads) * 4 * Samples / ns * 1e3, "M/s", 0);
+  pass &= bench::report("ThreadHistograms, per core",
+                        ns * cores / threads / 4 / Samples, "ns/sample",
+                        coarse * log_linear_budget);
+  bench::do_not_optimize(shards.snapshot().count());
+
+  return pass ? 0 : 1;
+}
@@ -0,0 +1,71 @@
+#include "bench.hpp"
+#include "phys_metrics.hpp"
+#include "phys_si.hpp"
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using Requests = units::PhysicalUnit<std::uint64_t>;
+using MicroSecond = units::si::MicroSecond<double>;
+
+// A few nanoseconds per update and thread
+static const double update_budget_ns = 5.;
+
+// Runs the body on the given number of threads, each for count updates, and
+// returns the wall nanoseconds per update of one thread. Scaled by the cores
+// over the threads it is the processor time of an update.
+template <typename Body>
+double per_update(unsigned threads, long count, Body body) {
+  return bench::ns_per_op(1, [&]() {
+           std::vector<std::thread> workers;
+           for (unsigned t = 0; t < threads; ++t)
+             workers.emplace_back([&]() {
+               for (long i = 0; i < count; ++i)
+                 body(i);
+             });
+           for (std::thread &worker : workers)
+             worker.join();
+         }) /
+         double(count);
+}
+
+int main() {
+  const long count = 20000000;
+  const unsigned cores = std::thread::hardware_concurrency();
+  const unsigned threads = cores > 4 ? cores : 4;
+  bool pass = true;
+
+  std::atomic<std::uint64_t> shared(0);
+  double ns = per_update(threads, count, [&](long) {
+    shared.fetch_add(1, std::memory_order_relaxed);
+  });
+  bench::report("shared std::atomic, all threads", ns * cores / threads,
+                "ns/update", 0);
+
+  units::Counter<Requests> requests;
+  ns = per_update(1, count, [&](long) { requests.add(Requests(1)); });
+  pass &= bench::report("Counter, one thread", ns, "ns/update",
+                        update_budget_ns);
+  ns = per_update(threads, count, [&](long) { requests.add(Requests(1)); });
+  pass &= bench::report("Counter, all threads", ns * cores / threads,
+                        "ns/update", update_budget_ns);
+  bench::do_not_optimize(requests.value());
+
+  const MicroSecond bounds[] = {MicroSecond(10), MicroSecond(100),
+                                MicroSecond(1000), MicroSecond(10000)};
+  units::MetricHistogram<MicroSecond, 4> latency(bounds);
+  ns = per_update(1, count, [&](long i) {
+    latency.record(MicroSecond(double(i & 16383)));
+  });
+  pass &= bench::report("MetricHistogram, one thread", ns, "ns/update",
+                        2 * update_budget_ns);
+  ns = per_update(threads, count, [&](long i) {
+    latency.record(MicroSecond(double(i & 16383)));
+  });
+  pass &= bench::report("MetricHistogram, all threads", ns * cores / threads,
+                        "ns/update", 2 * update_budget_ns);
+  bench::do_not_optimize(latency.count());
+
+  return pass ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+#include "bench.hpp"
+#include "phys_pipeline.hpp"
+#include "phys_si.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+using RawMilliVolt = units::si::MilliVolt<std::int32_t>;
+using MilliVolt = units::si::MilliVolt<double>;
+using Volt = units::si::Volt<double>;
+
+// Compute bound stages, so the throughput follows the workers
+static Volt shape(const Volt &v) {
+  double x = v.value();
+  for (int i = 0; i < 8; ++i)
+    x = std::sqrt(x * x + 1.) - 0.5;
+  return Volt(x);
+}
+
+static MilliVolt calibrate(const RawMilliVolt &raw) {
+  return MilliVolt(raw) * 1.5;
+}
+
+using Calibrate = units::MapStage<RawMilliVolt, MilliVolt,
+                                  MilliVolt (*)(const RawMilliVolt &)>;
+using Shape = units::MapStage<Volt, Volt, Volt (*)(const Volt &)>;
+
+// Scaling efficiency of n workers against one, while they are below the
+// core count, the feeding thread takes the rest
+static const double efficiency_budget = 0.75;
+
+template <typename Pipeline>
+double values_per_us(Pipeline &pipeline, unsigned lanes, long count) {
+  RawMilliVolt in[256];
+  Volt out[256];
+  for (int i = 0; i < 256; ++i)
+    in[i] = RawMilliVolt(i);
+  const auto begin = std::chrono::steady_clock::now();
+  long sent = 0;
+  long received = 0;
+  while (received < count) {
+    bool moved = false;
+    for (unsigned l = 0; l < lanes; ++l) {
+      if (sent < count) {
+        const std::size_t n = pipeline.push_n(l, in, 256);
+        sent += long(n);
+        moved |= n > 0;
+      }
+      const std::size_t n = pipeline.pop_n(l, out, 256);
+      received += long(n);
+      moved |= n > 0;
+    }
+    if (!moved)
+      std::this_thread::yield();
+  }
+  const auto end = std::chrono::steady_clock::now();
+  bench::do_not_optimize(out[0]);
+  return double(count) /
+         double(std::chrono::duration_cast<std::chrono::microseconds>(end -
+                                                                      begin)
+                    .count());
+}
+
+int main() {
+  const unsigned cores = std::thread::hardware_concurrency();
+  const long per_lane = 1000000;
+  bool pass = true;
+
+  // The same work on the calling thread, without the pipeline
+  RawMilliVolt in[256];
+  Volt out[256];
+  for (int i = 0; i < 256; ++i)
+    in[i] = RawMilliVolt(i);
+  const double loop_ns = bench::ns_per_op(per_lane / 256, [&]() {
+    for (int i = 0; i < 256; ++i)
+      out[i] = shape(shape(Volt(calibrate(in[i]))));
+    bench::do_not_optimize(out[0]);
+  });
+  bench::report("hand-written loop", 256e3 / loop_ns, "values/us", 0);
+
+  double single = 0;
+  const unsigned most = cores > 2 ? cores : 2;
+  for (unsigned workers = 1; workers <= most; workers *= 2) {
+    units::Pipeline<256, 8, Calibrate, Shape, Shape> pipeline(
+        workers, {&calibrate}, {&shape}, {&shape});
+    pipeline.start(workers);
+    const double rate = values_per_us(pipeline, workers, per_lane * workers);
+    pipeline.stop();
+    if (workers == 1)
+      single = rate;
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "pipeline, %u workers", workers);
+    bench::report(name, rate, "values/us", 0);
+    std::snprintf(name, sizeof(name), "time over ideal, %u workers",
+                  workers);
+    const double slowdown = single * workers / rate;
+    pass &= bench::report(name, slowdown, "x ideal time",
+                          workers < cores ? 1 / efficiency_budget : 0);
+  }
+  return pass ? 0 : 1;
+}
@@ -0,0 +1,88 @@
+#include "bench.hpp"
+#include "phys_random.hpp"
+#include "phys_si.hpp"
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+using TempKelvin = units::si::TempKelvin<double>;
+using MilliKelvin = units::si::Temperature<double, std::milli>;
+using NanoSecond = units::si::NanoSecond<std::int64_t>;
+using MicroSecond = units::si::MicroSecond<double>;
+using Heading = units::AbsoluteAngle<double>;
+
+static const std::size_t count = 1 << 20;
+
+int main() {
+  bool pass = true;
+  const units::Philox rng(42);
+  std::mt19937_64 engine(42);
+
+  std::vector<TempKelvin> temperatures(count);
+  const double stdNormal = bench::ns_per_op(5, [&]() {
+    std::normal_distribution<double> noise(293.15, 0.05);
+    for (std::size_t i = 0; i < count; ++i)
+      temperatures[i] = TempKelvin(noise(engine));
+    bench::do_not_optimize(temperatures[0]);
+  }) / count;
+  bench::report("std::normal_distribution, mt19937_64", stdNormal,
+                "ns/sample", 0);
+  const units::NormalDistribution<TempKelvin> noise(TempKelvin(293.15),
+                                                    MilliKelvin(50));
+  const double normal = bench::ns_per_op(5, [&]() {
+    noise.generate(rng, 0, count, temperatures.data());
+    bench::do_not_optimize(temperatures[0]);
+  }) / count;
+  pass &= bench::report("NormalDistribution<TempKelvin>", normal, "ns/sample",
+                        stdNormal);
+
+  std::vector<NanoSecond> delays(count);
+  const double stdExponential = bench::ns_per_op(5, [&]() {
+    std::exponential_distribution<double> jitter(1 / 2500.);
+    for (std::size_t i = 0; i < count; ++i)
+      delays[i] = NanoSecond(std::int64_t(jitter(engine) + 0.5));
+    bench::do_not_optimize(delays[0]);
+  }) / count;
+  bench::report("std::exponential_distribution", stdExponential, "ns/sample",
+                0);
+  const units::ExponentialDistribution<NanoSecond> jitter(MicroSecond(2.5));
+  const double exponential = bench::ns_per_op(5, [&]() {
+    jitter.generate(rng, 0, count, delays.data());
+    bench::do_not_optimize(delays[0]);
+  }) / count;
+  pass &= bench::report("ExponentialDistribution<NanoSecond>", exponential,
+                        "ns/sample", stdExponential);
+
+  std::vector<Heading> headings(count);
+  const double stdUniform = bench::ns_per_op(5, [&]() {
+    std::uniform_real_distribution<double> turn(0, 360);
+    for (std::size_t i = 0; i < count; ++i)
+      headings[i] = Heading(turn(engine));
+    bench::do_not_optimize(headings[0]);
+  }) / count;
+  bench::report("std::uniform_real_distribution", stdUniform, "ns/sample", 0);
+  const units::UniformDistribution<Heading> turn;
+  const double uniform = bench::ns_per_op(5, [&]() {
+    turn.generate(rng, 0, count, headings.data());
+    bench::do_not_optimize(headings[0]);
+  }) / count;
+  pass &= bench::report("UniformDistribution<Heading>", uniform, "ns/sample",
+                        stdUniform);
+
+  const units::VonMisesDistribution<Heading> around(Heading(90), 4.);
+  const double vonMises = bench::ns_per_op(5, [&]() {
+    around.generate(rng, 0, count, headings.data());
+    bench::do_not_optimize(headings[0]);
+  }) / count;
+  bench::report("VonMisesDistribution<Heading>", vonMises, "ns/sample", 0);
+
+  const unsigned threads = std::thread::hardware_concurrency();
+  const double parallel = bench::ns_per_op(5, [&]() {
+    units::draw_n(noise, rng, 0, count, temperatures.data(), threads);
+    bench::do_not_optimize(temperatures[0]);
+  }) / count;
+  bench::report("draw_n normal, all threads", parallel, "ns/sample", 0);
+
+  return pass ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+#include "bench.hpp"
+#include "phys_angle.hpp"
+#include "phys_record.hpp"
+#include "phys_si.hpp"
+#include <memory>
+#include <vector>
+
+using TimeStampNanoSeconds =
+    units::AbsolutePhysicalUnit<int64_t, std::nano, int64_t, std::ratio<0>,
+                                std::ratio<0>, std::ratio<0>, std::ratio<1>>;
+using TempCelsius = units::si::TempCelsius<float>;
+using Heading = units::AbsoluteAngle<float, std::ratio<1>, false>;
+using Volt = units::si::Volt<float>;
+
+// Type-erased record fields, one allocation each
+struct AnyField {
+  virtual ~AnyField() {}
+};
+template <typename T> struct FieldOf : AnyField {
+  explicit FieldOf(const T &val) : value(val) {}
+  T value;
+};
+using AnyRecord = std::vector<std::unique_ptr<AnyField>>;
+
+// Budget for appending one four column record to a batch
+static const double append_budget_ns = 20.;
+
+int main() {
+  const std::size_t rows = 1 << 16;
+  const long iterations = 20;
+  bool pass = true;
+
+  std::vector<AnyRecord> records;
+  records.reserve(rows);
+  double ns = bench::ns_per_op(iterations, [&]() {
+    records.clear();
+    for (std::size_t i = 0; i < rows; ++i) {
+      AnyRecord record;
+      record.emplace_back(new FieldOf<TimeStampNanoSeconds>(
+          TimeStampNanoSeconds(int64_t(i))));
+      record.emplace_back(new FieldOf<TempCelsius>(TempCelsius(21.f)));
+      record.emplace_back(new FieldOf<Heading>(Heading(float(i % 360))));
+      record.emplace_back(new FieldOf<Volt>(Volt(3.3f)));
+      records.push_back(std::move(record));
+    }
+    bench::do_not_optimize(records.back());
+  });
+  bench::report("type-erased records", ns / rows, "ns/record", 0);
+
+  units::MonotonicArena arena(1 << 20);
+  ns = bench::ns_per_op(iterations, [&]() {
+    arena.release();
+    units::RecordBatch<TimeStampNanoSeconds, TempCelsius, Heading, Volt> batch(
+        arena, rows);
+    for (std::size_t i = 0; i < rows; ++i)
+      batch.append(TimeStampNanoSeconds(int64_t(i)), TempCelsius(21.f),
+                   Heading(float(i % 360)), Volt(3.3f));
+    bench::do_not_optimize(batch.column<0>()[rows - 1]);
+  });
+  pass &= bench::report("RecordBatch rows", ns / rows, "ns/record",
+                        append_budget_ns);
+
+  return pass ? 0 : 1;
+}
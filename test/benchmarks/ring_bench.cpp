@@ -0,0 +1,95 @@
+#include "bench.hpp"
+#include "phys_ring.hpp"
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using TimeStampNanoSeconds =
+    units::AbsolutePhysicalUnit<int64_t, std::nano, int64_t, std::ratio<0>,
+                                std::ratio<0>, std::ratio<0>, std::ratio<1>>;
+using Pascal = units::PhysicalUnit<float, std::ratio<1>, std::ratio<-1>,
+                                   std::ratio<1>, std::ratio<-2>>;
+using Sample = units::TimedSample<TimeStampNanoSeconds, Pascal>;
+
+// 100M samples per second
+static const double spsc_budget_ns = 10.;
+
+static units::SpscRing<Sample, 4096> spsc;
+static units::MpscRing<Sample, 4096> mpsc;
+static units::SpscRing<Sample, 2> ping, pong;
+
+template <typename Ring>
+double ns_per_sample(Ring &ring, unsigned producers, long count) {
+  const std::size_t Batch = 64;
+  std::vector<std::thread> threads;
+  const auto begin = std::chrono::steady_clock::now();
+  for (unsigned p = 0; p < producers; ++p)
+    threads.emplace_back([&ring, count]() {
+      Sample batch[Batch];
+      for (long sent = 0; sent < count;) {
+        for (std::size_t i = 0; i < Batch; ++i)
+          batch[i] = Sample(TimeStampNanoSeconds(sent + long(i)),
+                            Pascal(float(i)));
+        const std::size_t n = ring.push_n(batch, Batch);
+        if (n == 0)
+          std::this_thread::yield();
+        sent += long(n);
+      }
+    });
+  Sample batch[Batch];
+  float sum = 0;
+  const long total = count * long(producers);
+  for (long received = 0; received < total;) {
+    const std::size_t n = ring.pop_n(batch, Batch);
+    if (n == 0)
+      std::this_thread::yield();
+    for (std::size_t i = 0; i < n; ++i)
+      sum += batch[i].value.value();
+    received += long(n);
+  }
+  for (auto &thread : threads)
+    thread.join();
+  const auto end = std::chrono::steady_clock::now();
+  bench::do_not_optimize(sum);
+  return double(std::chrono::duration_cast<std::chrono::nanoseconds>(end -
+                                                                     begin)
+                    .count()) /
+         double(total);
+}
+
+int main() {
+  const long count = 20000000;
+  bool pass = true;
+
+  double ns = ns_per_sample(spsc, 1, count);
+  pass &= bench::report("SpscRing batches of 64", ns, "ns/sample",
+                        spsc_budget_ns);
+  std::printf("%-40s %12.2f M samples/s\n", "", 1000. / ns);
+
+  ns = ns_per_sample(mpsc, 4, count / 4);
+  bench::report("MpscRing 4 producers, batches of 64", ns, "ns/sample", 0);
+  std::printf("%-40s %12.2f M samples/s\n", "", 1000. / ns);
+
+  // Round trip of a single sample between two threads
+  const long trips = 100000;
+  std::thread echo([trips]() {
+    Sample sample;
+    for (long i = 0; i < trips; ++i) {
+      while (!ping.pop(sample))
+        std::this_thread::yield();
+      while (!pong.push(sample))
+        std::this_thread::yield();
+    }
+  });
+  ns = bench::ns_per_op(trips - 1, []() {
+    Sample sample(TimeStampNanoSeconds(0), Pascal(0.f));
+    while (!ping.push(sample))
+      std::this_thread::yield();
+    while (!pong.pop(sample))
+      std::this_thread::yield();
+  });
+  echo.join();
+  bench::report("SpscRing round trip", ns, "ns", 0);
+
+  return pass ? 0 : 1;
+}
@@ -0,0 +1,67 @@
+#include "bench.hpp"
+#include "phys_algorithm.hpp"
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+using TimeStampMicroSeconds =
+    units::AbsolutePhysicalUnit<int64_t, std::micro, int64_t, std::ratio<0>,
+                                std::ratio<0>, std::ratio<0>, std::ratio<1>>;
+
+template <typename Body> double ns_per_item(std::size_t items, Body body) {
+  const auto begin = std::chrono::steady_clock::now();
+  body();
+  const auto end = std::chrono::steady_clock::now();
+  return double(std::chrono::duration_cast<std::chrono::nanoseconds>(end -
+                                                                     begin)
+                    .count()) /
+         double(items);
+}
+
+int main() {
+  const std::size_t count = 10000000;
+  const std::size_t queries = 1000000;
+  std::mt19937_64 rng(1);
+  std::vector<TimeStampMicroSeconds> stamps(count);
+  const int64_t start = 1704067200000000;
+  for (auto &stamp : stamps)
+    stamp = TimeStampMicroSeconds(start + int64_t(rng() % 86400000000));
+
+  std::vector<TimeStampMicroSeconds> by_std = stamps;
+  double ns = ns_per_item(count, [&by_std]() {
+    std::sort(by_std.begin(), by_std.end());
+  });
+  bench::report("std::sort timestamps", ns, "ns/item", 0);
+
+  std::vector<TimeStampMicroSeconds> by_radix = stamps;
+  std::vector<TimeStampMicroSeconds> scratch(count);
+  const double radix_ns = ns_per_item(count, [&by_radix, &scratch]() {
+    units::radix_sort(by_radix.data(), by_radix.size(), scratch.data());
+  });
+  bool pass = bench::report("radix_sort timestamps", radix_ns, "ns/item", ns);
+  pass &= by_radix == by_std;
+
+  std::vector<TimeStampMicroSeconds> keys(queries);
+  for (auto &key : keys)
+    key = TimeStampMicroSeconds(start + int64_t(rng() % 86400000000));
+  std::vector<std::size_t> found(queries);
+  ns = ns_per_item(queries, [&]() {
+    for (std::size_t i = 0; i < queries; ++i)
+      found[i] = std::size_t(
+          std::lower_bound(by_std.begin(), by_std.end(), keys[i]) -
+          by_std.begin());
+  });
+  bench::do_not_optimize(found.data());
+  bench::report("std::lower_bound", ns, "ns/query", 0);
+
+  std::vector<std::size_t> batched(queries);
+  const double batched_ns = ns_per_item(queries, [&]() {
+    units::lower_bound_n(by_radix.data(), count, keys.data(), queries,
+                         batched.data());
+  });
+  pass &= bench::report("lower_bound_n", batched_ns, "ns/query", ns);
+  pass &= batched == found;
+
+  return pass ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+#include "bench.hpp"
+#include "phys_si.hpp"
+#include "phys_span.hpp"
+#include <cstdint>
+#include <vector>
+
+using MilliVolt = units::si::MilliVolt<std::int16_t>;
+using Volt = units::si::Volt<double>;
+
+int main() {
+  const std::size_t Frame = 1 << 20;
+  const long iterations = 50;
+  bool pass = true;
+
+  std::vector<std::int16_t> raw(Frame);
+  for (std::size_t i = 0; i < Frame; ++i)
+    raw[i] = std::int16_t(i * 37 % 6000 - 3000);
+
+  // Copying each incoming frame into units before use
+  double copied = bench::ns_per_op(iterations, [&]() {
+    std::vector<MilliVolt> frame(raw.begin(), raw.end());
+    long sum = 0;
+    for (const MilliVolt &v : frame)
+      sum += v.value();
+    bench::do_not_optimize(sum);
+  });
+  bench::report("copy to vector, then sum", copied / Frame, "ns/sample", 0);
+
+  double ns = bench::ns_per_op(iterations, [&]() {
+    auto frame = units::quantity_span<MilliVolt>(raw.data(), Frame);
+    long sum = 0;
+    for (const MilliVolt &v : frame)
+      sum += v.value();
+    bench::do_not_optimize(sum);
+  });
+  pass &= bench::report("quantity_span, sum", ns / Frame, "ns/sample",
+                        copied / Frame);
+
+  copied = bench::ns_per_op(iterations, [&]() {
+    std::vector<Volt> frame(Frame);
+    for (std::size_t i = 0; i < Frame; ++i)
+      frame[i] = Volt(MilliVolt(raw[i]));
+    double sum = 0;
+    for (const Volt &v : frame)
+      sum += v.value();
+    bench::do_not_optimize(sum);
+  });
+  bench::report("convert to vector, then sum", copied / Frame, "ns/sample",
+                0);
+
+  ns = bench::ns_per_op(iterations, [&]() {
+    auto frame =
+        units::as<Volt>(units::quantity_span<MilliVolt>(raw.data(), Frame));
+    double sum = 0;
+    frame.for_each_block([&](const Volt *block, std::size_t count) {
+      for (std::size_t i = 0; i < count; ++i)
+        sum += block[i].value();
+    });
+    bench::do_not_optimize(sum);
+  });
+  pass &= bench::report("as<Volt>, blocks, sum", ns / Frame, "ns/sample",
+                        copied / Frame);
+
+  ns = bench::ns_per_op(iterations, [&]() {
+    auto frame =
+        units::as<Volt>(units::quantity_span<MilliVolt>(raw.data(), Frame));
+    double sum = 0;
+    for (const Volt v : frame)
+      sum += v.value();
+    bench::do_not_optimize(sum);
+  });
+  pass &= bench::report("as<Volt>, per access, sum", ns / Frame, "ns/sample",
+                        copied / Frame);
+
+  // A 256 MB scratch buffer sized anew every frame, then partly written
+  const std::size_t Scratch = (256 << 20) / sizeof(Volt);
+  std::vector<Volt> zeroed;
+  zeroed.reserve(Scratch);
+  copied = bench::ns_per_op(10, [&]() {
+    zeroed.clear();
+    zeroed.resize(Scratch);
+    zeroed[Frame] = Volt(1.);
+    bench::do_not_optimize(zeroed.data());
+  });
+  bench::report("vector resize, 256 MB", copied / 1e6, "ms/frame", 0);
+
+  units::UninitializedVector<Volt> scratch;
+  scratch.reserve(Scratch);
+  ns = bench::ns_per_op(10, [&]() {
+    scratch.clear();
+    scratch.resize(Scratch);
+    scratch[Frame] = Volt(1.);
+    bench::do_not_optimize(scratch.data());
+  });
+  pass &= bench::report("UninitializedVector resize, 256 MB", ns / 1e6,
+                        "ms/frame", copied / 1e6 / 100);
+
+  return pass ? 0 : 1;
+}
@@ -0,0 +1,56 @@
+#include "bench.hpp"
+#include "phys_timing.hpp"
+#include <thread>
+#include <vector>
+
+// Budget for one start/stop pair, including the histogram update
+static const double probe_budget_ns = 20.;
+
+int main() {
+  const long iterations = 10000000;
+  bool pass = true;
+
+  units::TickClock::ns_per_tick();
+  std::printf("tick period: %.4f ns\n", units::TickClock::ns_per_tick());
+
+  double ns = bench::ns_per_op(iterations, []() {
+    bench::do_not_optimize(units::TickClock::now());
+  });
+  bench::report("TickClock::now", ns, "ns/call", 0);
+
+  ns = bench::ns_per_op(iterations, []() {
+    units::TimingProbe probe;
+    probe.start();
+    bench::do_not_optimize(probe.stop());
+  });
+  pass &= bench::report("TimingProbe start/stop", ns, "ns/probe",
+                        probe_budget_ns);
+
+  units::LatencyHistogram histogram;
+  ns = bench::ns_per_op(iterations, [&histogram]() {
+    units::ScopedTimer<units::LatencyHistogram> timer(histogram);
+  });
+  pass &= bench::report("ScopedTimer into LatencyHistogram", ns, "ns/probe",
+                        probe_budget_ns);
+
+  static units::ThreadLatencyHistograms<> shared;
+  const unsigned threads = std::thread::hardware_concurrency();
+  std::vector<std::thread> workers;
+  const auto begin = std::chrono::steady_clock::now();
+  for (unsigned t = 0; t < threads; ++t)
+    workers.emplace_back([iterations]() {
+      for (long i = 0; i < iterations; ++i) {
+        units::ScopedTimer<units::ThreadLatencyHistograms<>> timer(shared);
+      }
+    });
+  for (auto &worker : workers)
+    worker.join();
+  const auto end = std::chrono::steady_clock::now();
+  ns = double(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin)
+                  .count()) /
+       double(iterations);
+  pass &= bench::report("ScopedTimer into ThreadLatencyHistograms", ns,
+                        "ns/probe", probe_budget_ns);
+
+  return pass ? 0 : 1;
+}
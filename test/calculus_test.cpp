@@ -0,0 +1,93 @@
+#include "phys_calculus.hpp"
+#include <gtest/gtest.h>
+#include <type_traits>
+
+using Meter = units::PhysicalUnit<double, std::ratio<1>, std::ratio<1>>;
+using MeterPerSecond = units::PhysicalUnit<double, std::ratio<1>,
+                                           std::ratio<1>, std::ratio<0>,
+                                           std::ratio<-1>>;
+using MeterPerSecondSquared =
+    units::PhysicalUnit<double, std::ratio<1>, std::ratio<1>, std::ratio<0>,
+                        std::ratio<-2>>;
+using Seconds = units::PhysicalUnit<double, std::ratio<1>, std::ratio<0>,
+                                    std::ratio<0>, std::ratio<1>>;
+using TimeStampMilliSeconds =
+    units::AbsolutePhysicalUnit<int64_t, std::milli, int64_t, std::ratio<0>,
+                                std::ratio<0>, std::ratio<0>, std::ratio<1>>;
+
+TEST(CalculusTests, DeducedDimensions) {
+  using Integral = units::CumulativeTrapezoid<MeterPerSecondSquared, Seconds>;
+  static_assert(
+      std::is_same<Integral::ResultUnit, MeterPerSecond>::value,
+      "Integral of acceleration over time must be a speed");
+  using Derivative = units::CentralDifference<Meter, TimeStampMilliSeconds>;
+  static_assert(
+      std::is_same<Derivative::ResultUnit,
+                   units::PhysicalUnit<double, std::kilo, std::ratio<1>,
+                                       std::ratio<0>, std::ratio<-1>>>::value,
+      "Derivative over milliseconds must be meters per millisecond");
+}
+
+TEST(CalculusTests, TrapezoidChunks) {
+  units::CumulativeTrapezoid<MeterPerSecondSquared, Seconds> integral(
+      Seconds(0.1), MeterPerSecond(1.));
+  MeterPerSecondSquared accel[10];
+  MeterPerSecond speed[10];
+  for (int i = 0; i < 10; ++i)
+    accel[i] = MeterPerSecondSquared(2.);
+  integral.process(accel, 4, speed);
+  integral.process(accel + 4, 6, speed + 4);
+  EXPECT_NEAR(speed[0].value(), 1., 0.000001);
+  EXPECT_NEAR(speed[1].value(), 1.2, 0.000001);
+  EXPECT_NEAR(speed[9].value(), 2.8, 0.000001);
+  EXPECT_NEAR(integral.value().value(), 2.8, 0.000001);
+}
+
+TEST(CalculusTests, SimpsonIsExactForParabola) {
+  // v(t) = 3 t^2 integrates to t^3
+  units::CumulativeSimpson<MeterPerSecond, Seconds> simpson(Seconds(0.5));
+  units::CumulativeTrapezoid<MeterPerSecond, Seconds> trapezoid(Seconds(0.5));
+  MeterPerSecond speed[9];
+  Meter by_simpson[9], by_trapezoid[9];
+  for (int i = 0; i < 9; ++i)
+    speed[i] = MeterPerSecond(3. * (i * 0.5) * (i * 0.5));
+  simpson.process(speed, 9, by_simpson);
+  trapezoid.process(speed, 9, by_trapezoid);
+  // the first interval is a trapezoid, the rest is exact
+  const double first_error = 3. * 0.25 / 2. * 0.5 - 0.125;
+  EXPECT_NEAR(by_simpson[8].value(), 64. + first_error, 0.000001);
+  EXPECT_GT(by_trapezoid[8].value() - 64., 0.1);
+}
+
+TEST(CalculusTests, TimestampedSteps) {
+  const TimeStampMilliSeconds times[] = {
+      TimeStampMilliSeconds(1000), TimeStampMilliSeconds(1100),
+      TimeStampMilliSeconds(1300), TimeStampMilliSeconds(1400)};
+  // x(t) = t^2 in meters, with t in milliseconds
+  Meter position[4];
+  for (int i = 0; i < 4; ++i) {
+    const double t = double(times[i].value() - 1000);
+    position[i] = Meter(t * t);
+  }
+  units::CentralDifference<Meter, TimeStampMilliSeconds> central;
+  units::BackwardDifference<Meter, TimeStampMilliSeconds> backward;
+  typename units::CentralDifference<Meter, TimeStampMilliSeconds>::ResultUnit
+      rates[4];
+  EXPECT_EQ(central.process(position, times, 1, rates), 0u);
+  EXPECT_EQ(central.process(position + 1, times + 1, 3, rates), 2u);
+  EXPECT_NEAR(rates[0].value(), 200., 0.000001);
+  EXPECT_NEAR(rates[1].value(), 600., 0.000001);
+  EXPECT_EQ(backward.process(position, times, 4, rates), 3u);
+  EXPECT_NEAR(rates[0].value(), 100., 0.000001);
+  EXPECT_NEAR(rates[2].value(), 700., 0.000001);
+
+  units::CumulativeSimpson<MeterPerSecond, TimeStampMilliSeconds> integral;
+  MeterPerSecond speed[4];
+  typename units::CumulativeSimpson<MeterPerSecond,
+                                    TimeStampMilliSeconds>::ResultUnit
+      distance[4];
+  for (int i = 0; i < 4; ++i)
+    speed[i] = MeterPerSecond(2.);
+  integral.process(speed, times, 4, distance);
+  EXPECT_NEAR(units::unit_cast<Meter>(distance[3]).value(), 0.8, 0.000001);
+}
@@ -13,3 +13,53 @@ TEST(CommonChronoTests, BasicConversions) {
   PhysTime<int, std::ratio<1>> other_seconds = units::unit_cast(ch_seconds);
   EXPECT_EQ(other_seconds.value(), ch_seconds.count());
 }
+
+using TimeStampMilliSeconds =
+    units::AbsolutePhysicalUnit<int64_t, std::milli, int64_t, std::ratio<0>,
+                                std::ratio<0>, std::ratio<0>, std::ratio<1>>;
+using TimeStampSince2024 =
+    units::AbsolutePhysicalUnit<double, std::ratio<1>, double,
+                                std::ratio<1704067200>, std::ratio<0>,
+                                std::ratio<0>, std::ratio<1>>;
+using SystemSeconds =
+    std::chrono::time_point<std::chrono::system_clock, std::chrono::seconds>;
+using SystemMicroSeconds =
+    std::chrono::time_point<std::chrono::system_clock,
+                            std::chrono::microseconds>;
+
+TEST(CommonChronoTests, TimePointConversions) {
+  constexpr SystemSeconds tp{std::chrono::seconds(1704067260)};
+  constexpr TimeStampMilliSeconds ms =
+      units::unit_cast<TimeStampMilliSeconds>(tp);
+  static_assert(ms.value() == 1704067260000, "Rescaled at compile time");
+  auto same = units::unit_cast(tp);
+  EXPECT_EQ(same.value(), 1704067260);
+
+  TimeStampSince2024 since = units::unit_cast<TimeStampSince2024>(tp);
+  EXPECT_NEAR(since.value(), 60., 0.000001);
+
+  SystemMicroSeconds back =
+      std::chrono::time_point_cast<SystemMicroSeconds>(since);
+  EXPECT_EQ(back.time_since_epoch().count(), 1704067260000000);
+  constexpr SystemSeconds round_trip =
+      std::chrono::time_point_cast<SystemSeconds>(ms);
+  static_assert(round_trip == tp, "Round trip must be exact");
+}
+
+TEST(CommonChronoTests, BulkTimestamps) {
+  // 100 MHz hardware ticks counted from the start of 2024
+  const uint64_t ticks[] = {0, 100, 100000000, 250000000};
+  TimeStampMilliSeconds unix_ms[4];
+  units::timestamp_cast_n<TimeStampMilliSeconds, std::ratio<1, 100000000>,
+                          std::ratio<1704067200>>(ticks, 4, unix_ms);
+  EXPECT_EQ(unix_ms[0].value(), 1704067200000);
+  EXPECT_EQ(unix_ms[1].value(), 1704067200000);
+  EXPECT_EQ(unix_ms[2].value(), 1704067201000);
+  EXPECT_EQ(unix_ms[3].value(), 1704067202500);
+
+  TimeStampSince2024 seconds[4];
+  units::timestamp_cast_n<TimeStampSince2024, std::ratio<1, 100000000>,
+                          std::ratio<1704067200>>(ticks, 4, seconds);
+  EXPECT_NEAR(seconds[1].value(), 0.000001, 1e-12);
+  EXPECT_NEAR(seconds[3].value(), 2.5, 1e-12);
+}
@@ -0,0 +1,123 @@
+#include "phys_circular.hpp"
+#include <cmath>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+using Heading = units::AbsoluteAngle<double>;
+using SignedHeading = units::AbsoluteAngle<double, std::ratio<1>, true>;
+using HeadingDiff = units::PhysicalUnitAngle<double, std::ratio<1>>;
+// Binary angle, 65536 units per turn
+using Bam = units::AbsoluteAngle<std::int32_t, std::ratio<360, 65536>>;
+using BamDiff = units::PhysicalUnitAngle<std::int32_t, std::ratio<360, 65536>>;
+using UnsignedBam =
+    units::AbsoluteAngle<std::uint32_t, std::ratio<360, 65536>>;
+using CentiDegree = units::AbsoluteAngle<int, std::centi, true>;
+
+TEST(CircularTests, Mean) {
+  const Heading across[] = {Heading(350), Heading(10)};
+  EXPECT_NEAR(units::circular_mean(across, 2).value(), 0, 1e-12);
+  EXPECT_NEAR(units::circular_variance(across, 2),
+              1 - std::cos(10 * 3.14159265358979323846 / 180), 1e-12);
+
+  const Bam bams[] = {Bam(65000), Bam(0), Bam(536)};
+  EXPECT_EQ(units::circular_mean(bams, 3).value(), 0);
+  const CentiDegree south[] = {CentiDegree(17900), CentiDegree(-17900)};
+  EXPECT_EQ(units::circular_mean(south, 2).value(), -18000);
+
+  std::vector<Heading> spread;
+  for (int i = 0; i < 1000; ++i)
+    spread.push_back(Heading(i * 0.36));
+  EXPECT_NEAR(units::circular_stats(spread.data(), spread.size()).resultant,
+              0, 1e-12);
+  EXPECT_EQ(units::circular_variance(spread.data(), 0), 1.);
+}
+
+TEST(CircularTests, ShortestArc) {
+  EXPECT_EQ(units::shortest_arc(Heading(350), Heading(10)), HeadingDiff(20));
+  EXPECT_EQ(units::shortest_arc(Heading(10), Heading(350)), HeadingDiff(-20));
+  EXPECT_EQ(units::shortest_arc(Heading(0), Heading(180)), HeadingDiff(-180));
+  EXPECT_EQ(units::shortest_arc(SignedHeading(-170), SignedHeading(170)),
+            HeadingDiff(-20));
+
+  const Bam from[] = {Bam(65000), Bam(0), Bam(100), Bam(40000)};
+  const Bam to[] = {Bam(500), Bam(32768), Bam(65535), Bam(7000)};
+  BamDiff out[4];
+  units::shortest_arc_n(from, to, 4, out);
+  EXPECT_EQ(out[0], BamDiff(1036));
+  EXPECT_EQ(out[1], BamDiff(-32768));
+  EXPECT_EQ(out[2], BamDiff(-101));
+  EXPECT_EQ(out[3], BamDiff(32536));
+}
+
+TEST(CircularTests, Interpolate) {
+  EXPECT_NEAR(units::interpolate(Heading(350), Heading(10), 0.75).value(), 5,
+              1e-12);
+  EXPECT_NEAR(units::interpolate(Heading(10), Heading(350), 0.75).value(),
+              355, 1e-12);
+  EXPECT_NEAR(
+      units::interpolate(SignedHeading(170), SignedHeading(-170), 0.5).value(),
+      -180, 1e-12);
+
+  // Smoothing in place; small steps still move integral angles
+  Bam smoothed[] = {Bam(65530), Bam(10), Bam(1000)};
+  const Bam readings[] = {Bam(6), Bam(65535), Bam(1003)};
+  units::interpolate_n(smoothed, readings, 3, 0.25, smoothed);
+  EXPECT_EQ(smoothed[0], Bam(65533));
+  EXPECT_EQ(smoothed[1], Bam(7));
+  EXPECT_EQ(smoothed[2], Bam(1001));
+}
+
+TEST(CircularTests, Unwrap) {
+  std::vector<Heading> turning;
+  for (int i = 0; i < 1000; ++i)
+    turning.push_back(Heading(350 + i * 1.5));
+  std::vector<HeadingDiff> out(turning.size());
+  units::unwrap_n(turning.data(), turning.size(), out.data());
+  for (int i = 0; i < 1000; ++i)
+    ASSERT_NEAR(out[i].value(), 350 + i * 1.5, 1e-9);
+
+  // Streams continue across calls
+  units::AngleUnwrapper<Bam, std::int64_t> unwrapper;
+  const Bam first[] = {Bam(60000), Bam(20000), Bam(45000)};
+  const Bam second[] = {Bam(5000), Bam(30000)};
+  units::PhysicalUnitAngle<std::int64_t, std::ratio<360, 65536>> total[3];
+  unwrapper.push_n(first, 3, total);
+  EXPECT_EQ(total[1].value(), 85536);
+  EXPECT_EQ(total[2].value(), 110536);
+  unwrapper.push_n(second, 2, total);
+  EXPECT_EQ(total[0].value(), 136072);
+  EXPECT_EQ(total[1].value(), 161072);
+  EXPECT_EQ(unwrapper.value().value(), 161072);
+}
+
+TEST(CircularTests, UnsignedBinaryAngles) {
+  // Arcs are signed even when the angles are not
+  EXPECT_EQ(units::shortest_arc(UnsignedBam(65000), UnsignedBam(500)).value(),
+            1036);
+  EXPECT_EQ(units::shortest_arc(UnsignedBam(500), UnsignedBam(65000)).value(),
+            -1036);
+  static_assert(std::is_same<decltype(units::shortest_arc(UnsignedBam(),
+                                                          UnsignedBam())),
+                             units::PhysicalUnitAngle<
+                                 std::int32_t, std::ratio<360, 65536>>>::value,
+                "Arcs of unsigned angles are signed");
+
+  UnsignedBam smoothed[] = {UnsignedBam(500), UnsignedBam(65000)};
+  const UnsignedBam readings[] = {UnsignedBam(65000), UnsignedBam(500)};
+  units::interpolate_n(smoothed, readings, 2, 0.5, smoothed);
+  EXPECT_EQ(smoothed[0].value(), 65518u);
+  EXPECT_EQ(smoothed[1].value(), 65518u);
+
+  const UnsignedBam turning[] = {UnsignedBam(65000), UnsignedBam(500),
+                                 UnsignedBam(64000)};
+  units::PhysicalUnitAngle<std::int32_t, std::ratio<360, 65536>> total[3];
+  units::AngleUnwrapper<UnsignedBam> unwrapper;
+  unwrapper.push_n(turning, 3, total);
+  EXPECT_EQ(total[1].value(), 66036);
+  EXPECT_EQ(total[2].value(), 64000);
+
+  // Means below zero go up a turn
+  const UnsignedBam west[] = {UnsignedBam(65000), UnsignedBam(64000)};
+  EXPECT_EQ(units::circular_mean(west, 2).value(), 64500u);
+}
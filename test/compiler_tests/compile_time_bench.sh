@@ -0,0 +1,98 @@
+#!/bin/bash
+
+# Name of the script: compile_time_bench.sh
+# Compares the build cost of PhysicalUnit and the packed PackedUnit alias on a
+# generated translation unit with many distinct unit expressions.
+# Usage: [RUNS=3] ./compile_time_bench.sh [expressions]
+
+COMPILERS=("g++" "clang++")
+STANDARDS=("14" "17" "20" "23")
+VARIANTS=("PhysicalUnit" "PackedUnit")
+EXPRESSIONS="${1:-343}"
+RUNS="${RUNS:-3}"
+
+PROJECT_ROOT="$(cd "$(dirname "$0")/../.." && pwd)"
+COMPILER_TESTS="${PROJECT_ROOT}/test/compiler_tests"
+TEMP_BUILD_DIR="${COMPILER_TESTS}/build_time"
+STRESS_TU="${TEMP_BUILD_DIR}/stress.cpp"
+
+function generate_stress_tu()
+{
+    {
+        echo '#include "phys_dim.hpp"'
+        echo ''
+        echo '#define R(n) std::ratio<n>'
+        echo '#define U(l, m, t) units::UNIT_TEMPLATE<double, R(1), R(l), R(m), R(t)>'
+        echo ''
+        for ((i = 0; i < EXPRESSIONS; i++)); do
+            local l=$((i % 7 - 3)) m=$((i / 7 % 7 - 3)) t=$((i / 49 % 7 - 3))
+            local a="U(${l}, ${m}, ${t})" b="U(${m}, ${t}, ${l})"
+            echo "auto expr_${i}(${a} x, ${b} y) {"
+            echo "  return (x * y) / (y * y) * x + x * (x / y);"
+            echo "}"
+        done
+    } > "${STRESS_TU}"
+}
+
+# Prints the best of RUNS wall times in seconds, peak resident kilobytes,
+# object bytes and the bytes taken by the mangled symbol names
+function measure()
+{
+    local compiler=$1 standard=$2 variant=$3
+    local object="${TEMP_BUILD_DIR}/stress_${variant}.o"
+    local flags=(-std=c++"${standard}" -g -c -I"${PROJECT_ROOT}/inc"
+                 -DUNIT_TEMPLATE="${variant}" "${STRESS_TU}" -o "${object}")
+    local start end seconds="" memory="n/a"
+
+    for ((run = 0; run < RUNS; run++)); do
+        rm -f "${object}"
+        start=$(date +%s.%N)
+        if [ -x /usr/bin/time ]; then
+            memory=$(/usr/bin/time -f "%M" "${compiler}" "${flags[@]}" 2>&1 >/dev/null |
+                     tail -n 1)
+        else
+            "${compiler}" "${flags[@]}" || return 1
+        fi
+        end=$(date +%s.%N)
+        [ -f "${object}" ] || return 1
+        seconds=$(awk -v s="${start}" -v e="${end}" -v best="${seconds}" \
+                  'BEGIN { t = e - s; print (best == "" || t < best) ? t : best }')
+    done
+
+    local object_size symbols
+    object_size=$(stat -c %s "${object}")
+    symbols=$(nm --no-demangle "${object}" | awk '{ sum += length($NF) } END { print sum }')
+    printf "| %-8s | C++%-3s | %-12s | %7.2f | %9s | %9s | %9s |\n" \
+        "${compiler}" "${standard}" "${variant}" "${seconds}" "${memory}" \
+        "${object_size}" "${symbols}"
+    rm -f "${object}"
+}
+
+function main()
+{
+    mkdir -p "${TEMP_BUILD_DIR}"
+    generate_stress_tu
+
+    echo "Stress translation unit with ${EXPRESSIONS} expressions"
+    echo ""
+    printf "| %-8s | %-6s | %-12s | %-7s | %-9s | %-9s | %-9s |\n" \
+        "Compiler" "Std" "Dimensions" "Time s" "Peak KiB" "Object B" "Symbols B"
+    echo "|----------|--------|--------------|---------|-----------|-----------|-----------|"
+
+    for COMPILER in "${COMPILERS[@]}"; do
+        if ! command -v "${COMPILER}" > /dev/null; then
+            echo "| ${COMPILER} not found, skipped |"
+            continue
+        fi
+        for STANDARD in "${STANDARDS[@]}"; do
+            for VARIANT in "${VARIANTS[@]}"; do
+                measure "${COMPILER}" "${STANDARD}" "${VARIANT}" ||
+                    echo "| ${COMPILER} | C++${STANDARD} | ${VARIANT} | build failed |"
+            done
+        done
+    done
+
+    rm -rf "${TEMP_BUILD_DIR}"
+}
+
+main "$@"
@@ -0,0 +1,140 @@
+#!/bin/bash
+
+# Name of the script: module_build_bench.sh
+# Compares the build time of many translation units using the library through
+# plain includes, a precompiled header and the phys_units C++20 module.
+# Usage: ./module_build_bench.sh [translation_units]
+
+COMPILERS=("g++" "clang++")
+UNITS="${1:-50}"
+
+PROJECT_ROOT="$(cd "$(dirname "$0")/../.." && pwd)"
+COMPILER_TESTS="${PROJECT_ROOT}/test/compiler_tests"
+TEMP_BUILD_DIR="${COMPILER_TESTS}/build_modules"
+INCLUDE_DIR="${PROJECT_ROOT}/inc"
+
+function generate_sources()
+{
+    {
+        echo '#include "phys_si.hpp"'
+        echo '#include "phys_stats.hpp"'
+        echo '#include "phys_vector.hpp"'
+    } > "${TEMP_BUILD_DIR}/bench_all.hpp"
+
+    for ((i = 0; i < UNITS; i++)); do
+        {
+            echo '#ifdef USE_MODULE'
+            echo 'import phys_units;'
+            echo '#else'
+            echo '#include "bench_all.hpp"'
+            echo '#endif'
+            echo ''
+            echo "double tu_${i}(double x) {"
+            echo '  using namespace units::si;'
+            echo "  Watt<> power = Volt<>(x) * Ampere<>(${i}.5);"
+            echo '  Joule<> energy = power * Second<>(x);'
+            echo '  units::RunningStats<Joule<>> stats;'
+            echo '  stats.push(energy);'
+            echo '  units::Vec3<Newton<>> force(Newton<>(x), Newton<>(1.), Newton<>(2.));'
+            echo '  return stats.mean().value() + units::norm(force).value() +'
+            echo '         std::sin(Degree<>(x));'
+            echo '}'
+        } > "${TEMP_BUILD_DIR}/tu_${i}.cpp"
+    done
+}
+
+function now()
+{
+    date +%s.%N
+}
+
+function elapsed()
+{
+    awk -v s="$1" -v e="$2" 'BEGIN { printf "%.2f", e - s }'
+}
+
+# Compiles every translation unit with the given flags, prints the seconds
+function build_units()
+{
+    local compiler=$1
+    shift
+    local start end
+    start=$(now)
+    for ((i = 0; i < UNITS; i++)); do
+        "${compiler}" -std=c++20 -c "$@" "tu_${i}.cpp" -o "tu_${i}.o" || return 1
+    done
+    end=$(now)
+    elapsed "${start}" "${end}"
+}
+
+function print_row()
+{
+    printf "| %-8s | %-18s | %8s | %8s |\n" "$1" "$2" "$3" "$4"
+}
+
+function bench_compiler()
+{
+    local compiler=$1 start end prepare total
+
+    # Plain includes
+    total=$(build_units "${compiler}" -I"${INCLUDE_DIR}") || total="failed"
+    print_row "${compiler}" "includes" "-" "${total}"
+
+    # Precompiled header
+    start=$(now)
+    if [[ "${compiler}" == clang* ]]; then
+        "${compiler}" -std=c++20 -I"${INCLUDE_DIR}" -x c++-header bench_all.hpp \
+            -o bench_all.hpp.pch && prepare=$(elapsed "${start}" "$(now)")
+        total=$(build_units "${compiler}" -I"${INCLUDE_DIR}" -include-pch bench_all.hpp.pch) ||
+            total="failed"
+    else
+        "${compiler}" -std=c++20 -I"${INCLUDE_DIR}" -x c++-header bench_all.hpp \
+            -o bench_all.hpp.gch && prepare=$(elapsed "${start}" "$(now)")
+        total=$(build_units "${compiler}" -I"${INCLUDE_DIR}") || total="failed"
+    fi
+    rm -f bench_all.hpp.gch bench_all.hpp.pch
+    print_row "${compiler}" "precompiled header" "${prepare:-failed}" "${total}"
+
+    # Module
+    prepare=""
+    start=$(now)
+    if [[ "${compiler}" == clang* ]]; then
+        "${compiler}" -std=c++20 -I"${INCLUDE_DIR}" --precompile -x c++-module \
+            "${INCLUDE_DIR}/phys_units.cppm" -o phys_units.pcm &&
+            prepare=$(elapsed "${start}" "$(now)")
+        total=$(build_units "${compiler}" -DUSE_MODULE \
+                -fmodule-file=phys_units=phys_units.pcm) || total="failed"
+    else
+        "${compiler}" -std=c++20 -fmodules-ts -I"${INCLUDE_DIR}" -c -x c++ \
+            "${INCLUDE_DIR}/phys_units.cppm" -o phys_units.o &&
+            prepare=$(elapsed "${start}" "$(now)")
+        total=$(build_units "${compiler}" -fmodules-ts -DUSE_MODULE) ||
+            total="failed"
+    fi
+    print_row "${compiler}" "module" "${prepare:-failed}" "${total}"
+}
+
+function main()
+{
+    rm -rf "${TEMP_BUILD_DIR}"
+    mkdir -p "${TEMP_BUILD_DIR}"
+    cd "${TEMP_BUILD_DIR}" || exit 1
+    generate_sources
+
+    echo "Building ${UNITS} translation units, times in seconds"
+    echo ""
+    print_row "Compiler" "Library through" "Prepare" "Units"
+    echo "|----------|--------------------|----------|----------|"
+    for COMPILER in "${COMPILERS[@]}"; do
+        if ! command -v "${COMPILER}" > /dev/null; then
+            print_row "${COMPILER}" "not found, skipped" "-" "-"
+            continue
+        fi
+        bench_compiler "${COMPILER}"
+    done
+
+    cd "${COMPILER_TESTS}" || exit 1
+    rm -rf "${TEMP_BUILD_DIR}"
+}
+
+main "$@"
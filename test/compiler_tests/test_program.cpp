@@ -6,6 +6,28 @@
 #include "phys_chrono.hpp"
 #include "phys_math.hpp"
 #include "phys_angle.hpp"
+#include "phys_stats.hpp"
+#include "phys_timing.hpp"
+#include "phys_lookup.hpp"
+#include "phys_calculus.hpp"
+#include "phys_vector.hpp"
+#include "phys_timeseries.hpp"
+#include "phys_dim.hpp"
+#include "phys_si.hpp"
+#include "phys_algorithm.hpp"
+#include "phys_ring.hpp"
+#include "phys_filter.hpp"
+#include "phys_field.hpp"
+#include "phys_record.hpp"
+#include "phys_span.hpp"
+#include "phys_fixed.hpp"
+#include "phys_metrics.hpp"
+#include "phys_pipeline.hpp"
+#include "phys_fastmath.hpp"
+#include "phys_geodesy.hpp"
+#include "phys_circular.hpp"
+#include "phys_random.hpp"
+#include "phys_histogram.hpp"
 
 
 using AngleInDegrees = units::PhysicalUnitAngle<int, std::ratio<1>>;
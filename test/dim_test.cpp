@@ -0,0 +1,100 @@
+#include "phys_dim.hpp"
+#include <gtest/gtest.h>
+#include <type_traits>
+
+using Meter = units::PackedUnit<int, std::ratio<1>, std::ratio<1>>;
+using CentiMeter = units::PackedUnit<int, std::centi, std::ratio<1>>;
+using MeterSquared = units::PackedUnit<int, std::ratio<1>, std::ratio<2>>;
+using Second = units::PackedUnit<double, std::ratio<1>, std::ratio<0>,
+                                 std::ratio<0>, std::ratio<1>>;
+using MeterPerSecond = units::PackedUnit<double, std::ratio<1>, std::ratio<1>,
+                                         std::ratio<0>, std::ratio<-1>>;
+using Volt = units::PackedUnit<double, std::ratio<1>, std::ratio<2>,
+                               std::ratio<1>, std::ratio<-3>, std::ratio<-1>>;
+using RootHertz = units::PackedUnit<double, std::ratio<1>, std::ratio<0>,
+                                    std::ratio<0>, std::ratio<-1, 2>>;
+
+using UnpackedMeter = units::PhysicalUnit<int, std::ratio<1>, std::ratio<1>>;
+using UnpackedVolt =
+    units::PhysicalUnit<double, std::ratio<1>, std::ratio<2>, std::ratio<1>,
+                        std::ratio<-3>, std::ratio<-1>>;
+
+TEST(PackedDimTests, Packing) {
+  using Code = units::PackDim<std::ratio<2>, std::ratio<1>, std::ratio<-3>,
+                              std::ratio<-1>>::type;
+  static_assert(std::is_same<Code, Volt::Dimension>::value,
+                "Trailing dimensions default to zero");
+  static_assert(units::DimPacking::field(Code::code, 0) == 24, "Length");
+  static_assert(units::DimPacking::field(Code::code, 2) == -36, "Time");
+  static_assert(
+      std::is_same<units::DimExponent<RootHertz::Dimension, 2>,
+                   std::ratio<-1, 2>>::value,
+      "Fractional exponents are kept");
+  static_assert(std::is_same<units::PackUnit<UnpackedVolt>::type, Volt>::value,
+                "Packing a PhysicalUnit");
+  static_assert(
+      std::is_same<units::UnpackUnit<Volt>::type, UnpackedVolt>::value,
+      "Unpacking to a PhysicalUnit");
+}
+
+TEST(PackedDimTests, Arithmetic) {
+  Meter a(3), b(4);
+  auto area = a * b;
+  static_assert(std::is_same<decltype(area), MeterSquared>::value,
+                "Meters times meters are square meters");
+  EXPECT_EQ(area, MeterSquared(12));
+  EXPECT_EQ(area / a, b);
+  EXPECT_EQ(a + b, Meter(7));
+  EXPECT_EQ(b - a, Meter(1));
+  EXPECT_TRUE(a < b);
+  EXPECT_EQ(int(b / a), 1);
+
+  MeterPerSecond speed = Meter(10) / Second(4.);
+  EXPECT_DOUBLE_EQ(speed.value(), 2.5);
+  auto inverse = 1. / Second(0.5);
+  EXPECT_DOUBLE_EQ(inverse.value(), 2.);
+  auto root = RootHertz(3.) * RootHertz(3.);
+  static_assert(std::is_same<decltype(root), decltype(inverse)>::value,
+                "Two square roots of hertz make a hertz");
+  Meter c(2);
+  c += Meter(5);
+  c *= 2;
+  EXPECT_EQ(c.value(), 14);
+}
+
+TEST(PackedDimTests, Conversions) {
+  constexpr CentiMeter cm(units::unit_cast<CentiMeter>(Meter(2)));
+  static_assert(cm.value() == 200, "Compile-time conversion");
+  Meter m(CentiMeter(250));
+  EXPECT_EQ(m.value(), 2);
+
+  UnpackedMeter unpacked = Meter(5).unpacked();
+  EXPECT_EQ(unpacked.value(), 5);
+  Meter packed(UnpackedMeter(7));
+  EXPECT_EQ(packed.value(), 7);
+  CentiMeter scaled(UnpackedMeter(7));
+  EXPECT_EQ(scaled.value(), 700);
+}
+
+TEST(PackedDimTests, FieldArithmetic) {
+  using units::DimPacking;
+  constexpr units::DimCode lhs =
+      DimPacking::place(-36, 2) | DimPacking::place(127, 7);
+  constexpr units::DimCode rhs =
+      DimPacking::place(-100, 2) | DimPacking::place(-128, 7);
+  static_assert(DimPacking::field(DimPacking::add(lhs, rhs), 2) == -136 + 256,
+                "Fields wrap without touching the neighbours");
+  static_assert(!DimPacking::adds(lhs, rhs), "Overflow is detected");
+  static_assert(DimPacking::field(DimPacking::add(lhs, rhs), 7) == -1,
+                "Fields are independent");
+  static_assert(DimPacking::field(DimPacking::negate(lhs), 2) == 36,
+                "Negation");
+  static_assert(DimPacking::negates(lhs), "Negation fits");
+  static_assert(!DimPacking::negates(rhs), "-128 cannot be negated");
+}
+
+TEST(PackedDimTests, Dimensionless) {
+  Meter a(6), b(3);
+  EXPECT_EQ((a / b) * b, Meter(6));
+  EXPECT_EQ(b * (a / b), Meter(6));
+}
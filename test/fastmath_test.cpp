@@ -0,0 +1,37 @@
+#include "phys_fastmath.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+
+static const double pi = 3.14159265358979323846;
+
+TEST(FastMathTests, Functions) {
+  for (double x = -10; x <= 10; x += 0.001) {
+    double s, c;
+    units::FastMath::sincos(x, s, c);
+    ASSERT_NEAR(s, std::sin(x), 1e-15);
+    ASSERT_NEAR(c, std::cos(x), 1e-15);
+    ASSERT_NEAR(units::FastMath::sqrt(std::fabs(x)), std::sqrt(std::fabs(x)),
+                1e-15);
+    for (double y = -3; y <= 3; y += 0.75)
+      ASSERT_NEAR(units::FastMath::atan2(y, x), std::atan2(y, x), 1e-15);
+  }
+  for (double x = 1e-300; x < 1e300; x *= 1.37)
+    ASSERT_NEAR(units::FastMath::log(x), std::log(x),
+                4.5e-16 * std::fabs(std::log(x)) + 1e-300);
+  for (double x = 1. / 4096; x <= 4; x += 1. / 4096)
+    ASSERT_NEAR(units::FastMath::log(x), std::log(x), 1e-15);
+  EXPECT_EQ(units::FastMath::log(1.), 0.);
+  EXPECT_EQ(units::FastMath::sqrt(0.), 0.);
+  EXPECT_EQ(units::FastMath::atan2(0., 0.), 0.);
+  EXPECT_NEAR(units::FastMath::atan2(0., -1.), pi, 1e-15);
+  EXPECT_NEAR(units::FastMath::atan2(-1., 0.), -pi / 2, 1e-15);
+}
+
+TEST(FastMathTests, AngleRadians) {
+  using Degrees = units::AbsoluteAngle<double, std::ratio<1>, true>;
+  using Radians = units::AbsoluteAngle<double, units::RadianRatio, true>;
+  const double degree = units::AngleRadians<Degrees>::scale;
+  const double radian = units::AngleRadians<Radians>::scale;
+  EXPECT_DOUBLE_EQ(degree, pi / 180);
+  EXPECT_EQ(radian, 1.);
+}
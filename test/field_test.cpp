@@ -0,0 +1,88 @@
+#include "phys_field.hpp"
+#include "phys_si.hpp"
+#include <gtest/gtest.h>
+#include <type_traits>
+
+using Pascal = units::si::Pascal<double>;
+using Meter = units::si::Meter<double>;
+using MilliMeter = units::si::MilliMeter<double>;
+using TempKelvin = units::si::TempKelvin<float>;
+
+TEST(FieldTests, Layout) {
+  units::Field<Pascal, 2> field({4, 3}, Pascal(1.));
+  EXPECT_EQ(field.extent(0), 4u);
+  EXPECT_EQ(field.extent(1), 3u);
+  EXPECT_EQ(field.stride(1), 6);
+  field.set(3, 2, Pascal(5.));
+  EXPECT_EQ(field(3, 2), Pascal(5.));
+  EXPECT_EQ(field.data()[3 + 2 * field.stride(1)], 5.);
+
+  field.fill_boundary(Pascal(0.));
+  EXPECT_EQ(field(-1, -1), Pascal(0.));
+  EXPECT_EQ(field(4, 2), Pascal(0.));
+  EXPECT_EQ(field(0, 0), Pascal(1.));
+  field.clamp_boundary();
+  EXPECT_EQ(field(4, 2), Pascal(5.));
+  EXPECT_EQ(field(4, 3), Pascal(5.));
+  EXPECT_EQ(field(-1, 3), Pascal(1.));
+
+  units::Field<Pascal, 3> volume({2, 2, 2}, Pascal(2.));
+  volume.fill_boundary(Pascal(-1.));
+  EXPECT_EQ(volume(0, 0, -1), Pascal(-1.));
+  EXPECT_EQ(volume(1, 1, 2), Pascal(-1.));
+  EXPECT_EQ(volume(1, 1, 1), Pascal(2.));
+}
+
+TEST(FieldTests, Laplacian) {
+  using Derivative = units::FieldDerivative<Pascal, Meter>;
+  static_assert(std::is_same<Derivative::LaplacianUnit,
+                             decltype(Pascal() / (Meter() * Meter()))>::value,
+                "Laplacian of pressure is in pascals per square meter");
+  units::Field<Pascal, 2> pressure({40, 30});
+  for (int y = -1; y <= 30; ++y)
+    for (int x = -1; x <= 40; ++x)
+      pressure.set(x, y, Pascal(0.25 * (x * x + 3 * y * y)));
+  units::Field<Derivative::LaplacianUnit, 2> out({40, 30});
+  EXPECT_TRUE(units::laplacian(pressure, Meter(0.5), out));
+  for (int y = 0; y < 30; ++y)
+    for (int x = 0; x < 40; ++x)
+      EXPECT_NEAR(out(x, y).value(), 8., 1e-9);
+
+  units::Field<Derivative::LaplacianUnit, 2> wrong({30, 40});
+  EXPECT_FALSE(units::laplacian(pressure, Meter(0.5), wrong));
+}
+
+TEST(FieldTests, Gradient) {
+  using Derivative = units::FieldDerivative<TempKelvin, MilliMeter>;
+  static_assert(
+      std::is_same<Derivative::GradientUnit,
+                   decltype(units::si::Kelvin<float>() / MilliMeter())>::value,
+      "Gradient of an absolute temperature is in kelvins per millimeter");
+  units::Field<TempKelvin, 3> temperature({8, 6, 5});
+  for (int z = 0; z < 5; ++z)
+    for (int y = 0; y < 6; ++y)
+      for (int x = 0; x < 8; ++x)
+        temperature.set(x, y, z, TempKelvin(float(300 + x + 2 * z)));
+  temperature.clamp_boundary();
+  units::Field<Derivative::GradientUnit, 3> dz({8, 6, 5});
+  EXPECT_TRUE(units::gradient(temperature, MilliMeter(2.), 2, dz));
+  EXPECT_FLOAT_EQ(dz(3, 3, 2).value(), 1.f);
+  EXPECT_FLOAT_EQ(dz(3, 3, 0).value(), 0.5f); // halo clamped to the edge
+  EXPECT_FALSE(units::gradient(temperature, MilliMeter(2.), 3, dz));
+}
+
+TEST(FieldTests, Threads) {
+  units::Field<Pascal, 3> in({70, 50, 33});
+  for (int z = -1; z <= 33; ++z)
+    for (int y = -1; y <= 50; ++y)
+      for (int x = -1; x <= 70; ++x)
+        in.set(x, y, z, Pascal(double((x * 7 + y * 13 + z * 29) % 17)));
+  using Out = units::FieldDerivative<Pascal, Meter>::LaplacianUnit;
+  units::Field<Out, 3> single({70, 50, 33}), threaded({70, 50, 33});
+  units::laplacian(in, Meter(1.), single);
+  units::laplacian(in, Meter(1.), threaded, units::StencilExecutor(4));
+  for (int z = 0; z < 33; ++z)
+    for (int y = 0; y < 50; ++y)
+      for (int x = 0; x < 70; ++x)
+        ASSERT_EQ(single(x, y, z), threaded(x, y, z));
+}
@@ -0,0 +1,127 @@
+#include "phys_filter.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+
+using Pascal = units::si::Pascal<float>;
+using AdcCounts = units::PhysicalUnit<int16_t, std::ratio<1, 4096>,
+                                      std::ratio<2>, std::ratio<1>,
+                                      std::ratio<-3>, std::ratio<-1>>;
+using units::Coefficient;
+
+TEST(FilterTests, FirChunks) {
+  const Coefficient<> taps[4] = {Coefficient<>(0.25), Coefficient<>(0.25),
+                                 Coefficient<>(0.25), Coefficient<>(0.25)};
+  units::FirFilter<Pascal, 4> whole(taps), chunked(taps);
+  Pascal in[200], a[200], b[200];
+  for (int i = 0; i < 200; ++i)
+    in[i] = Pascal(float(i % 13));
+  whole.process(in, 200, a);
+  chunked.process(in, 7, b);
+  chunked.process(in + 7, 100, b + 7);
+  chunked.process(in + 107, 93, b + 107);
+  for (int i = 0; i < 200; ++i)
+    EXPECT_EQ(a[i], b[i]);
+  EXPECT_FLOAT_EQ(a[0].value(), 0.f);
+  EXPECT_FLOAT_EQ(a[3].value(), 1.5f);
+  EXPECT_FLOAT_EQ(a[150].value(),
+                  (in[150].value() + in[149].value() + in[148].value() +
+                   in[147].value()) /
+                      4);
+}
+
+TEST(FilterTests, FirFixedPoint) {
+  const Coefficient<> taps[3] = {Coefficient<>(0.5), Coefficient<>(0.25),
+                                 Coefficient<>(0.25)};
+  units::FirFilter<AdcCounts, 3> filter(taps);
+  filter.reset(AdcCounts(100));
+  const AdcCounts in[4] = {AdcCounts(101), AdcCounts(-32768), AdcCounts(32767),
+                           AdcCounts(32767)};
+  AdcCounts out[4];
+  filter.process(in, 4, out);
+  EXPECT_EQ(out[0].value(), 101); // 50.5 + 25 + 25, rounded
+  EXPECT_EQ(out[1].value(), -16334);
+  EXPECT_EQ(out[2].value(), 8217);
+  EXPECT_EQ(out[3].value(), 16383);
+
+  const Coefficient<> gain[1] = {Coefficient<>(1.5)};
+  units::FirFilter<AdcCounts, 1> amplifier(gain);
+  amplifier.process(in, 4, out);
+  EXPECT_EQ(out[0].value(), 152);
+  EXPECT_EQ(out[1].value(), -32768); // saturated
+  EXPECT_EQ(out[2].value(), 32767);
+}
+
+TEST(FilterTests, Design) {
+  const units::Biquad hz = units::lowpass(units::si::Hertz<>(100.),
+                                          units::si::Hertz<int>(1000));
+  const units::Biquad khz = units::lowpass(units::si::Hertz<int>(100),
+                                           units::si::KiloHertz<>(1.));
+  EXPECT_DOUBLE_EQ(double(hz.b0), double(khz.b0));
+  EXPECT_DOUBLE_EQ(double(hz.a1), double(khz.a1));
+  const double dc = (double(hz.b0) + double(hz.b1) + double(hz.b2)) /
+                    (1 + double(hz.a1) + double(hz.a2));
+  EXPECT_NEAR(dc, 1., 1e-12);
+
+  const auto low = units::fir_lowpass<31>(units::si::Hertz<>(50.),
+                                          units::si::KiloHertz<>(1.));
+  const auto high = units::fir_highpass<31>(units::si::Hertz<>(50.),
+                                            units::si::KiloHertz<>(1.));
+  double lowSum = 0, highSum = 0;
+  for (int k = 0; k < 31; ++k) {
+    lowSum += double(low[k]);
+    highSum += double(high[k]);
+    EXPECT_DOUBLE_EQ(double(low[k]), double(low[30 - k]));
+  }
+  EXPECT_NEAR(lowSum, 1., 1e-12);
+  EXPECT_NEAR(highSum, 0., 1e-12);
+}
+
+TEST(FilterTests, FirResponse) {
+  const auto taps = units::fir_lowpass<63>(units::si::Hertz<>(50.),
+                                           units::si::KiloHertz<>(1.));
+  units::FirFilter<Pascal, 63> filter(taps);
+  const double pi = 3.14159265358979323846;
+  Pascal in[1000], out[1000];
+  for (int i = 0; i < 1000; ++i)
+    in[i] = Pascal(float(10. + std::sin(2 * pi * 300. * i / 1000.)));
+  filter.process(in, 1000, out);
+  for (int i = 100; i < 1000; ++i)
+    EXPECT_NEAR(out[i].value(), 10.f, 0.01f);
+}
+
+TEST(FilterTests, Biquad) {
+  const units::Biquad sections[2] = {
+      units::lowpass(units::si::Hertz<>(10.), units::si::KiloHertz<>(1.)),
+      units::highpass(units::si::Hertz<>(1.), units::si::KiloHertz<>(1.))};
+  units::BiquadFilter<Pascal, 2> bandpass(sections);
+  units::BiquadFilter<Pascal> low({sections[0]});
+  units::BiquadFilter<AdcCounts, 1, 20> fixedLow({sections[0]});
+  Pascal in[4000], band[4000], out[4000];
+  AdcCounts adc[4000], adcOut[4000];
+  for (int i = 0; i < 4000; ++i) {
+    in[i] = Pascal(1000.f);
+    adc[i] = AdcCounts(1000);
+  }
+  bandpass.process(in, 2000, band);
+  bandpass.process(in + 2000, 2000, band + 2000);
+  low.process(in, 4000, out);
+  fixedLow.process(adc, 4000, adcOut);
+  EXPECT_NEAR(band[3999].value(), 0.f, 1.f);
+  EXPECT_NEAR(out[3999].value(), 1000.f, 0.05f);
+  EXPECT_NEAR(adcOut[3999].value(), 1000, 1);
+  for (int i = 0; i < 4000; i += 97)
+    EXPECT_NEAR(adcOut[i].value(), out[i].value(), 2.f);
+}
+
+TEST(FilterTests, MovingAverage) {
+  units::MovingAverage<AdcCounts, 4> average(AdcCounts(10));
+  const AdcCounts in[5] = {AdcCounts(12), AdcCounts(12), AdcCounts(-30),
+                           AdcCounts(0), AdcCounts(0)};
+  AdcCounts out[5];
+  average.process(in, 5, out);
+  EXPECT_EQ(out[0].value(), 11);  // 44 / 4
+  EXPECT_EQ(out[1].value(), 11);  // 44 / 4
+  EXPECT_EQ(out[2].value(), 1);   // 4 / 4
+  EXPECT_EQ(out[3].value(), -2);  // -6 / 4, rounded away from zero
+  EXPECT_EQ(out[4].value(), -5);  // -18 / 4
+}
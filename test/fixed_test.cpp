@@ -0,0 +1,139 @@
+#include "phys_fixed.hpp"
+#include "phys_si.hpp"
+#include "phys_span.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <type_traits>
+
+using Q16 = units::Fixed<int32_t, 16>;
+using Q15 = units::Fixed<int16_t, 15>;
+using Q8 = units::Fixed<int16_t, 8>;
+using Q16Down = units::Fixed<int32_t, 16, units::RoundDown>;
+
+TEST(FixedTests, Format) {
+  constexpr Q16 half(0.5);
+  static_assert(half.raw() == 32768, "Q16.16 one half");
+  static_assert(Q16(3).raw() == 3 << 16, "Integers are shifted");
+  static_assert(Q16(-1.25).to<double>() == -1.25, "Exact round trip");
+  EXPECT_EQ(Q16::from_raw(98304).to<double>(), 1.5);
+  EXPECT_EQ(Q16(2.75).to<int>(), 3);
+  EXPECT_EQ(Q16Down(2.75).to<int>(), 2);
+  EXPECT_EQ(Q16Down(-2.25).to<int>(), -3);
+  EXPECT_EQ(int(Q16(7)), 7);
+  EXPECT_FLOAT_EQ(float(Q15(-0.25)), -0.25f);
+  EXPECT_EQ(Q8(Q16(1.00390625)).raw(), 257);
+  EXPECT_EQ(Q8(Q16::from_raw(65536 + 128)).raw(), 257);
+  using Q8Down = units::Fixed<int16_t, 8, units::RoundDown>;
+  EXPECT_EQ(Q8Down(Q16::from_raw(65536 + 128)).raw(), 256);
+  EXPECT_EQ(Q16(Q8(1.5)), Q16(1.5));
+}
+
+TEST(FixedTests, Arithmetic) {
+  const Q16 a(1.5), b(-2.25);
+  auto product = a * b;
+  static_assert(
+      std::is_same<decltype(product), units::Fixed<int64_t, 32>>::value,
+      "Products widen and add the fractional bits");
+  EXPECT_EQ(product, Q16(-3.375));
+  auto q15 = Q15(0.5) * Q15(-0.5);
+  static_assert(std::is_same<decltype(q15), units::Fixed<int32_t, 30>>::value,
+                "Q15 times Q15 is Q30 in 32 bits");
+  EXPECT_EQ(q15.raw(), -(1 << 28));
+
+  auto quotient = a / b;
+  static_assert(
+      std::is_same<decltype(quotient), units::Fixed<int64_t, 16>>::value,
+      "Quotients widen and keep the dividend format");
+  EXPECT_NEAR(quotient.to<double>(), -2. / 3., 1. / 65536);
+  EXPECT_EQ((Q16(1) / Q16(3)).raw(), 21845);
+  EXPECT_EQ((Q16(2) / Q16(3)).raw(), 43691);
+  EXPECT_EQ((Q16Down(2) / Q16Down(3)).raw(), 43690);
+  EXPECT_EQ((Q16Down(-2) / Q16Down(3)).raw(), -43691);
+
+  auto sum = Q16(1.5) + Q8(0.25);
+  static_assert(std::is_same<decltype(sum), Q16>::value,
+                "Sums take the finer format");
+  EXPECT_EQ(sum, Q16(1.75));
+  EXPECT_EQ(Q8(1) - Q16(0.5), Q16(0.5));
+  // The coarse format keeps its integer range in the sum
+  using Q4 = units::Fixed<int16_t, 4>;
+  using Q12 = units::Fixed<int16_t, 12>;
+  auto mixed = Q4(100) + Q12(0.5);
+  static_assert(std::is_same<decltype(mixed), units::Fixed<int32_t, 12>>::value,
+                "11 integer and 12 fraction bits with the sign fit 32 bits");
+  EXPECT_EQ(mixed.to<double>(), 100.5);
+  EXPECT_EQ((Q12(-7.75) - Q4(-2000)).to<double>(), 1992.25);
+  static_assert(
+      std::is_same<decltype(Q15(0.5) + Q15(0.25)), Q15>::value &&
+          std::is_same<decltype(units::Fixed<uint16_t, 8>() + Q8()),
+                       units::Fixed<int32_t, 8>>::value,
+      "Same formats stay, unsigned ranges get a sign bit");
+
+  Q16 c(1.5);
+  c *= Q16(1.5);
+  EXPECT_EQ(c, Q16(2.25));
+  c /= Q16(0.5);
+  EXPECT_EQ(c, Q16(4.5));
+  c += Q16(0.5);
+  c -= Q16(1);
+  ++c;
+  EXPECT_EQ(c, Q16(5));
+  EXPECT_EQ(c * 3, Q16(15));
+  EXPECT_EQ(2 * c, Q16(10));
+  EXPECT_EQ(c / 2, Q16(2.5));
+  EXPECT_EQ(-c, Q16(-5));
+  EXPECT_EQ(units::abs(-c), c);
+
+  // The widened product format multiplies and divides in 128 bits
+  auto wide = Q16(1.5) * Q16(2);
+  wide *= Q16(1.5) * Q16(1);
+  EXPECT_EQ(wide, Q16(4.5));
+  wide *= Q16(-1000) * Q16(1000);
+  EXPECT_EQ(wide.to<double>(), -4500000.);
+  wide /= Q16(-3) * Q16(1);
+  EXPECT_EQ(wide.to<double>(), 1500000.);
+  wide /= Q16(1) / Q16(4) * Q16(1);
+  EXPECT_EQ(wide.raw(), int64_t(6000000) << 32);
+
+  EXPECT_TRUE(Q16(0.5) < Q8(0.75));
+  EXPECT_TRUE(Q8(0.75) > Q16(0.5));
+  EXPECT_TRUE(Q16(0.5) <= Q8(0.5));
+  EXPECT_TRUE(Q16(0.5) >= Q8(0.5));
+  EXPECT_TRUE(Q16(0.5) != Q8(0.25));
+}
+
+TEST(FixedTests, Units) {
+  using Meter = units::si::Meter<Q16>;
+  using MilliMeter = units::si::MilliMeter<Q16>;
+  auto area = Meter(Q16(1.5)) * Meter(Q16(4));
+  static_assert(
+      std::is_same<decltype(area),
+                   units::si::SquareMeter<units::Fixed<int64_t, 32>>>::value,
+      "The Q format follows the units");
+  EXPECT_EQ(area.value(), Q16(6));
+
+  static_assert(units::HasRescale<Q16>::value,
+                "Scales are converted by a multiply and shift");
+  static_assert(!units::HasRescale<int32_t>::value, "Integers divide");
+  Meter m(MilliMeter(Q16(1234.5)));
+  EXPECT_EQ(m.value().raw(), 80904);
+  MilliMeter mm(Meter(Q16(1.25)));
+  EXPECT_EQ(mm.value(), Q16(1250));
+  units::si::Length<Q16, std::ratio<1, 3>> third(Meter(Q16(2)));
+  EXPECT_EQ(third.value(), Q16(6));
+
+  Meter sum = Meter(Q16(1.5)) + Meter(Q16(0.25));
+  sum += Meter(Q16(1));
+  EXPECT_EQ(sum, Meter(Q16(2.75)));
+  EXPECT_EQ(std::abs(-sum), sum);
+  EXPECT_TRUE(Meter(Q16(1)) < Meter(Q16(2)));
+
+  units::si::TempKelvin<Q16> kelvin(units::si::TempCelsius<Q16>(Q16(21.5)));
+  EXPECT_NEAR(kelvin.value().to<double>(), 294.65, 1. / 65536);
+
+  static_assert(units::UnitLayout<Meter>::compatible,
+                "Fixed point units view raw integers");
+  Q16 raw[] = {Q16(1), Q16::from_raw(3 << 15)};
+  auto span = units::quantity_span<Meter>(raw, 2);
+  EXPECT_EQ(span[1], Meter(Q16(1.5)));
+}
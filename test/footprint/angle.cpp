@@ -0,0 +1,43 @@
+#include "footprint.hpp"
+
+#if defined(FOOTPRINT_RAW)
+
+// Heading in [0, 360) degrees, integral
+static std::int32_t normalized(std::int32_t degrees) {
+  const std::int32_t result = degrees % 360;
+  return result < 0 ? result + 360 : result;
+}
+
+int main() {
+  std::int32_t heading = normalized(footprint::read(0));
+  for (int i = 0; i < 4; ++i) {
+    heading = normalized(heading + footprint::read(i));
+    const std::int32_t error = normalized(footprint::read(i + 1) - heading);
+    footprint::write(heading);
+    footprint::write(error);
+  }
+  return 0;
+}
+
+#else
+
+#include "phys_angle.hpp"
+
+using Heading = units::AbsoluteAngle<std::int32_t>;
+using Turn = Heading::DiffAngleUnit;
+
+int main() {
+  Heading heading(footprint::read(0));
+  for (int i = 0; i < 4; ++i) {
+    heading += Turn(footprint::read(i));
+    const Turn turn = Heading(footprint::read(i + 1)) - heading;
+    const Heading error(turn.value());
+    footprint::write(heading.value());
+    footprint::write(error.value());
+  }
+  return 0;
+}
+
+#endif
+
+FOOTPRINT_IO
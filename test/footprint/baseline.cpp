@@ -0,0 +1,8 @@
+#include "footprint.hpp"
+
+FOOTPRINT_IO
+
+int main() {
+  footprint::write(footprint::read(0));
+  return 0;
+}
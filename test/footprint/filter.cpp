@@ -0,0 +1,56 @@
+#include "footprint.hpp"
+
+#if defined(FOOTPRINT_RAW)
+
+// 8 tap moving sum in Q14, rounded and saturated
+static const std::int32_t coef[8] = {2048, 2048, 2048, 2048,
+                                     2048, 2048, 2048, 2048};
+
+int main() {
+  std::int16_t line[8 + 31] = {};
+  for (int frame = 0; frame < 4; ++frame) {
+    for (int j = 0; j < 32; ++j)
+      line[7 + j] = std::int16_t(footprint::read(j));
+    for (int j = 0; j < 32; ++j) {
+      std::int64_t acc = 0;
+      for (int k = 0; k < 8; ++k)
+        acc += std::int64_t(coef[k]) * line[7 + j - k];
+      acc = (acc + (1 << 13)) >> 14;
+      footprint::write(std::int32_t(acc > 32767    ? 32767
+                                    : acc < -32768 ? -32768
+                                                   : acc));
+    }
+    for (int i = 0; i < 7; ++i)
+      line[i] = line[32 + i];
+  }
+  return 0;
+}
+
+#else
+
+#include "phys_filter.hpp"
+#include "phys_si.hpp"
+
+using MilliVolt = units::si::MilliVolt<std::int16_t>;
+
+int main() {
+  const units::Coefficient<> taps[8] = {
+      units::Coefficient<>(0.125), units::Coefficient<>(0.125),
+      units::Coefficient<>(0.125), units::Coefficient<>(0.125),
+      units::Coefficient<>(0.125), units::Coefficient<>(0.125),
+      units::Coefficient<>(0.125), units::Coefficient<>(0.125)};
+  units::FirFilter<MilliVolt, 8> fir(taps);
+  MilliVolt in[32], out[32];
+  for (int frame = 0; frame < 4; ++frame) {
+    for (int j = 0; j < 32; ++j)
+      in[j] = MilliVolt(std::int16_t(footprint::read(j)));
+    fir.process(in, 32, out);
+    for (int j = 0; j < 32; ++j)
+      footprint::write(out[j].value());
+  }
+  return 0;
+}
+
+#endif
+
+FOOTPRINT_IO
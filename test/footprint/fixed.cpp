@@ -0,0 +1,39 @@
+#include "footprint.hpp"
+
+#if defined(FOOTPRINT_RAW)
+
+int main() {
+  // Q16.16 first order low-pass and gain
+  const std::int32_t k = 3277, gain = 98304;
+  std::int32_t y = 0;
+  for (int i = 0; i < 64; ++i) {
+    y += std::int32_t((std::int64_t(k) * (footprint::read(i) - y) +
+                       (1 << 15)) >>
+                      16);
+    footprint::write(
+        std::int32_t((std::int64_t(gain) * y + (1 << 15)) >> 16));
+  }
+  return 0;
+}
+
+#else
+
+#include "phys_fixed.hpp"
+#include "phys_si.hpp"
+
+using Q16 = units::Fixed<std::int32_t, 16>;
+using Volt = units::si::Volt<Q16>;
+
+int main() {
+  const Q16 k = Q16::from_raw(3277), gain = Q16::from_raw(98304);
+  Volt y;
+  for (int i = 0; i < 64; ++i) {
+    y += Volt(k * (Volt(Q16::from_raw(footprint::read(i))) - y));
+    footprint::write(Volt(gain * y).value().raw());
+  }
+  return 0;
+}
+
+#endif
+
+FOOTPRINT_IO
@@ -0,0 +1,67 @@
+#!/bin/bash
+
+# Name of the script: footprint_report.sh
+# Builds the footprint programs with the flags of a small target (-Os,
+# -fno-exceptions, -fno-rtti, section garbage collection) and reports the
+# .text/.data/.bss of every feature next to the equivalent raw code.
+# Usage: [CXX=arm-none-eabi-g++] ./footprint_report.sh [cmake options]
+
+PROJECT_ROOT="$(cd "$(dirname "$0")/../.." && pwd)"
+FOOTPRINT="${PROJECT_ROOT}/test/footprint"
+TEMP_BUILD_DIR="${FOOTPRINT}/build_footprint"
+SIZE="${SIZE:-size}"
+
+FEATURES=("units" "angle" "fixed" "filter" "string" "format")
+declare -A HEADERS=(
+    ["units"]="phys_units.hpp, phys_si.hpp"
+    ["angle"]="phys_angle.hpp"
+    ["fixed"]="phys_fixed.hpp"
+    ["filter"]="phys_filter.hpp"
+    ["string"]="phys_string.hpp"
+    ["format"]="phys_string.hpp, no std::string"
+)
+
+# Prints the text, data and bss bytes of an executable
+function sections()
+{
+    "${SIZE}" -B "$1" | awk 'NR == 2 { print $1, $2, $3 }'
+}
+
+# Prints yes when the executable allocates or uses std::string
+function heap()
+{
+    if nm -u "$1" | grep -qE "_Znwm|_Znwj|_Znam|_Znaj|basic_string|malloc"; then
+        echo "yes"
+    else
+        echo "no"
+    fi
+}
+
+function main()
+{
+    cmake -S "${FOOTPRINT}" -B "${TEMP_BUILD_DIR}" "$@" > /dev/null || return 1
+    cmake --build "${TEMP_BUILD_DIR}" > /dev/null || return 1
+
+    local text data bss
+    read -r text data bss <<< "$(sections "${TEMP_BUILD_DIR}/baseline")"
+    echo "Empty program: text ${text} B, data ${data} B, bss ${bss} B"
+    echo ""
+    printf "| %-7s | %-32s | %7s | %6s | %5s | %8s | %8s | %6s | %4s |\n" \
+        "Feature" "Headers" "Text B" "Data B" "Bss B" "Raw text" "Raw data" \
+        "+Text" "Heap"
+    echo "|---------|----------------------------------|---------|--------|-------|----------|----------|--------|------|"
+
+    local feature rtext rdata rbss
+    for feature in "${FEATURES[@]}"; do
+        read -r text data bss <<< "$(sections "${TEMP_BUILD_DIR}/${feature}_units")"
+        read -r rtext rdata rbss <<< "$(sections "${TEMP_BUILD_DIR}/${feature}_raw")"
+        printf "| %-7s | %-32s | %7s | %6s | %5s | %8s | %8s | %+6d | %-4s |\n" \
+            "${feature}" "${HEADERS[${feature}]}" "${text}" "${data}" "${bss}" \
+            "${rtext}" "${rdata}" "$((text - rtext))" \
+            "$(heap "${TEMP_BUILD_DIR}/${feature}_units")"
+    done
+
+    rm -rf "${TEMP_BUILD_DIR}"
+}
+
+main "$@"
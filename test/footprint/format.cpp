@@ -0,0 +1,52 @@
+#include "footprint.hpp"
+
+#if defined(FOOTPRINT_RAW)
+
+// Hand-written integer formatting into a buffer
+static char *append(char *out, std::int32_t value) {
+  char digits[12];
+  int count = 0;
+  std::uint32_t rest = value < 0 ? 0u - std::uint32_t(value) : value;
+  do {
+    digits[count++] = char('0' + rest % 10);
+    rest /= 10;
+  } while (rest > 0);
+  if (value < 0)
+    *out++ = '-';
+  while (count > 0)
+    *out++ = digits[--count];
+  return out;
+}
+
+int main() {
+  for (int i = 0; i < 4; ++i) {
+    char text[32];
+    char *end = append(text, footprint::read(i));
+    *end++ = 'm';
+    *end++ = 'V';
+    *end = 0;
+    footprint::write(text);
+  }
+  return 0;
+}
+
+#else
+
+// Built with PHYS_UNITS_NO_STD_STRING, without <string> and the heap
+#include "phys_si.hpp"
+#include "phys_string.hpp"
+
+using MilliVolt = units::si::MilliVolt<std::int32_t>;
+
+int main() {
+  for (int i = 0; i < 4; ++i) {
+    char text[32];
+    units::format_unit(MilliVolt(footprint::read(i)), text, sizeof(text));
+    footprint::write(text);
+  }
+  return 0;
+}
+
+#endif
+
+FOOTPRINT_IO
@@ -0,0 +1,36 @@
+#include "footprint.hpp"
+#include <string>
+
+#if defined(FOOTPRINT_RAW)
+
+int main() {
+  for (int i = 0; i < 4; ++i) {
+    const std::string text =
+        std::to_string(footprint::read(i)) + "mV, " +
+        std::to_string(footprint::read(i + 1) / 1000.) + "m s^-1";
+    footprint::write(text.c_str());
+  }
+  return 0;
+}
+
+#else
+
+#include "phys_si.hpp"
+#include "phys_string.hpp"
+
+using MilliVolt = units::si::MilliVolt<std::int32_t>;
+using MeterPerSecond = units::si::MeterPerSecond<double>;
+
+int main() {
+  for (int i = 0; i < 4; ++i) {
+    const std::string text =
+        std::to_string(MilliVolt(footprint::read(i))) + ", " +
+        std::to_string(MeterPerSecond(footprint::read(i + 1) / 1000.));
+    footprint::write(text.c_str());
+  }
+  return 0;
+}
+
+#endif
+
+FOOTPRINT_IO
@@ -0,0 +1,48 @@
+#include "footprint.hpp"
+
+#if defined(FOOTPRINT_RAW)
+
+int main() {
+  for (int i = 0; i < 4; ++i) {
+    // centi degrees Celsius to Kelvin, millimeters over milliseconds
+    const std::int32_t kelvin = footprint::read(i) / 100 + 273;
+    const std::int32_t mm = footprint::read(i + 1);
+    const std::int32_t ms = footprint::read(i + 2);
+    const std::int32_t speed = mm / ms;
+    footprint::write(kelvin);
+    footprint::write(speed > 3 ? speed : mm * 1000);
+  }
+  return 0;
+}
+
+#else
+
+#include "phys_si.hpp"
+
+using CentiCelsius =
+    units::AbsolutePhysicalUnit<std::int32_t, std::centi, std::int32_t,
+                                std::ratio<27315, 100>, std::ratio<0>,
+                                std::ratio<0>, std::ratio<0>, std::ratio<0>,
+                                std::ratio<1>>;
+using Kelvin = units::si::TempKelvin<std::int32_t>;
+using MilliMeter = units::si::MilliMeter<std::int32_t>;
+using MilliSecond = units::si::MilliSecond<std::int32_t>;
+using MeterPerSecond = units::si::MeterPerSecond<std::int32_t>;
+using MicroMeter = units::si::Length<std::int32_t, std::micro>;
+
+int main() {
+  for (int i = 0; i < 4; ++i) {
+    const Kelvin kelvin(CentiCelsius(footprint::read(i)));
+    const MilliMeter mm(footprint::read(i + 1));
+    const MilliSecond ms(footprint::read(i + 2));
+    const MeterPerSecond speed = mm / ms;
+    footprint::write(kelvin.value());
+    footprint::write(speed > MeterPerSecond(3) ? speed.value()
+                                               : MicroMeter(mm).value());
+  }
+  return 0;
+}
+
+#endif
+
+FOOTPRINT_IO
@@ -0,0 +1,125 @@
+#include "phys_geodesy.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <vector>
+
+using Latitude = units::AbsoluteAngle<double, std::ratio<1>, true>;
+using Longitude = units::AbsoluteAngle<double, std::ratio<1>, true>;
+using RadianLatitude = units::AbsoluteAngle<double, units::RadianRatio, true>;
+using Bearing = units::AbsoluteAngle<double>;
+using Meter = units::si::Meter<double>;
+using KiloMeter = units::si::KiloMeter<float>;
+
+static const double pi = 3.14159265358979323846;
+
+static double reference_haversine(double p1, double l1, double p2, double l2) {
+  const double rad = pi / 180;
+  const double a =
+      std::pow(std::sin((p2 - p1) * rad / 2), 2) +
+      std::cos(p1 * rad) * std::cos(p2 * rad) *
+          std::pow(std::sin((l2 - l1) * rad / 2), 2);
+  return 2 * std::asin(std::sqrt(a)) * units::Earth::MeanRadius;
+}
+
+TEST(GeodesyTests, Haversine) {
+  const Latitude paris(48.8566), london(51.5074);
+  const Longitude parisLon(2.3522), londonLon(-0.1278);
+  const Meter d = units::haversine(paris, parisLon, london, londonLon);
+  EXPECT_NEAR(d.value(),
+              reference_haversine(48.8566, 2.3522, 51.5074, -0.1278), 1e-6);
+  EXPECT_NEAR(d.value(), 343.5e3, 0.5e3);
+
+  const std::size_t count = 100000;
+  std::vector<Latitude> lat1(count), lat2(count);
+  std::vector<Longitude> lon1(count), lon2(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    lat1[i] = Latitude(double(i % 179) - 89.);
+    lon1[i] = Longitude(double(i % 359) - 179.);
+    lat2[i] = Latitude(double(i * 7 % 179) - 89.);
+    lon2[i] = Longitude(double(i * 13 % 359) - 179.);
+  }
+  std::vector<Meter> single(count), threaded(count);
+  std::vector<KiloMeter> km(count);
+  units::haversine_n(lat1.data(), lon1.data(), lat2.data(), lon2.data(), count,
+                     single.data());
+  units::haversine_n(lat1.data(), lon1.data(), lat2.data(), lon2.data(), count,
+                     threaded.data(), 4);
+  units::haversine_n(lat1.data(), lon1.data(), lat2.data(), lon2.data(), count,
+                     km.data());
+  for (std::size_t i = 0; i < count; i += 101) {
+    const double expected =
+        reference_haversine(lat1[i].value(), lon1[i].value(), lat2[i].value(),
+                            lon2[i].value());
+    ASSERT_NEAR(single[i].value(), expected, 1e-6);
+    ASSERT_EQ(single[i], threaded[i]);
+    ASSERT_NEAR(km[i].value(), expected / 1000, 1e-3);
+  }
+
+  // Angles in the RadianRatio scale are read as radians
+  const RadianLatitude p1(0.5), p2(-0.25);
+  const Meter r = units::haversine(p1, p1, p2, p2);
+  EXPECT_NEAR(r.value(),
+              reference_haversine(0.5 * 180 / pi, 0.5 * 180 / pi,
+                                  -0.25 * 180 / pi, -0.25 * 180 / pi),
+              1e-6);
+}
+
+TEST(GeodesyTests, Vincenty) {
+  // Flinders Peak to Buninyong, from Vincenty's paper
+  const Latitude flinders(-(37 + 57 / 60. + 3.72030 / 3600));
+  const Longitude flindersLon(144 + 25 / 60. + 29.52440 / 3600);
+  const Latitude buninyong(-(37 + 39 / 60. + 10.15610 / 3600));
+  const Longitude buninyongLon(143 + 55 / 60. + 35.38390 / 3600);
+  Meter d;
+  units::vincenty_n(&flinders, &flindersLon, &buninyong, &buninyongLon, 1, &d);
+  EXPECT_NEAR(d.value(), 54972.271, 0.001);
+
+  units::vincenty_n(&flinders, &flindersLon, &flinders, &flindersLon, 1, &d);
+  EXPECT_EQ(d.value(), 0.);
+}
+
+TEST(GeodesyTests, Bearing) {
+  const Latitude lat1[3] = {Latitude(0.), Latitude(0.), Latitude(10.)};
+  const Longitude lon1[3] = {Longitude(0.), Longitude(0.), Longitude(0.)};
+  const Latitude lat2[3] = {Latitude(0.), Latitude(10.), Latitude(0.)};
+  const Longitude lon2[3] = {Longitude(90.), Longitude(0.), Longitude(-10.)};
+  Bearing out[3];
+  units::bearing_n(lat1, lon1, lat2, lon2, 3, out);
+  EXPECT_NEAR(out[0].value(), 90., 1e-9);
+  EXPECT_NEAR(out[1].value(), 0., 1e-9);
+  EXPECT_GT(out[2].value(), 180.);
+  EXPECT_LT(out[2].value(), 270.);
+}
+
+TEST(GeodesyTests, DestinationAndBox) {
+  Latitude lat;
+  Longitude lon;
+  units::destination(Latitude(0.), Longitude(0.), Bearing(90.),
+                     Meter(units::Earth::MeanRadius * pi / 2), lat, lon);
+  EXPECT_NEAR(lat.value(), 0., 1e-9);
+  EXPECT_NEAR(lon.value(), 90., 1e-9);
+
+  const Latitude center(50.);
+  const Longitude centerLon(10.);
+  const auto box = units::bounding_box(center, centerLon, KiloMeter(100.f));
+  EXPECT_FALSE(box.allLongitudes);
+  for (double b = 0; b < 360; b += 15) {
+    units::destination(center, centerLon, Bearing(b), KiloMeter(99.f), lat,
+                       lon);
+    EXPECT_TRUE(box.contains(lat, lon));
+    EXPECT_NEAR(units::haversine(center, centerLon, lat, lon).value(), 99e3,
+                1e-3);
+  }
+  EXPECT_FALSE(box.contains(Latitude(52.), centerLon));
+
+  const auto polar =
+      units::bounding_box(Latitude(89.5), Longitude(0.), KiloMeter(100.f));
+  EXPECT_TRUE(polar.allLongitudes);
+  EXPECT_TRUE(polar.contains(Latitude(89.9), Longitude(-170.)));
+
+  const auto wrapped =
+      units::bounding_box(Latitude(0.), Longitude(179.9), KiloMeter(50.f));
+  EXPECT_GT(wrapped.west.value(), wrapped.east.value());
+  EXPECT_TRUE(wrapped.contains(Latitude(0.), Longitude(-179.9)));
+  EXPECT_FALSE(wrapped.contains(Latitude(0.), Longitude(0.)));
+}
@@ -0,0 +1,151 @@
+#include "phys_histogram.hpp"
+#include "phys_si.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using NanoSecond = units::si::NanoSecond<std::int64_t>;
+using MicroSecond = units::si::MicroSecond<double>;
+using MilliSecond = units::si::MilliSecond<double>;
+using Second = units::si::Second<double>;
+using TempCelsius = units::si::TempCelsius<float>;
+using TempKelvin = units::si::TempKelvin<double>;
+
+TEST(HistogramTests, Linear) {
+  using Bins = units::LinearBins<MicroSecond, 10>;
+  units::Histogram<Bins> histogram(Bins(MicroSecond(0.), MicroSecond(100.)));
+  static_assert(units::Histogram<Bins>::Buckets == 12, "Under and overflow");
+  // Only values of the same dimension are inserted, not plain numbers
+  static_assert(units::SameDimension<Second, MicroSecond>::value, "Durations");
+  static_assert(!units::SameDimension<double, MicroSecond>::value &&
+                    !units::SameDimension<units::si::Meter<double>,
+                                          MicroSecond>::value,
+                "Numbers and lengths are not durations");
+
+  histogram.insert(MilliSecond(0.055));
+  histogram.insert(MicroSecond(-1.));
+  histogram.insert(Second(1.));
+  histogram.insert(MicroSecond(0.));
+  histogram.insert(MicroSecond(99.9));
+  EXPECT_EQ(histogram.count(), 5u);
+  EXPECT_EQ(histogram.bucket_count(6), 1u);
+  EXPECT_EQ(histogram.bucket_count(0), 1u);
+  EXPECT_EQ(histogram.bucket_count(11), 1u);
+  EXPECT_EQ(histogram.bucket_count(1), 1u);
+  EXPECT_EQ(histogram.bucket_count(10), 1u);
+  EXPECT_DOUBLE_EQ(histogram.lower(6).value(), 50.);
+  EXPECT_DOUBLE_EQ(histogram.upper(6).value(), 60.);
+  EXPECT_DOUBLE_EQ(histogram.lower(0).value(), 0.);
+  EXPECT_DOUBLE_EQ(histogram.upper(11).value(), 100.);
+
+  // The open ended buckets report their edge
+  EXPECT_DOUBLE_EQ(histogram.percentile(0.).value(), 0.);
+  EXPECT_DOUBLE_EQ(histogram.percentile(0.6).value(), 60.);
+  EXPECT_DOUBLE_EQ(histogram.percentile(1.).value(), 100.);
+}
+
+TEST(HistogramTests, LogLinear) {
+  using Bins = units::LogLinearBins<NanoSecond, 5>;
+  static_assert(Bins::Buckets == (64 - 5) * 32, "Buckets of an int64_t");
+  for (std::int64_t v = 0; v < 100000; v += 7) {
+    const std::size_t b = Bins::index(v);
+    EXPECT_LE(Bins::lower(b), double(v));
+    EXPECT_GT(Bins::upper(b), double(v));
+    EXPECT_LE(Bins::upper(b) - Bins::lower(b),
+              Bins::lower(b) / 32. > 1. ? Bins::lower(b) / 32. : 1.);
+  }
+  for (int shift = 0; shift < 63; ++shift) {
+    const std::int64_t v = std::int64_t(1) << shift;
+    EXPECT_EQ(Bins::lower(Bins::index(v)), double(v));
+    EXPECT_EQ(Bins::index(v - 1) + 1, Bins::index(v));
+  }
+  EXPECT_EQ(Bins::index(-5), 0u);
+  EXPECT_EQ(Bins::index(INT64_MAX), Bins::Buckets - 1);
+
+  // Integral percentiles stay within the bucket of their values
+  units::Histogram<Bins> histogram;
+  for (std::int64_t ns = 1; ns <= 1000; ++ns)
+    histogram.insert(NanoSecond(ns));
+  EXPECT_EQ(histogram.percentile(0.).value(), 1);
+  EXPECT_EQ(histogram.percentile(0.01).value(), 10);
+  EXPECT_NEAR(double(histogram.percentile(0.5).value()), 500., 500. / 32);
+  EXPECT_NEAR(double(histogram.percentile(0.99).value()), 990., 990. / 32);
+  EXPECT_LE(histogram.percentile(1.).value(), 1023);
+  EXPECT_GE(histogram.percentile(1.).value(), 992);
+}
+
+TEST(HistogramTests, Edges) {
+  const TempCelsius edges[] = {TempCelsius(0.f), TempCelsius(20.f),
+                               TempCelsius(25.f), TempCelsius(40.f)};
+  using Bins = units::EdgeBins<TempCelsius, 4>;
+  units::Histogram<Bins> histogram{Bins(edges)};
+  static_assert(units::SameDimension<TempKelvin, TempCelsius>::value,
+                "Temperatures of any scale");
+
+  histogram.insert(TempKelvin(250.));
+  histogram.insert(TempKelvin(293.15));
+  histogram.insert(TempCelsius(22.f));
+  histogram.insert(TempCelsius(25.f));
+  histogram.insert(TempCelsius(100.f));
+  EXPECT_EQ(histogram.bucket_count(0), 1u);
+  EXPECT_EQ(histogram.bucket_count(1), 0u);
+  EXPECT_EQ(histogram.bucket_count(2), 2u);
+  EXPECT_EQ(histogram.bucket_count(3), 1u);
+  EXPECT_EQ(histogram.bucket_count(4), 1u);
+  EXPECT_FLOAT_EQ(histogram.lower(2).value(), 20.f);
+  EXPECT_FLOAT_EQ(histogram.upper(2).value(), 25.f);
+  EXPECT_FLOAT_EQ(histogram.percentile(0.5).value(), 25.f);
+  EXPECT_FLOAT_EQ(histogram.percentile(0.3).value(), 22.5f);
+}
+
+TEST(HistogramTests, BatchAndMerge) {
+  using Bins = units::LogLinearBins<NanoSecond>;
+  std::vector<Second> seconds(1000);
+  for (std::size_t i = 0; i < seconds.size(); ++i)
+    seconds[i] = Second(double(i * i) * 1e-9);
+
+  units::Histogram<Bins> single, batch, merged;
+  for (const Second &s : seconds)
+    single.insert(s);
+  batch.insert_n(seconds.data(), seconds.size());
+  merged.insert_n(seconds.data(), 300);
+  units::Histogram<Bins> rest;
+  rest.insert_n(seconds.data() + 300, seconds.size() - 300);
+  merged.merge(rest);
+
+  EXPECT_EQ(batch.count(), 1000u);
+  EXPECT_EQ(merged.count(), 1000u);
+  for (std::size_t b = 0; b < Bins::Buckets; ++b) {
+    EXPECT_EQ(batch.bucket_count(b), single.bucket_count(b));
+    EXPECT_EQ(merged.bucket_count(b), single.bucket_count(b));
+  }
+  EXPECT_EQ(batch.percentile(0.9), single.percentile(0.9));
+  batch.reset();
+  EXPECT_EQ(batch.count(), 0u);
+  EXPECT_EQ(batch.percentile(0.5), NanoSecond(0));
+}
+
+TEST(HistogramTests, Threads) {
+  using Bins = units::LogLinearBins<NanoSecond>;
+  units::ThreadHistograms<Bins, 4> histograms;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 6; ++t)
+    threads.emplace_back([&histograms, t]() {
+      std::vector<MicroSecond> latencies(500);
+      for (std::size_t i = 0; i < latencies.size(); ++i)
+        latencies[i] = MicroSecond(double(i + 1));
+      histograms.insert_n(latencies.data(), latencies.size());
+      histograms.insert(MicroSecond(double(t)));
+    });
+  for (std::thread &thread : threads)
+    thread.join();
+
+  const units::Histogram<Bins> total = histograms.snapshot();
+  EXPECT_EQ(total.count(), 6u * 501u);
+  EXPECT_EQ(total.bucket_count(Bins::index(0)), 1u);
+  EXPECT_EQ(total.bucket_count(Bins::index(1000)), 7u);
+  EXPECT_NEAR(double(total.percentile(0.5).value()), 250e3, 250e3 / 32);
+  histograms.reset();
+  EXPECT_EQ(histograms.snapshot().count(), 0u);
+}
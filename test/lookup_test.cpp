@@ -0,0 +1,72 @@
+#include "phys_lookup.hpp"
+#include <gtest/gtest.h>
+
+using Volt = units::PhysicalUnit<double, std::ratio<1>, std::ratio<2>,
+                                 std::ratio<1>, std::ratio<-3>, std::ratio<-1>>;
+using MilliVolt = units::PhysicalUnit<double, std::milli, std::ratio<2>,
+                                      std::ratio<1>, std::ratio<-3>,
+                                      std::ratio<-1>>;
+using KiloPascal = units::PhysicalUnit<double, std::kilo, std::ratio<-1>,
+                                       std::ratio<1>, std::ratio<-2>>;
+using Pascal = units::PhysicalUnit<double, std::ratio<1>, std::ratio<-1>,
+                                   std::ratio<1>, std::ratio<-2>>;
+using TempKelvin =
+    units::AbsolutePhysicalUnit<double, std::ratio<1>, double, std::ratio<0>,
+                                std::ratio<0>, std::ratio<0>, std::ratio<0>,
+                                std::ratio<0>, std::ratio<1>>;
+using TempCelsius = units::AbsolutePhysicalUnit<
+    double, std::ratio<1>, double, std::ratio<27315, 100>, std::ratio<0>,
+    std::ratio<0>, std::ratio<0>, std::ratio<0>, std::ratio<1>>;
+
+TEST(LookupTableTests, UniformGrid) {
+  constexpr units::LookupTable<Volt, KiloPascal, 3> sensor(
+      {Volt(0.5), Volt(2.5), Volt(4.5)},
+      {KiloPascal(0.), KiloPascal(100.), KiloPascal(400.)});
+  static_assert(sensor.uniform(), "Equal spacing must be detected");
+  EXPECT_NEAR(sensor.lookup(Volt(1.5)).value(), 50., 0.000001);
+  EXPECT_NEAR(sensor.lookup(Volt(3.5)).value(), 250., 0.000001);
+  EXPECT_NEAR(sensor.lookup(Volt(4.5)).value(), 400., 0.000001);
+  EXPECT_NEAR(sensor.lookup(Volt(0.)).value(), 0., 0.000001);
+  EXPECT_NEAR(sensor.lookup(Volt(9.)).value(), 400., 0.000001);
+  EXPECT_NEAR(sensor.lookup(MilliVolt(1500.)).value(), 50., 0.000001);
+
+  auto pascals = sensor.as<MilliVolt, Pascal>();
+  EXPECT_TRUE(pascals.uniform());
+  EXPECT_NEAR(pascals.lookup(MilliVolt(3500.)).value(), 250000., 0.0001);
+}
+
+TEST(LookupTableTests, NonUniformGrid) {
+  // 12-bit ADC counts to temperature
+  const units::LookupTable<int, TempCelsius, 5> adc(
+      {0, 100, 1000, 3000, 4095},
+      {TempCelsius(-40.), TempCelsius(-20.), TempCelsius(0.), TempCelsius(50.),
+       TempCelsius(125.)});
+  EXPECT_FALSE(adc.uniform());
+  EXPECT_NEAR(adc.lookup(50).value(), -30., 0.000001);
+  EXPECT_NEAR(adc.lookup(100).value(), -20., 0.000001);
+  EXPECT_NEAR(adc.lookup(2000).value(), 25., 0.000001);
+  EXPECT_NEAR(adc.lookup(4095).value(), 125., 0.000001);
+
+  const int counts[] = {-5, 0, 550, 3000, 5000};
+  TempCelsius temps[5];
+  adc.lookup_n(counts, 5, temps);
+  EXPECT_NEAR(temps[0].value(), -40., 0.000001);
+  EXPECT_NEAR(temps[1].value(), -40., 0.000001);
+  EXPECT_NEAR(temps[2].value(), -10., 0.000001);
+  EXPECT_NEAR(temps[3].value(), 50., 0.000001);
+  EXPECT_NEAR(temps[4].value(), 125., 0.000001);
+
+  auto kelvins = adc.as<int, TempKelvin>();
+  EXPECT_NEAR(kelvins.lookup(1000).value(), 273.15, 0.000001);
+}
+
+#ifndef NDEBUG
+TEST(LookupTableTests, DescendingBreakpoints) {
+  const auto descending = [] {
+    const units::LookupTable<int, Volt, 3> table(
+        {0, 200, 100}, {Volt(0.), Volt(1.), Volt(2.)});
+    return table.uniform();
+  };
+  EXPECT_DEATH(descending(), "ascending");
+}
+#endif
@@ -0,0 +1,139 @@
+#include "phys_metrics.hpp"
+#include "phys_si.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using Requests = units::PhysicalUnit<std::uint64_t>;
+using MilliSecond = units::si::MilliSecond<double>;
+using Joule = units::si::Joule<std::int64_t>;
+using TempCelsius = units::si::TempCelsius<double>;
+
+template <typename Metric>
+std::string exported(const Metric &metric, const char *name) {
+  units::MetricsRegistry registry;
+  registry.add(name, metric);
+  char buffer[512];
+  registry.export_text(buffer, sizeof(buffer));
+  return buffer;
+}
+
+TEST(MetricsTests, Counters) {
+  units::Counter<Requests> requests;
+  units::Counter<MilliSecond> busy;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t)
+    threads.emplace_back([&]() {
+      for (int i = 0; i < 1000; ++i) {
+        requests.add(Requests(1));
+        busy.add(MilliSecond(0.5));
+      }
+    });
+  for (std::thread &thread : threads)
+    thread.join();
+  EXPECT_EQ(std::uint64_t(requests.value()), 4000u);
+  EXPECT_DOUBLE_EQ(busy.value().value(), 2000.);
+  EXPECT_EQ(exported(requests, "requests"), "requests 4000\n");
+  EXPECT_EQ(exported(busy, "busy"), "busy 2.000000e+00 s\n");
+  busy.reset();
+  EXPECT_EQ(busy.value(), MilliSecond(0.));
+}
+
+TEST(MetricsTests, SharedShard) {
+  // Two owned shards, the other threads share the last one
+  units::Counter<Joule, 3> energy;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 6; ++t)
+    threads.emplace_back([&]() {
+      for (int i = 0; i < 10000; ++i)
+        energy.add(Joule(2));
+    });
+  for (std::thread &thread : threads)
+    thread.join();
+  EXPECT_EQ(energy.value(), Joule(120000));
+  EXPECT_EQ(exported(energy, "energy"), "energy 120000 m^2 kg s^-2\n");
+}
+
+template <typename Metric, typename Amount, typename = void>
+struct CanAdd : std::false_type {};
+template <typename Metric, typename Amount>
+struct CanAdd<Metric, Amount,
+              decltype(std::declval<Metric &>().add(std::declval<Amount>()))>
+    : std::true_type {};
+
+TEST(MetricsTests, Gauges) {
+  units::Gauge<TempCelsius> temperature;
+  temperature.set(TempCelsius(21.5));
+  EXPECT_EQ(temperature.value(), TempCelsius(21.5));
+  EXPECT_EQ(exported(temperature, "temperature"),
+            "temperature 2.946500e+02 K\n");
+  temperature.add(TempCelsius::DiffPhysicalUnit(1.));
+  EXPECT_EQ(temperature.value(), TempCelsius(22.5));
+
+  units::Gauge<units::si::MilliVolt<int>> supply;
+  supply.set(units::si::MilliVolt<int>(3300));
+  EXPECT_EQ(exported(supply, "supply"), "supply 3.300000e+00 V\n");
+
+  // Differences in another scale are converted, other dimensions rejected
+  units::Gauge<MilliSecond> uptime;
+  uptime.add(units::si::Second<double>(1.));
+  uptime.add(MilliSecond(5.));
+  EXPECT_EQ(uptime.value(), MilliSecond(1005.));
+  static_assert(CanAdd<units::Gauge<MilliSecond>, MilliSecond>::value,
+                "Same unit adds");
+  static_assert(
+      !CanAdd<units::Gauge<MilliSecond>, units::si::Meter<double>>::value,
+      "Lengths do not add to durations");
+  static_assert(!CanAdd<units::Gauge<MilliSecond>, double>::value,
+                "Raw values do not add");
+  static_assert(!CanAdd<units::Gauge<TempCelsius>, TempCelsius>::value,
+                "Absolute temperatures do not add, their differences do");
+}
+
+TEST(MetricsTests, Histograms) {
+  const MilliSecond bounds[] = {MilliSecond(1), MilliSecond(10),
+                                MilliSecond(100)};
+  units::MetricHistogram<MilliSecond, 3> latency(bounds);
+  EXPECT_EQ(latency.bucket(MilliSecond(0.5)), 0u);
+  EXPECT_EQ(latency.bucket(MilliSecond(1)), 0u);
+  EXPECT_EQ(latency.bucket(MilliSecond(50)), 2u);
+  EXPECT_EQ(latency.bucket(MilliSecond(500)), 3u);
+
+  for (double ms : {0.5, 2., 3., 50., 500.})
+    latency.record(MilliSecond(ms));
+  EXPECT_EQ(latency.count(), 5u);
+  EXPECT_EQ(latency.bucket_count(1), 2u);
+  EXPECT_EQ(latency.bound(2), MilliSecond(100));
+  EXPECT_DOUBLE_EQ(latency.sum().value(), 555.5);
+  EXPECT_EQ(exported(latency, "latency"),
+            "latency_bucket{le=\"1.000000e-03\"} 1\n"
+            "latency_bucket{le=\"1.000000e-02\"} 3\n"
+            "latency_bucket{le=\"1.000000e-01\"} 4\n"
+            "latency_bucket{le=\"+Inf\"} 5\n"
+            "latency_count 5\n"
+            "latency_sum 5.555000e-01 s\n");
+  latency.reset();
+  EXPECT_EQ(latency.count(), 0u);
+}
+
+TEST(MetricsTests, Registry) {
+  units::Counter<Requests> requests;
+  units::Gauge<MilliSecond> uptime;
+  requests.add(Requests(3));
+  uptime.set(MilliSecond(1500));
+  units::MetricsRegistry registry;
+  registry.add("requests", requests);
+  registry.add("uptime", uptime);
+  EXPECT_EQ(registry.size(), 2u);
+
+  char buffer[64];
+  EXPECT_EQ(registry.export_text(buffer, sizeof(buffer)), 33u);
+  EXPECT_STREQ(buffer, "requests 3\nuptime 1.500000e+00 s\n");
+  char small[12];
+  EXPECT_EQ(registry.export_text(small, sizeof(small)), 11u);
+  EXPECT_STREQ(small, "requests 3\n");
+}
@@ -0,0 +1,25 @@
+// Uses the library through the C++20 module only, the exit code tells the
+// first failed check
+import phys_units;
+
+int main() {
+  using namespace units::si;
+
+  const Watt<> power = Volt<>(12.) * Ampere<>(0.5);
+  if (power.value() != 6.)
+    return 1;
+  if (Meter<>(KiloMeter<>(1.5)).value() != 1500.)
+    return 2;
+
+  char text[32];
+  if (units::format_unit(MilliVolt<int>(3), text, sizeof(text)) != 3 ||
+      text[0] != '3' || text[1] != 'm' || text[2] != 'V')
+    return 3;
+
+  units::RunningStats<Joule<>> stats;
+  stats.push(Joule<>(1.));
+  stats.push(Joule<>(3.));
+  if (stats.mean().value() != 2.)
+    return 4;
+  return 0;
+}
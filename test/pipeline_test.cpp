@@ -0,0 +1,187 @@
+#include "phys_dim.hpp"
+#include "phys_pipeline.hpp"
+#include "phys_si.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using RawMilliVolt = units::si::MilliVolt<std::int32_t>;
+using MilliVolt = units::si::MilliVolt<double>;
+using Volt = units::si::Volt<double>;
+using Meter = units::si::Meter<double>;
+
+// Mean of every group of four values, kept across batches
+struct MeanOfFour {
+  using Input = Volt;
+  using Output = Volt;
+
+  std::size_t process(const Volt *in, std::size_t count, Volt *out) {
+    std::size_t written = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      sum += in[i];
+      if (++seen == 4) {
+        out[written++] = Volt(sum.value() / 4);
+        sum = Volt(0);
+        seen = 0;
+      }
+    }
+    return written;
+  }
+
+  Volt sum;
+  int seen;
+};
+
+auto gain = [](const RawMilliVolt &raw) { return MilliVolt(raw) * 2.; };
+auto offset = [](const Volt &v) { return v + Volt(1); };
+
+TEST(PipelineTests, Conversions) {
+  // MilliVolt outputs feed a Volt stage through a batched conversion
+  auto pipeline = units::make_pipeline<8, 4>(
+      1, units::map_stage<RawMilliVolt, MilliVolt>(gain),
+      units::map_stage<Volt, Volt>(offset), MeanOfFour{Volt(0), 0});
+  static_assert(std::is_same<decltype(pipeline)::element_type::Input,
+                             RawMilliVolt>::value,
+                "Pipeline input");
+  using VoltStage = units::MapStage<Volt, Volt, decltype(offset)>;
+  using MeterStage = units::MapStage<Meter, Meter, decltype(offset)>;
+  using RawStage = units::MapStage<RawMilliVolt, MilliVolt, decltype(gain)>;
+  static_assert(units::StagesConnect<RawStage, VoltStage, VoltStage>::value,
+                "MilliVolt converts to Volt");
+  static_assert(!units::StagesConnect<RawStage, MeterStage>::value,
+                "Stages of other dimensions do not connect");
+  static_assert(!units::StagesConnect<RawStage, VoltStage, MeterStage>::value,
+                "Every pair of stages connects");
+  // A dimensionless unit or a raw number does not stand in for a dimension
+  auto strip = [](const Volt &v) { return v.value(); };
+  using Unitless = units::PhysicalUnit<double>;
+  using ToUnitless = units::MapStage<Volt, Unitless, decltype(strip)>;
+  using ToDouble = units::MapStage<Volt, double, decltype(strip)>;
+  static_assert(std::is_constructible<Meter, Unitless>::value ||
+                    std::is_constructible<Meter, double>::value,
+                "Meters are built from plain numbers");
+  static_assert(!units::StagesConnect<ToUnitless, MeterStage>::value,
+                "A dimensionless output does not feed meters");
+  static_assert(!units::StagesConnect<ToDouble, MeterStage>::value,
+                "A raw output does not feed meters");
+  static_assert(units::SameDimension<units::PackedUnit<int, std::milli,
+                                                       std::ratio<2>>,
+                                     units::si::SquareMeter<>>::value,
+                "Packed units have the dimension they pack");
+  static_assert(!units::SameDimension<double, double>::value,
+                "Raw numbers have no dimension");
+
+  RawMilliVolt in[20];
+  for (int i = 0; i < 20; ++i)
+    in[i] = RawMilliVolt(500 * i);
+  EXPECT_EQ(pipeline->push_n(0, in, 20), 20u);
+  while (pipeline->poll()) {
+  }
+  EXPECT_TRUE(pipeline->idle());
+
+  Volt out[8];
+  EXPECT_EQ(pipeline->pop_n(0, out, 2), 2u);
+  EXPECT_EQ(pipeline->pop_n(0, out + 2, 8), 3u);
+  // 2 * 0.5 V * (0 + 1 + 2 + 3) / 4 + 1 V
+  EXPECT_DOUBLE_EQ(out[0].value(), 2.5);
+  EXPECT_DOUBLE_EQ(out[4].value(), 2 * 0.5 * 17.5 + 1);
+
+  EXPECT_EQ(std::uint64_t(pipeline->metrics(0).values.value()), 20u);
+  EXPECT_EQ(std::uint64_t(pipeline->metrics(2).batches.value()), 3u);
+  EXPECT_EQ(pipeline->metrics(1).latency.snapshot().count(), 3u);
+}
+
+TEST(PipelineTests, Backpressure) {
+  auto pipeline = units::make_pipeline<4, 2>(
+      1, units::map_stage<Volt, Volt>(offset));
+  Volt in[20];
+  for (int i = 0; i < 20; ++i)
+    in[i] = Volt(i);
+  // Two batches on the way in, then two more once the stage moved them out
+  EXPECT_EQ(pipeline->push_n(0, in, 20), 8u);
+  EXPECT_EQ(pipeline->push_n(0, in + 8, 12), 0u);
+  while (pipeline->poll()) {
+  }
+  EXPECT_TRUE(pipeline->idle());
+  EXPECT_EQ(pipeline->push_n(0, in + 8, 12), 8u);
+  // The outputs are not popped, so the stage holds its inputs
+  EXPECT_FALSE(pipeline->poll());
+  EXPECT_FALSE(pipeline->idle());
+
+  Volt out[20];
+  std::size_t popped = 0;
+  do {
+    pipeline->poll();
+    popped += pipeline->pop_n(0, out + popped, 20 - popped);
+  } while (popped < 16);
+  for (int i = 0; i < 16; ++i)
+    EXPECT_DOUBLE_EQ(out[i].value(), i + 1.);
+}
+
+TEST(PipelineTests, Workers) {
+  const unsigned lanes = 4;
+  const int count = 50000;
+  auto pipeline = units::make_pipeline<64, 4>(
+      lanes, units::map_stage<RawMilliVolt, MilliVolt>(gain),
+      units::map_stage<Volt, Volt>(offset));
+  pipeline->start(3);
+
+  std::vector<std::thread> consumers;
+  std::vector<int> ordered(lanes, 1);
+  for (unsigned l = 0; l < lanes; ++l)
+    consumers.emplace_back([&, l]() {
+      Volt out[100];
+      for (int received = 0; received < count;) {
+        const std::size_t n = pipeline->pop_n(l, out, 100);
+        for (std::size_t i = 0; i < n; ++i)
+          ordered[l] &= out[i].value() == 2e-3 * (received + int(i)) + 1;
+        received += int(n);
+        if (n == 0)
+          std::this_thread::yield();
+      }
+    });
+
+  RawMilliVolt in[128];
+  std::vector<int> sent(lanes, 0);
+  for (bool done = false; !done;) {
+    done = true;
+    for (unsigned l = 0; l < lanes; ++l) {
+      const int n = count - sent[l] < 128 ? count - sent[l] : 128;
+      for (int i = 0; i < n; ++i)
+        in[i] = RawMilliVolt(sent[l] + i);
+      sent[l] += int(pipeline->push_n(l, in, std::size_t(n)));
+      done &= sent[l] == count;
+    }
+  }
+  for (std::thread &consumer : consumers)
+    consumer.join();
+  pipeline->stop();
+
+  for (unsigned l = 0; l < lanes; ++l)
+    EXPECT_TRUE(ordered[l]);
+  EXPECT_EQ(std::uint64_t(pipeline->metrics(1).values.value()),
+            std::uint64_t(lanes) * count);
+  EXPECT_TRUE(pipeline->idle());
+}
+
+TEST(PipelineTests, ParkedWorkersWake) {
+  auto pipeline = units::make_pipeline<16, 4>(
+      2, units::map_stage<Volt, Volt>(offset));
+  pipeline->start(2);
+  Volt in[40], out[40];
+  for (int i = 0; i < 40; ++i)
+    in[i] = Volt(i);
+  // The workers run out of rounds and sleep before every push
+  for (unsigned l = 0; l < 2; ++l) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(pipeline->push_n(l, in, 40), 40u);
+    for (std::size_t popped = 0; popped < 40;)
+      popped += pipeline->pop_n(l, out + popped, 40 - popped);
+    EXPECT_DOUBLE_EQ(out[39].value(), 40.);
+  }
+  pipeline->stop();
+}
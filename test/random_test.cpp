@@ -0,0 +1,157 @@
+#include "phys_random.hpp"
+#include "phys_si.hpp"
+#include <cmath>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+using Kelvin = units::si::Kelvin<double>;
+using MilliKelvin = units::si::Temperature<double, std::milli>;
+using TempKelvin = units::si::TempKelvin<double>;
+using TempCelsius = units::si::TempCelsius<double>;
+using NanoSecond = units::si::NanoSecond<std::int64_t>;
+using MicroSecond = units::si::MicroSecond<double>;
+using Meter = units::si::Meter<double>;
+using CentiMeter = units::si::CentiMeter<double>;
+using Heading = units::AbsoluteAngle<double>;
+using HeadingDiff = units::PhysicalUnitAngle<double, std::ratio<1>>;
+using Bam = units::AbsoluteAngle<std::int32_t, std::ratio<360, 65536>>;
+using UnsignedBam =
+    units::AbsoluteAngle<std::uint32_t, std::ratio<360, 65536>>;
+
+template <typename Unit> double mean_of(const std::vector<Unit> &samples) {
+  double sum = 0;
+  for (const Unit &sample : samples)
+    sum += double(units::raw_value(sample));
+  return sum / double(samples.size());
+}
+
+TEST(RandomTests, Philox) {
+  // Known answers of Philox4x32-10 for the zero and the pi counters
+  std::uint32_t w[4];
+  units::Philox(0).blocks(0, 0, 1, w, w + 1, w + 2, w + 3);
+  EXPECT_EQ(w[0], 0x6627e8d5u);
+  EXPECT_EQ(w[1], 0xe169c58du);
+  EXPECT_EQ(w[2], 0xbc57ac4cu);
+  EXPECT_EQ(w[3], 0x9b00dbd8u);
+  units::Philox(0x299f31d0a4093822ull, 0x03707344u)
+      .blocks(0x85a308d3243f6a88ull, 0x13198a2eu, 1, w, w + 1, w + 2, w + 3);
+  EXPECT_EQ(w[0], 0xd16cfe09u);
+  EXPECT_EQ(w[1], 0x94fdccebu);
+  EXPECT_EQ(w[2], 0x5001e420u);
+  EXPECT_EQ(w[3], 0x24126ea1u);
+}
+
+TEST(RandomTests, Uniform) {
+  const units::Philox rng(42);
+  // Bounds in centimeters, samples in meters
+  const units::UniformDistribution<Meter> length(CentiMeter(100),
+                                                 CentiMeter(300));
+  std::vector<Meter> samples(100000);
+  length.generate(rng, 0, samples.size(), samples.data());
+  for (const Meter &sample : samples)
+    ASSERT_TRUE(sample.value() >= 1 && sample.value() < 3);
+  EXPECT_NEAR(mean_of(samples), 2, 0.01);
+
+  const units::UniformDistribution<Heading> heading;
+  std::vector<Heading> headings(100000);
+  heading.generate(rng, 0, headings.size(), headings.data());
+  EXPECT_NEAR(mean_of(headings), 180, 1);
+  EXPECT_LT(units::circular_stats(headings.data(), headings.size()).resultant,
+            0.01);
+
+  const units::UniformDistribution<Bam> sector(Heading(350), HeadingDiff(20));
+  std::vector<Bam> bams(1000);
+  sector.generate(rng, 0, bams.size(), bams.data());
+  for (const Bam &bam : bams)
+    ASSERT_TRUE(bam.value() >= 63716 || bam.value() <= 1821);
+
+  // Integral samples round down, every value of [0, 10) equally often
+  using IntMeter = units::si::Meter<int>;
+  const units::UniformDistribution<IntMeter> digit(IntMeter(0), IntMeter(10));
+  std::vector<IntMeter> digits(100000);
+  digit.generate(rng, 0, digits.size(), digits.data());
+  int counts[10] = {};
+  for (const IntMeter &d : digits) {
+    ASSERT_TRUE(d.value() >= 0 && d.value() < 10);
+    ++counts[d.value()];
+  }
+  for (int count : counts)
+    EXPECT_NEAR(count, 10000, 500);
+}
+
+TEST(RandomTests, NormalAndExponential) {
+  const units::Philox rng(7, 3);
+  // Noise of 50 mK around 20 degrees Celsius, drawn as absolute Kelvin
+  const units::NormalDistribution<TempKelvin> noise(TempCelsius(20),
+                                                    MilliKelvin(50));
+  std::vector<TempKelvin> temperatures(200000);
+  noise.generate(rng, 0, temperatures.size(), temperatures.data());
+  const double mean = mean_of(temperatures);
+  double variance = 0;
+  for (const TempKelvin &t : temperatures)
+    variance += (t.value() - mean) * (t.value() - mean);
+  variance /= double(temperatures.size());
+  EXPECT_NEAR(mean, 293.15, 0.001);
+  EXPECT_NEAR(std::sqrt(variance), 0.05, 0.001);
+
+  // Integral nanoseconds from a mean in microseconds
+  const units::ExponentialDistribution<NanoSecond> jitter(MicroSecond(2.5));
+  std::vector<NanoSecond> delays(200000);
+  jitter.generate(rng, 0, delays.size(), delays.data());
+  for (const NanoSecond &delay : delays)
+    ASSERT_GE(delay.value(), 0);
+  EXPECT_NEAR(mean_of(delays), 2500, 25);
+}
+
+TEST(RandomTests, VonMises) {
+  const units::Philox rng(11);
+  const units::VonMisesDistribution<Heading> around(Heading(350), 8.);
+  std::vector<Heading> headings(100000);
+  around.generate(rng, 0, headings.size(), headings.data());
+  const auto stats = units::circular_stats(headings.data(), headings.size());
+  EXPECT_NEAR(units::shortest_arc(Heading(350), stats.mean).value(), 0, 0.5);
+  // Mean resultant length I1(8) / I0(8)
+  EXPECT_NEAR(stats.resultant, 0.9355, 0.003);
+
+  const units::VonMisesDistribution<Bam> anywhere(Bam(0), 0.);
+  std::vector<Bam> bams(100000);
+  anywhere.generate(rng, 0, bams.size(), bams.data());
+  EXPECT_LT(units::circular_stats(bams.data(), bams.size()).resultant, 0.01);
+
+  // Unsigned angles below the mean of 0 wrap to the top of the turn
+  const units::VonMisesDistribution<UnsignedBam> north(UnsignedBam(0u), 8.);
+  std::vector<UnsignedBam> unsignedBams(100000);
+  north.generate(rng, 0, unsignedBams.size(), unsignedBams.data());
+  std::size_t west = 0, ahead = 0;
+  for (const UnsignedBam &bam : unsignedBams) {
+    ASSERT_LT(bam.value(), 65536u);
+    west += bam.value() > 32768;
+    ahead += bam.value() < 16384 || bam.value() > 49152;
+  }
+  EXPECT_NEAR(double(west) / double(unsignedBams.size()), 0.5, 0.01);
+  EXPECT_GT(double(ahead) / double(unsignedBams.size()), 0.999);
+}
+
+TEST(RandomTests, Streams) {
+  const units::NormalDistribution<Meter> noise(Meter(0), Meter(1));
+  const units::Philox rng(2024, 5);
+  std::vector<Meter> serial(100000), threaded(100000);
+  units::draw_n(noise, rng, 1000, serial.size(), serial.data());
+  units::draw_n(noise, rng, 1000, threaded.size(), threaded.data(), 3);
+  EXPECT_TRUE(serial == threaded);
+
+  // A stream drawn in pieces gives the same samples
+  units::RandomStream stream(2024, 5);
+  stream.seek(1000);
+  std::vector<Meter> pieces(100000);
+  stream.draw(noise, pieces.data(), 300);
+  stream.draw(noise, pieces.data() + 300, pieces.size() - 300);
+  EXPECT_TRUE(serial == pieces);
+  EXPECT_EQ(stream.position(), 101000u);
+
+  // Other streams and seeds differ
+  units::RandomStream other(2024, 6);
+  other.seek(1000);
+  EXPECT_NE(other.draw<Meter>(noise), serial[0]);
+}
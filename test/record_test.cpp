@@ -0,0 +1,105 @@
+#include "phys_record.hpp"
+#include "phys_angle.hpp"
+#include "phys_si.hpp"
+#include <gtest/gtest.h>
+
+using TimeStampMilliSeconds =
+    units::AbsolutePhysicalUnit<int64_t, std::milli, int64_t, std::ratio<0>,
+                                std::ratio<0>, std::ratio<0>, std::ratio<1>>;
+using TempCelsius = units::si::TempCelsius<float>;
+using Heading = units::AbsoluteAngle<float, std::ratio<1>, false>;
+using Volt = units::si::Volt<double>;
+using Batch =
+    units::RecordBatch<TimeStampMilliSeconds, TempCelsius, Heading, Volt>;
+
+TEST(RecordTests, Rows) {
+  units::MonotonicArena arena(1024);
+  Batch batch(arena, 3);
+  ASSERT_TRUE(batch.valid());
+  EXPECT_TRUE(batch.append(TimeStampMilliSeconds(1000), TempCelsius(21.5f),
+                           Heading(370.f), Volt(3.3)));
+  EXPECT_TRUE(batch.append(TimeStampMilliSeconds(1010), TempCelsius(21.7f),
+                           Heading(-10.f), Volt(3.2)));
+  EXPECT_EQ(batch.size(), 2u);
+  EXPECT_EQ(batch.get<0>(1), TimeStampMilliSeconds(1010));
+  EXPECT_FLOAT_EQ(batch.row(0).get<2>().value(), 10.f);
+  EXPECT_FLOAT_EQ(batch.row(1).get<2>().value(), 350.f);
+  EXPECT_EQ(batch.row(1).get<3>(), Volt(3.2));
+  EXPECT_FLOAT_EQ(batch.column<1>()[0], 21.5f);
+
+  EXPECT_TRUE(batch.append(TimeStampMilliSeconds(1020), TempCelsius(0.f),
+                           Heading(0.f), Volt(0.)));
+  EXPECT_FALSE(batch.append(TimeStampMilliSeconds(1030), TempCelsius(0.f),
+                            Heading(0.f), Volt(0.)));
+  batch.clear();
+  EXPECT_EQ(batch.size(), 0u);
+  EXPECT_EQ(batch.capacity(), 3u);
+}
+
+TEST(RecordTests, Columns) {
+  units::MonotonicArena arena(1 << 16);
+  Batch batch(arena, 100);
+  TimeStampMilliSeconds times[150];
+  TempCelsius temps[150];
+  Heading headings[150];
+  Volt volts[150];
+  for (int i = 0; i < 150; ++i) {
+    times[i] = TimeStampMilliSeconds(i * 10);
+    temps[i] = TempCelsius(float(i));
+    headings[i] = Heading(float(i * 3));
+    volts[i] = Volt(i * 0.5);
+  }
+  EXPECT_EQ(batch.append_column<0>(times, 150), 100u);
+  EXPECT_EQ(batch.append_column<1>(temps, 150), 100u);
+  EXPECT_EQ(batch.append_column<2>(headings, 150), 100u);
+  EXPECT_EQ(batch.append_column<3>(volts, 150), 100u);
+  EXPECT_EQ(batch.size(), 0u);
+  EXPECT_EQ(batch.commit(150), 100u);
+  EXPECT_EQ(batch.size(), 100u);
+
+  const Batch slice = batch.slice(40, 20);
+  EXPECT_EQ(slice.size(), 20u);
+  EXPECT_EQ(slice.column<0>(), batch.column<0>() + 40);
+  EXPECT_EQ(slice.get<0>(0), TimeStampMilliSeconds(400));
+  EXPECT_EQ(slice.get<3>(19), Volt(29.5));
+  EXPECT_EQ(batch.slice(90, 20).size(), 10u);
+  EXPECT_EQ(batch.slice(200, 20).size(), 0u);
+}
+
+TEST(RecordTests, Arena) {
+  alignas(8) unsigned char buffer[256];
+  units::MonotonicArena fixed(buffer, sizeof(buffer));
+  Batch small(fixed, 8);
+  EXPECT_TRUE(small.valid());
+  Batch large(fixed, 100);
+  EXPECT_FALSE(large.valid());
+  EXPECT_EQ(large.capacity(), 0u);
+  EXPECT_FALSE(large.append(TimeStampMilliSeconds(0), TempCelsius(0.f),
+                            Heading(0.f), Volt(0.)));
+  fixed.release();
+  Batch reused(fixed, 8);
+  EXPECT_EQ(reused.column<0>(), small.column<0>());
+
+  units::MonotonicArena growing(128);
+  Batch first(growing, 4);
+  Batch big(growing, 1000);
+  EXPECT_TRUE(first.valid());
+  EXPECT_TRUE(big.valid());
+  growing.release();
+  Batch again(growing, 4);
+  EXPECT_EQ(again.column<0>(), first.column<0>());
+  Batch bigAgain(growing, 1000);
+  EXPECT_EQ(bigAgain.column<0>(), big.column<0>());
+
+  units::MonotonicArena scratch(1024);
+  Volt *volts = scratch.allocate_uninitialized<Volt>(64);
+  ASSERT_NE(volts, nullptr);
+  for (int i = 0; i < 64; ++i)
+    volts[i] = Volt(i * 0.5);
+  EXPECT_EQ(volts[63], Volt(31.5));
+  Heading *headings = scratch.allocate_uninitialized<Heading>(4);
+  ASSERT_NE(headings, nullptr);
+  headings[0] = Heading(370.f);
+  EXPECT_FLOAT_EQ(headings[0].value(), 10.f);
+  EXPECT_EQ(fixed.allocate_uninitialized<Volt>(1000), nullptr);
+}
@@ -0,0 +1,100 @@
+#include "phys_ring.hpp"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using TimeStampNanoSeconds =
+    units::AbsolutePhysicalUnit<int64_t, std::nano, int64_t, std::ratio<0>,
+                                std::ratio<0>, std::ratio<0>, std::ratio<1>>;
+using TimeStampMicroSeconds =
+    units::AbsolutePhysicalUnit<int64_t, std::micro, int64_t, std::ratio<0>,
+                                std::ratio<0>, std::ratio<0>, std::ratio<1>>;
+using Pascal = units::PhysicalUnit<int, std::ratio<1>, std::ratio<-1>,
+                                   std::ratio<1>, std::ratio<-2>>;
+using HectoPascal = units::PhysicalUnit<double, std::hecto, std::ratio<-1>,
+                                        std::ratio<1>, std::ratio<-2>>;
+
+using Sample = units::TimedSample<TimeStampNanoSeconds, Pascal>;
+using Reading = units::TimedSample<TimeStampMicroSeconds, HectoPascal>;
+
+TEST(RingTests, SpscBatches) {
+  static units::SpscRing<Sample, 8> ring;
+  Sample in[6];
+  for (int i = 0; i < 6; ++i)
+    in[i] = Sample(TimeStampNanoSeconds(i * 1000), Pascal(100000 + i));
+  EXPECT_EQ(ring.push_n(in, 6), 6u);
+  EXPECT_EQ(ring.push_n(in, 6), 2u);
+  EXPECT_EQ(ring.size(), 8u);
+  EXPECT_FALSE(ring.push(in[0]));
+
+  Sample out[8];
+  EXPECT_EQ(ring.pop_n(out, 5), 5u);
+  EXPECT_EQ(out[4].value, Pascal(100004));
+  EXPECT_EQ(ring.push_n(in, 6), 5u);
+
+  Reading readings[16];
+  EXPECT_EQ(ring.pop_n(readings, 16), 8u);
+  EXPECT_EQ(readings[0].time.value(), 5);
+  EXPECT_DOUBLE_EQ(readings[0].value.value(), 1000.05);
+  EXPECT_EQ(readings[3].time.value(), 0);
+  EXPECT_DOUBLE_EQ(readings[7].value.value(), 1000.04);
+  EXPECT_TRUE(ring.empty());
+  EXPECT_FALSE(ring.pop(out[0]));
+}
+
+TEST(RingTests, SpscThreads) {
+  static units::SpscRing<Sample, 1024> ring;
+  const int count = 200000;
+  std::thread producer([]() {
+    Sample batch[32];
+    for (int sent = 0; sent < count;) {
+      const int n = count - sent < 32 ? count - sent : 32;
+      for (int i = 0; i < n; ++i)
+        batch[i] = Sample(TimeStampNanoSeconds(sent + i), Pascal(sent + i));
+      sent += int(ring.push_n(batch, std::size_t(n)));
+    }
+  });
+  bool ordered = true;
+  Sample batch[64];
+  for (int received = 0; received < count;) {
+    const std::size_t n = ring.pop_n(batch, 64);
+    for (std::size_t i = 0; i < n; ++i)
+      ordered &= batch[i].value.value() == received + int(i) &&
+                 batch[i].time.value() == received + int(i);
+    received += int(n);
+  }
+  producer.join();
+  EXPECT_TRUE(ordered);
+}
+
+TEST(RingTests, MpscThreads) {
+  static units::MpscRing<Sample, 256> ring;
+  const int producers = 4;
+  const int count = 50000;
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p)
+    threads.emplace_back([p]() {
+      Sample batch[8];
+      for (int sent = 0; sent < count;) {
+        const int n = count - sent < 8 ? count - sent : 8;
+        for (int i = 0; i < n; ++i)
+          batch[i] = Sample(TimeStampNanoSeconds(p), Pascal(sent + i));
+        sent += int(ring.push_n(batch, std::size_t(n)));
+      }
+    });
+  std::vector<int> next(producers, 0);
+  bool ordered = true;
+  Sample batch[32];
+  for (int received = 0; received < producers * count;) {
+    const std::size_t n = ring.pop_n(batch, 32);
+    for (std::size_t i = 0; i < n; ++i) {
+      const int p = int(batch[i].time.value());
+      ordered &= batch[i].value.value() == next[p]++;
+    }
+    received += int(n);
+  }
+  for (auto &thread : threads)
+    thread.join();
+  EXPECT_TRUE(ordered);
+  EXPECT_TRUE(ring.empty());
+}
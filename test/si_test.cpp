@@ -0,0 +1,40 @@
+#include "phys_si.hpp"
+#include "phys_string.hpp"
+#include <gtest/gtest.h>
+#include <type_traits>
+
+using namespace units::si;
+
+TEST(SiCatalogueTests, DerivedUnits) {
+  static_assert(std::is_same<decltype(Newton<>() * Meter<>()), Joule<>>::value,
+                "N m = J");
+  static_assert(std::is_same<decltype(Joule<>() / Second<>()), Watt<>>::value,
+                "J/s = W");
+  static_assert(std::is_same<decltype(Watt<>() / Ampere<>()), Volt<>>::value,
+                "W/A = V");
+  static_assert(std::is_same<decltype(Volt<>() / Ampere<>()), Ohm<>>::value,
+                "V/A = Ohm");
+  static_assert(std::is_same<decltype(Coulomb<>() / Volt<>()), Farad<>>::value,
+                "C/V = F");
+  static_assert(std::is_same<decltype(Weber<>() / SquareMeter<>()),
+                             Tesla<>>::value,
+                "Wb/m^2 = T");
+  static_assert(std::is_same<decltype(Weber<>() / Ampere<>()), Henry<>>::value,
+                "Wb/A = H");
+  static_assert(
+      std::is_same<decltype(Newton<>() / SquareMeter<>()), Pascal<>>::value,
+      "N/m^2 = Pa");
+  EXPECT_EQ(std::to_string(Volt<int>(5)), "5V");
+}
+
+TEST(SiCatalogueTests, Prefixes) {
+  KiloMeterPerHour<> speed(MeterPerSecond<>(10.));
+  EXPECT_NEAR(speed.value(), 36., 0.000001);
+  EXPECT_NEAR(Bar<>(HectoPascal<>(1013.25)).value(), 1.01325, 0.000001);
+  EXPECT_NEAR(WattHour<>(KiloJoule<>(36.)).value(), 10., 0.000001);
+  EXPECT_EQ(MilliSecond<int>(Minute<int>(2)).value(), 120000);
+  EXPECT_NEAR(Liter<>(CubicMeter<>(2.)).value(), 2000., 0.000001);
+  EXPECT_NEAR(Degree<>(Radian<>(1.)).value(), 57.296, 0.000001);
+  TempKelvin<> freezing(TempCelsius<>(0.));
+  EXPECT_NEAR(freezing.value(), 273.15, 0.000001);
+}
@@ -0,0 +1,193 @@
+#include "phys_span.hpp"
+#include "phys_algorithm.hpp"
+#include "phys_angle.hpp"
+#include "phys_dim.hpp"
+#include "phys_fixed.hpp"
+#include "phys_si.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <vector>
+
+using MilliVolt = units::si::MilliVolt<std::int16_t>;
+using Volt = units::si::Volt<double>;
+using TempCelsius = units::si::TempCelsius<float>;
+using TempKelvin = units::si::TempKelvin<double>;
+
+TEST(SpanTests, Layout) {
+  static_assert(units::UnitLayout<units::si::Meter<float>>::compatible,
+                "Lengths are laid out as their values");
+  static_assert(units::UnitLayout<const MilliVolt>::compatible,
+                "Const units too");
+  static_assert(units::UnitLayout<TempCelsius>::compatible,
+                "Absolute units are laid out as their values");
+  static_assert(
+      !units::UnitLayout<units::AbsoluteAngle<double>>::compatible,
+      "Angles with virtual members are not");
+  static_assert(units::UnitLayout<units::PhysicalUnit<
+                    double, std::ratio<1>, std::ratio<1>>>::compatible,
+                "PhysicalUnit<double> is laid out as a double");
+  static_assert(units::UnitLayout<units::PhysicalUnit<
+                    float, std::milli, std::ratio<1>>>::compatible,
+                "PhysicalUnit<float> is laid out as a float");
+  static_assert(units::UnitLayout<units::PhysicalUnit<
+                    std::int16_t, std::ratio<1>, std::ratio<1>>>::compatible,
+                "PhysicalUnit<int16_t> is laid out as an int16_t");
+  static_assert(units::UnitLayout<units::PhysicalUnit<
+                    std::int64_t, std::ratio<1>, std::ratio<1>>>::compatible,
+                "PhysicalUnit<int64_t> is laid out as an int64_t");
+  static_assert(
+      units::UnitLayout<units::AbsolutePhysicalUnit<double>>::compatible,
+      "AbsolutePhysicalUnit<double> is laid out as a double");
+  static_assert(
+      units::UnitLayout<units::AbsolutePhysicalUnit<std::int32_t>>::compatible,
+      "AbsolutePhysicalUnit<int32_t> is laid out as an int32_t");
+}
+
+TEST(SpanTests, Views) {
+  std::int16_t raw[] = {120, -40, 3300, 15, 0};
+  auto span = units::quantity_span<MilliVolt>(raw, 5);
+  EXPECT_EQ(span.size(), 5u);
+  EXPECT_FALSE(span.empty());
+  EXPECT_EQ(span[2], MilliVolt(3300));
+  EXPECT_EQ(span.raw(), raw);
+
+  span[1] += MilliVolt(10);
+  EXPECT_EQ(raw[1], -30);
+  EXPECT_EQ(*std::max_element(span.begin(), span.end()), MilliVolt(3300));
+  EXPECT_EQ(std::accumulate(span.begin(), span.end(), MilliVolt(0)),
+            MilliVolt(3405));
+
+  units::radix_sort(span.data(), span.size());
+  EXPECT_EQ(raw[0], -30);
+  EXPECT_EQ(raw[4], 3300);
+
+  const units::QuantitySpan<const MilliVolt> read = span.subspan(3, 10);
+  EXPECT_EQ(read.size(), 2u);
+  EXPECT_EQ(read[0], MilliVolt(120));
+  EXPECT_TRUE(span.subspan(7, 1).empty());
+
+  const double values[] = {1.5, 2.5};
+  auto constant = units::quantity_span<const Volt>(values, 2);
+  EXPECT_EQ(constant[1], Volt(2.5));
+  EXPECT_TRUE(units::QuantitySpan<Volt>().empty());
+}
+
+TEST(SpanTests, Rescaled) {
+  std::int16_t raw[] = {120, -40, 3300};
+  auto volts = units::as<Volt>(units::quantity_span<MilliVolt>(raw, 3));
+  EXPECT_EQ(volts.size(), 3u);
+  EXPECT_DOUBLE_EQ(volts[0].value(), 0.12);
+  EXPECT_DOUBLE_EQ((*std::max_element(volts.begin(), volts.end())).value(),
+                   3.3);
+  auto it = volts.begin();
+  it += 2;
+  EXPECT_EQ(it - volts.begin(), 2);
+  EXPECT_DOUBLE_EQ((*--it).value(), -0.04);
+  EXPECT_DOUBLE_EQ(volts.begin()[2].value(), 3.3);
+  EXPECT_TRUE(volts.begin() < volts.end());
+  EXPECT_EQ(volts.begin() + 3, volts.end());
+
+  raw[0] = 500;
+  EXPECT_DOUBLE_EQ(volts[0].value(), 0.5);
+
+  const float celsius[] = {0.f, 100.f, -273.15f};
+  auto kelvin = units::as<TempKelvin>(
+      units::quantity_span<const TempCelsius>(celsius, 3));
+  EXPECT_NEAR(kelvin[0].value(), 273.15, 1e-4);
+  EXPECT_NEAR(kelvin[1].value(), 373.15, 1e-4);
+  EXPECT_NEAR(kelvin[2].value(), 0., 1e-4);
+}
+
+TEST(SpanTests, Blocks) {
+  std::vector<std::int16_t> raw(600);
+  for (std::size_t i = 0; i < raw.size(); ++i)
+    raw[i] = std::int16_t(i);
+  auto volts =
+      units::as<Volt>(units::quantity_span<MilliVolt>(raw.data(), raw.size()));
+
+  Volt out[10];
+  EXPECT_EQ(volts.copy(595, 10, out), 5u);
+  EXPECT_DOUBLE_EQ(out[4].value(), 0.599);
+  EXPECT_EQ(volts.copy(700, 10, out), 0u);
+
+  std::size_t blocks = 0, total = 0;
+  double sum = 0;
+  volts.for_each_block([&](const Volt *block, std::size_t count) {
+    ++blocks;
+    total += count;
+    for (std::size_t i = 0; i < count; ++i)
+      sum += block[i].value();
+  });
+  EXPECT_EQ(blocks, 3u);
+  EXPECT_EQ(total, 600u);
+  EXPECT_NEAR(sum, 599. * 600. / 2. / 1000., 1e-9);
+}
+
+// A unit class is trivially copyable and destructible, so buffers of it can
+// be copied as bytes and dropped without destructors, and constructible
+// unset from the Uninitialized tag; only the default constructor writes.
+template <typename Unit> struct BulkBufferSafe {
+  static constexpr bool value =
+      std::is_trivially_copyable<Unit>::value &&
+      std::is_trivially_destructible<Unit>::value &&
+      std::is_constructible<Unit, units::Uninitialized>::value &&
+      !std::is_convertible<units::Uninitialized, Unit>::value &&
+      !std::is_trivially_default_constructible<Unit>::value;
+};
+
+TEST(SpanTests, BulkBufferSafe) {
+  using Packed = units::PackedUnit<float, std::ratio<1>, std::ratio<1>>;
+  using Q16 = units::Fixed<std::int32_t, 16>;
+  static_assert(BulkBufferSafe<units::si::Meter<double>>::value,
+                "PhysicalUnit");
+  static_assert(BulkBufferSafe<MilliVolt>::value, "Integral PhysicalUnit");
+  static_assert(BulkBufferSafe<units::PhysicalUnit<double, std::milli>>::value,
+                "Dimensionless PhysicalUnit");
+  static_assert(BulkBufferSafe<TempCelsius>::value, "AbsolutePhysicalUnit");
+  static_assert(BulkBufferSafe<Packed>::value, "Quantity");
+  static_assert(BulkBufferSafe<units::PackedUnit<int, std::ratio<1>>>::value,
+                "Dimensionless Quantity");
+  static_assert(BulkBufferSafe<Q16>::value, "Fixed");
+  static_assert(BulkBufferSafe<units::PhysicalUnit<Q16, std::ratio<1>,
+                                                   std::ratio<1>>>::value,
+                "PhysicalUnit of Fixed");
+
+  // The virtual setValue() makes angles copy through their constructor
+  using Heading = units::AbsoluteAngle<double>;
+  static_assert(!std::is_trivially_copyable<Heading>::value,
+                "AbsoluteAngle is not trivially copyable");
+  static_assert(
+      std::is_trivially_destructible<Heading>::value &&
+          std::is_constructible<Heading, units::Uninitialized>::value,
+      "AbsoluteAngle is constructible unset");
+
+  // The default constructors still set zero, in constant expressions too
+  static_assert(units::si::Meter<double>().value() == 0., "PhysicalUnit");
+  static_assert(MilliVolt().value() == 0, "Integral PhysicalUnit");
+  static_assert(TempCelsius().value() == 0., "AbsolutePhysicalUnit");
+}
+
+TEST(SpanTests, UninitializedVector) {
+  units::UninitializedVector<Volt> volts(1000);
+  EXPECT_EQ(volts.size(), 1000u);
+  for (std::size_t i = 0; i < volts.size(); ++i)
+    volts[i] = Volt(double(i));
+  volts.resize(10);
+  volts.resize(20, Volt(-1.));
+  EXPECT_EQ(volts[9], Volt(9.));
+  EXPECT_EQ(volts[19], Volt(-1.));
+  volts.push_back(Volt(2.));
+  EXPECT_EQ(volts.back(), Volt(2.));
+
+  auto span = units::QuantitySpan<Volt>(volts.data(), volts.size());
+  EXPECT_EQ(span.raw()[9], 9.);
+
+  // Types without the tag are value initialized as usual
+  units::UninitializedVector<int> counts(4);
+  EXPECT_EQ(counts[3], 0);
+  units::UninitializedVector<Volt> copy(volts);
+  EXPECT_EQ(copy[19], Volt(-1.));
+  EXPECT_TRUE(copy.get_allocator() == volts.get_allocator());
+}
@@ -0,0 +1,100 @@
+#include "phys_stats.hpp"
+#include <gtest/gtest.h>
+#include <type_traits>
+
+using Meter = units::PhysicalUnit<int, std::ratio<1>, std::ratio<1>>;
+using MeterSquared = units::PhysicalUnit<int, std::ratio<1>, std::ratio<2>>;
+using TempCelsius = units::AbsolutePhysicalUnit<
+    double, std::ratio<1>, double, std::ratio<27315, 100>, std::ratio<0>,
+    std::ratio<0>, std::ratio<0>, std::ratio<0>, std::ratio<1>>;
+
+TEST(StatsTests, RunningStatsTypes) {
+  using Stats = units::RunningStats<Meter>;
+  static_assert(
+      std::is_same<Stats::MeanType, units::PhysicalUnit<double, std::ratio<1>,
+                                                        std::ratio<1>>>::value,
+      "Mean must be in meters");
+  static_assert(
+      std::is_same<Stats::VarianceType,
+                   units::PhysicalUnit<double, std::ratio<1>,
+                                       std::ratio<2>>>::value,
+      "Variance must be in square meters");
+  using TempStats = units::RunningStats<TempCelsius>;
+  static_assert(std::is_same<TempStats::MeanType, TempCelsius>::value,
+                "Mean of an absolute unit must stay absolute");
+  static_assert(std::is_same<TempStats::DiffType,
+                             TempCelsius::DiffPhysicalUnit>::value,
+                "Deviation must be a temperature difference");
+}
+
+TEST(StatsTests, RunningStatsValues) {
+  units::RunningStats<Meter> stats;
+  EXPECT_EQ(stats.count(), 0u);
+  EXPECT_EQ(stats.min().value(), 0);
+  const int samples[] = {2, 4, 4, 4, 5, 5, 7, 9};
+  for (int s : samples)
+    stats.push(Meter(s));
+  EXPECT_EQ(stats.count(), 8u);
+  EXPECT_NEAR(stats.mean().value(), 5., 0.000001);
+  EXPECT_NEAR(stats.variance().value(), 4., 0.000001);
+  EXPECT_NEAR(stats.sample_variance().value(), 32. / 7., 0.000001);
+  EXPECT_NEAR(stats.stddev().value(), 2., 0.000001);
+  EXPECT_EQ(stats.min(), Meter(2));
+  EXPECT_EQ(stats.max(), Meter(9));
+}
+
+TEST(StatsTests, RunningStatsMerge) {
+  units::RunningStats<Meter> whole, left, right;
+  for (int i = 0; i < 100; ++i) {
+    whole.push(Meter(i * i % 37));
+    (i % 3 ? left : right).push(Meter(i * i % 37));
+  }
+  left.merge(right);
+  EXPECT_EQ(left.count(), whole.count());
+  EXPECT_NEAR(left.mean().value(), whole.mean().value(), 0.000001);
+  EXPECT_NEAR(left.variance().value(), whole.variance().value(), 0.000001);
+  EXPECT_EQ(left.min(), whole.min());
+  EXPECT_EQ(left.max(), whole.max());
+  units::RunningStats<Meter> empty;
+  empty.merge(whole);
+  EXPECT_NEAR(empty.mean().value(), whole.mean().value(), 0.000001);
+}
+
+TEST(StatsTests, AbsoluteMean) {
+  units::RunningStats<TempCelsius> stats;
+  stats.push(TempCelsius(20.));
+  stats.push(TempCelsius(24.));
+  TempCelsius mean = stats.mean();
+  EXPECT_NEAR(mean.value(), 22., 0.000001);
+  EXPECT_NEAR(stats.stddev().value(), 2., 0.000001);
+}
+
+TEST(StatsTests, ExpMovingAverage) {
+  units::ExpMovingAverage<Meter> ema(0.5);
+  EXPECT_FALSE(ema.seeded());
+  ema.push(Meter(10));
+  EXPECT_NEAR(ema.value().value(), 10., 0.000001);
+  ema.push(Meter(20));
+  EXPECT_NEAR(ema.value().value(), 15., 0.000001);
+  ema.push(Meter(15));
+  EXPECT_NEAR(ema.value().value(), 15., 0.000001);
+}
+
+TEST(StatsTests, P2Quantile) {
+  units::P2Quantile<Meter> median(0.5), p90(0.9);
+  median.push(Meter(3));
+  median.push(Meter(1));
+  median.push(Meter(2));
+  EXPECT_NEAR(median.value().value(), 2., 0.000001);
+  // Up to five samples the quantile is taken from the sorted samples
+  units::P2Quantile<Meter> p90OfFive(0.9);
+  for (int i = 1; i <= 5; ++i)
+    p90OfFive.push(Meter(i));
+  EXPECT_NEAR(p90OfFive.value().value(), 5., 0.000001);
+  for (int i = 0; i < 1000; ++i) {
+    median.push(Meter(i * 7919 % 1000));
+    p90.push(Meter(i * 7919 % 1000));
+  }
+  EXPECT_NEAR(median.value().value(), 500., 20.);
+  EXPECT_NEAR(p90.value().value(), 900., 20.);
+}
@@ -0,0 +1,90 @@
+#include "phys_string.hpp"
+#include <cstdio>
+#include <gtest/gtest.h>
+
+using Meter = units::PhysicalUnit<int, std::ratio<1>, std::ratio<1>>;
+using KiloMeter = units::PhysicalUnit<int, std::kilo, std::ratio<1>>;
+using MeterPerSecond =
+    units::PhysicalUnit<int, std::ratio<1>, std::ratio<1>, std::ratio<0>,
+                        std::ratio<-1>>;
+using Newton = units::PhysicalUnit<int, std::ratio<1>, std::ratio<1>,
+                                   std::ratio<1>, std::ratio<-2>>;
+using RootHertz = units::PhysicalUnit<int, std::ratio<1>, std::ratio<0>,
+                                      std::ratio<0>, std::ratio<-1, 2>>;
+using TempCelsius = units::AbsolutePhysicalUnit<
+    int, std::ratio<1>, int, std::ratio<27315, 100>, std::ratio<0>,
+    std::ratio<0>, std::ratio<0>, std::ratio<0>, std::ratio<1>>;
+using Volt = units::PhysicalUnit<int, std::ratio<1>, std::ratio<2>,
+                                 std::ratio<1>, std::ratio<-3>, std::ratio<-1>>;
+
+TEST(StringTests, Dimensions) {
+  EXPECT_EQ(std::to_string(Meter(3)), "3m");
+  EXPECT_EQ(std::to_string(KiloMeter(3)), "3km");
+  EXPECT_EQ(std::to_string(MeterPerSecond(2)), "2m s^-1");
+  EXPECT_EQ(std::to_string(Newton(5)), "5m kg s^-2");
+  EXPECT_EQ(std::to_string(RootHertz(1)), "1s^-1/2");
+  EXPECT_EQ(std::to_string(Volt(12)), "12V");
+}
+
+TEST(StringTests, AbsoluteUnits) {
+  EXPECT_EQ(std::to_string(TempCelsius(20)), "20K");
+}
+
+template <typename Unit> std::string formatted(const Unit &val) {
+  char buffer[400];
+  const std::size_t length = units::format_unit(val, buffer, sizeof(buffer));
+  EXPECT_EQ(length, std::string(buffer).size());
+  return buffer;
+}
+
+TEST(StringTests, Buffers) {
+  using MilliVolt = units::PhysicalUnit<double, std::milli, std::ratio<2>,
+                                        std::ratio<1>, std::ratio<-3>,
+                                        std::ratio<-1>>;
+  using Feet = units::PhysicalUnit<float, std::ratio<3048, 10000>,
+                                   std::ratio<1>>;
+  using Count = units::PhysicalUnit<unsigned long long, std::ratio<1>,
+                                    std::ratio<0>, std::ratio<0>,
+                                    std::ratio<-1>>;
+  EXPECT_EQ(formatted(Meter(-3)), std::to_string(Meter(-3)));
+  EXPECT_EQ(formatted(KiloMeter(3)), "3km");
+  EXPECT_EQ(formatted(MeterPerSecond(2)), std::to_string(MeterPerSecond(2)));
+  EXPECT_EQ(formatted(Newton(5)), std::to_string(Newton(5)));
+  EXPECT_EQ(formatted(RootHertz(1)), std::to_string(RootHertz(1)));
+  EXPECT_EQ(formatted(Volt(12)), "12V");
+  EXPECT_EQ(formatted(TempCelsius(20)), std::to_string(TempCelsius(20)));
+  EXPECT_EQ(formatted(Count(18446744073709551615ull)),
+            std::to_string(Count(18446744073709551615ull)));
+  for (double value : {0., -0., 3.3, -1.0000005, 0.9999996, 123456.789012,
+                       1e13 + 0.5, 1e20, -2.5e-7})
+    EXPECT_EQ(formatted(MilliVolt(value)), std::to_string(MilliVolt(value)));
+  // Rounded once from the exact binary value, half way cases to even
+  for (double value : {5e-7, 0.1234565, 0.0078125, 0.0234375, 2.5e-7, 1.5e300,
+                       1e22, 1.7976931348623157e308, 4.9e-324, 2.2e-308})
+    EXPECT_EQ(formatted(MilliVolt(value)), std::to_string(MilliVolt(value)));
+  EXPECT_EQ(formatted(MilliVolt(0.0078125)), "0.007812mV");
+  EXPECT_EQ(formatted(MilliVolt(0.0234375)), "0.023438mV");
+  EXPECT_EQ(formatted(Feet(2.5f)), std::to_string(Feet(2.5f)));
+
+  // Scientific notation keeps the exponent of subnormals and rounds near
+  // and exact half way cases from the binary value
+  char text[32];
+  for (double value : {4.9e-324, 1e-310, 2.2250738585072014e-308, 1e-292,
+                       9.9999995, 9.9999994999999, 0.00048828125,
+                       0.00048828125000000005, 1.2345675e-5, 99999995.,
+                       1.7976931348623157e308, 1e23}) {
+    units::FormatBuffer scientific(text, sizeof(text));
+    scientific.append_scientific(value);
+    char expected[32];
+    std::snprintf(expected, sizeof(expected), "%e", value);
+    EXPECT_STREQ(text, expected);
+  }
+
+  char small[6] = "xxxxx";
+  EXPECT_EQ(units::format_unit(Newton(-123), small, sizeof(small)), 5u);
+  EXPECT_STREQ(small, "-123m");
+  EXPECT_EQ(units::format_unit(Newton(1), small, 0), 0u);
+  EXPECT_STREQ(small, "-123m");
+  EXPECT_EQ(units::format_unit(Newton(1), small, 1), 0u);
+  EXPECT_STREQ(small, "");
+}
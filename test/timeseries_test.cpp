@@ -0,0 +1,94 @@
+#include "phys_timeseries.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <vector>
+
+using TimeStampMilliSeconds =
+    units::AbsolutePhysicalUnit<int64_t, std::milli, int64_t, std::ratio<0>,
+                                std::ratio<0>, std::ratio<0>, std::ratio<1>>;
+using TempCelsius = units::AbsolutePhysicalUnit<
+    double, std::ratio<1>, double, std::ratio<27315, 100>, std::ratio<0>,
+    std::ratio<0>, std::ratio<0>, std::ratio<0>, std::ratio<1>>;
+using TempKelvin =
+    units::AbsolutePhysicalUnit<double, std::ratio<1>, double, std::ratio<0>,
+                                std::ratio<0>, std::ratio<0>, std::ratio<0>,
+                                std::ratio<0>, std::ratio<1>>;
+using MilliBar = units::PhysicalUnit<int16_t, std::ratio<100>, std::ratio<-1>,
+                                     std::ratio<1>, std::ratio<-2>>;
+using Pressure = units::PhysicalUnit<float, std::ratio<1>, std::ratio<-1>,
+                                     std::ratio<1>, std::ratio<-2>>;
+
+TEST(TimeSeriesTests, Timestamps) {
+  units::TimeSeries<TimeStampMilliSeconds> series(1000);
+  std::vector<TimeStampMilliSeconds> input;
+  int64_t now = 1704067200000;
+  for (int i = 0; i < 2500; ++i) {
+    now += 1000 + (i % 7 == 0 ? 3 : 0) - (i % 11 == 0 ? 2 : 0);
+    input.push_back(TimeStampMilliSeconds(now));
+  }
+  series.append(input.begin(), input.end());
+  EXPECT_EQ(series.size(), 2500u);
+  EXPECT_EQ(series.chunks().size(), 3u);
+  EXPECT_LT(series.bytes() * 4, input.size() * sizeof(int64_t));
+  std::vector<TimeStampMilliSeconds> output(series.size());
+  EXPECT_EQ(series.decode(output.data()), 2500u);
+  EXPECT_TRUE(output == input);
+}
+
+TEST(TimeSeriesTests, NarrowSignedValues) {
+  units::TimeSeries<MilliBar> series;
+  std::vector<MilliBar> input;
+  for (int i = 0; i < 300; ++i)
+    input.push_back(MilliBar(int16_t(i % 50 == 0 ? -32768 : 1013 - i % 9)));
+  series.append(input.begin(), input.end());
+  std::vector<MilliBar> output(series.size());
+  series.decode(output.data());
+  EXPECT_TRUE(output == input);
+}
+
+TEST(TimeSeriesTests, FloatingValues) {
+  units::TimeSeries<TempCelsius> series;
+  std::vector<TempCelsius> input;
+  for (int i = 0; i < 1000; ++i)
+    input.push_back(TempCelsius(21.5 + (i / 60) * 0.25));
+  input.push_back(TempCelsius(-1e300));
+  input.push_back(TempCelsius(std::nan("")));
+  series.append(input.begin(), input.end());
+  EXPECT_LT(series.bytes() * 10, input.size() * sizeof(double));
+  std::vector<TempCelsius> output(series.size());
+  series.decode(output.data());
+  for (std::size_t i = 0; i + 1 < input.size(); ++i)
+    EXPECT_EQ(output[i], input[i]);
+  EXPECT_TRUE(std::isnan(output.back().value()));
+
+  units::TimeSeries<Pressure> floats;
+  for (int i = 0; i < 100; ++i)
+    floats.append(Pressure(101325.f + float(i % 3) * 0.5f));
+  std::vector<Pressure> back(floats.size());
+  floats.decode(back.data());
+  EXPECT_EQ(back[95].value(), 101325.f + 1.f);
+}
+
+TEST(TimeSeriesTests, TypeCheckedChunks) {
+  units::TimeSeries<TempCelsius> series;
+  for (int i = 0; i < 10; ++i)
+    series.append(TempCelsius(20. + i));
+  const units::TimeSeriesChunk &chunk = series.chunks().front();
+  std::vector<uint64_t> stored = chunk.serialize();
+
+  units::TimeSeriesChunk loaded(units::DescribeUnit<TempKelvin>::get());
+  ASSERT_TRUE(units::TimeSeriesChunk::deserialize(stored.data(), stored.size(),
+                                                  loaded));
+  TempKelvin kelvins[10];
+  EXPECT_EQ(loaded.decode(kelvins), 0u);
+  EXPECT_FALSE(loaded.append(TempKelvin(0.)));
+  TempCelsius celsius[10];
+  EXPECT_EQ(loaded.decode(celsius), 10u);
+  EXPECT_EQ(celsius[9].value(), 29.);
+
+  // A loaded chunk is sealed, matching samples are refused too
+  EXPECT_FALSE(loaded.append(TempCelsius(30.)));
+  EXPECT_EQ(loaded.size(), 10u);
+  EXPECT_FALSE(units::TimeSeriesChunk::deserialize(stored.data(),
+                                                   stored.size() - 1, loaded));
+}
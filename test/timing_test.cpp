@@ -0,0 +1,110 @@
+#include "phys_timing.hpp"
+#include <algorithm>
+#include <atomic>
+#include <gtest/gtest.h>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+TEST(TimingTests, ProbeMeasuresSleep) {
+  static_assert(
+      std::is_same<units::NanoSeconds,
+                   units::PhysicalUnit<int64_t, std::nano, std::ratio<0>,
+                                       std::ratio<0>, std::ratio<1>>>::value,
+      "Probe must report nanoseconds");
+  units::TimingProbe probe;
+  probe.start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  units::NanoSeconds elapsed = probe.stop();
+  EXPECT_GE(elapsed.value(), 1500000);
+  EXPECT_LT(elapsed.value(), 2000000000);
+  std::chrono::nanoseconds ch_elapsed = std::chrono::duration_cast(elapsed);
+  EXPECT_EQ(ch_elapsed.count(), elapsed.value());
+}
+
+TEST(TimingTests, ElapsedNeverNegative) {
+  const units::TickClock::Ticks now = units::TickClock::now();
+  EXPECT_EQ(units::TickClock::elapsed(now, now).value(), 0);
+  EXPECT_EQ(units::TickClock::elapsed(now + 1000, now).value(), 0);
+  EXPECT_EQ(units::TickClock::elapsed(1, 0).value(), 0);
+  EXPECT_GT(units::TickClock::elapsed(now, now + 1000000).value(), 0);
+}
+
+TEST(TimingTests, HistogramBuckets) {
+  EXPECT_EQ(units::LatencyHistogram::bucket(0), 0);
+  EXPECT_EQ(units::LatencyHistogram::bucket(1), 1);
+  EXPECT_EQ(units::LatencyHistogram::bucket(2), 2);
+  EXPECT_EQ(units::LatencyHistogram::bucket(3), 2);
+  EXPECT_EQ(units::LatencyHistogram::bucket(1024), 11);
+  EXPECT_EQ(units::LatencyHistogram::bucket_limit(11).value(), 2047);
+
+  units::LatencyHistogram histogram;
+  for (int i = 1; i <= 100; ++i)
+    histogram.record(units::NanoSeconds(i * 10));
+  EXPECT_EQ(histogram.count(), 100u);
+  EXPECT_EQ(histogram.min().value(), 10);
+  EXPECT_EQ(histogram.max().value(), 1000);
+  EXPECT_EQ(histogram.mean().value(), 505);
+  EXPECT_EQ(histogram.percentile(0.5).value(), 511);
+  EXPECT_EQ(histogram.percentile(1.).value(), 1000);
+
+  units::LatencyHistogram other;
+  other.record(units::NanoSeconds(5000));
+  histogram.merge(other);
+  EXPECT_EQ(histogram.count(), 101u);
+  EXPECT_EQ(histogram.max().value(), 5000);
+}
+
+TEST(TimingTests, ScopedTimer) {
+  units::LatencyHistogram histogram;
+  {
+    units::ScopedTimer<units::LatencyHistogram> timer(histogram);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(histogram.count(), 1u);
+  EXPECT_GE(histogram.min().value(), 500000);
+}
+
+TEST(TimingTests, ThreadHistograms) {
+  static units::ThreadLatencyHistograms<8> histograms;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t)
+    threads.emplace_back([t]() {
+      for (int i = 0; i < 1000; ++i)
+        histograms.record(units::NanoSeconds(100 * (t + 1)));
+    });
+  for (auto &thread : threads)
+    thread.join();
+  units::LatencyHistogram total = histograms.snapshot();
+  EXPECT_EQ(total.count(), 4000u);
+  EXPECT_EQ(total.min().value(), 100);
+  EXPECT_EQ(total.max().value(), 400);
+  EXPECT_EQ(total.mean().value(), 250);
+}
+
+TEST(TimingTests, ThreadSlotsAreRecycled) {
+  unsigned first = 0;
+  std::thread([&first]() { first = units::thread_slot(); }).join();
+  // Threads started one after another take the slot of the one before
+  for (int t = 0; t < 100; ++t) {
+    unsigned slot = 0;
+    std::thread([&slot]() { slot = units::thread_slot(); }).join();
+    EXPECT_EQ(slot, first);
+  }
+
+  // Threads alive at the same time hold different slots
+  std::vector<unsigned> slots(4);
+  std::atomic<int> started(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t)
+    threads.emplace_back([&slots, &started, t]() {
+      slots[t] = units::thread_slot();
+      started.fetch_add(1);
+      while (started.load() < 4)
+        std::this_thread::yield();
+    });
+  for (auto &thread : threads)
+    thread.join();
+  std::sort(slots.begin(), slots.end());
+  EXPECT_EQ(std::unique(slots.begin(), slots.end()), slots.end());
+}
@@ -0,0 +1,100 @@
+#include "phys_vector.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <type_traits>
+
+using Meter = units::PhysicalUnit<double, std::ratio<1>, std::ratio<1>>;
+using CentiMeter = units::PhysicalUnit<double, std::centi, std::ratio<1>>;
+using Seconds = units::PhysicalUnit<double, std::ratio<1>, std::ratio<0>,
+                                    std::ratio<0>, std::ratio<1>>;
+using MeterPerSecond = units::PhysicalUnit<double, std::ratio<1>,
+                                           std::ratio<1>, std::ratio<0>,
+                                           std::ratio<-1>>;
+using Newton = units::PhysicalUnit<double, std::ratio<1>, std::ratio<1>,
+                                   std::ratio<1>, std::ratio<-2>>;
+using NewtonMeter = units::PhysicalUnit<double, std::ratio<1>, std::ratio<2>,
+                                        std::ratio<1>, std::ratio<-2>>;
+
+TEST(VectorTests, Products) {
+  units::Vec3<Meter> r(Meter(1.), Meter(0.), Meter(0.));
+  units::Vec3<Newton> f(Newton(0.), Newton(2.), Newton(0.));
+  auto torque = units::cross(r, f);
+  static_assert(std::is_same<decltype(torque), units::Vec3<NewtonMeter>>::value,
+                "Torque must be in newton meters");
+  EXPECT_EQ(torque, units::Vec3<NewtonMeter>(NewtonMeter(0.), NewtonMeter(0.),
+                                             NewtonMeter(2.)));
+  NewtonMeter work = units::dot(r + units::Vec3<Meter>(Meter(0.), Meter(1.),
+                                                       Meter(0.)),
+                                f);
+  EXPECT_NEAR(work.value(), 2., 0.000001);
+
+  units::Vec3<Meter> d(Meter(3.), Meter(4.), Meter(12.));
+  Meter length = units::norm(d);
+  EXPECT_NEAR(length.value(), 13., 0.000001);
+  units::Vec3<double> dir = units::normalized(d);
+  EXPECT_NEAR(dir.z(), 12. / 13., 0.000001);
+  units::Vec3<CentiMeter> in_cm(d);
+  EXPECT_NEAR(in_cm.y().value(), 400., 0.000001);
+  auto scaled = 2. * d - d / 2.;
+  EXPECT_NEAR(scaled.x().value(), 4.5, 0.000001);
+}
+
+TEST(VectorTests, Rotation) {
+  units::Vec3<Meter> v(Meter(1.), Meter(0.), Meter(0.));
+  units::Vec3<double> up(0., 0., 1.);
+  auto turned = units::rotate(v, up, units::AbsoluteAngle<double>(90.));
+  EXPECT_NEAR(turned.x().value(), 0., 0.0001);
+  EXPECT_NEAR(turned.y().value(), 1., 0.0001);
+  auto back = units::rotate(
+      turned, up,
+      units::PhysicalUnitAngle<double, units::RadianRatio>(-M_PI / 2));
+  EXPECT_NEAR(back.x().value(), 1., 0.0001);
+}
+
+TEST(VectorTests, Batches) {
+  const std::size_t count = 100;
+  units::Vec3Array<Meter> position(count);
+  units::Vec3Array<MeterPerSecond> velocity(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    position.set(i, units::Vec3<Meter>(Meter(double(i)), Meter(0.), Meter(1.)));
+    velocity.set(i, units::Vec3<MeterPerSecond>(MeterPerSecond(1.),
+                                                MeterPerSecond(2.),
+                                                MeterPerSecond(0.)));
+  }
+  units::multiply_add_n(position, velocity, Seconds(0.5));
+  EXPECT_NEAR(position.get(10).x().value(), 10.5, 0.000001);
+  EXPECT_NEAR(position.get(10).y().value(), 1., 0.000001);
+
+  units::Vec3Array<CentiMeter> offsets(count);
+  units::multiply_add_n(offsets, velocity, Seconds(0.5));
+  EXPECT_NEAR(offsets.get(3).y().value(), 100., 0.000001);
+
+  // Integral accumulators take steps smaller than their unit, rounded
+  using MicroMeters =
+      units::PhysicalUnit<std::int32_t, std::micro, std::ratio<1>>;
+  units::Vec3Array<MicroMeters> fine(count);
+  units::multiply_add_n(fine, velocity, Seconds(0.0000004));
+  EXPECT_EQ(fine.get(0).x().value(), 0);
+  EXPECT_EQ(fine.get(0).y().value(), 1);
+  units::multiply_add_n(fine, velocity, Seconds(0.5));
+  EXPECT_EQ(fine.get(0).x().value(), 500000);
+  EXPECT_EQ(fine.get(0).y().value(), 1000001);
+
+  Meter lengths[count];
+  units::norm_n(position, lengths);
+  EXPECT_NEAR(lengths[0].value(), std::sqrt(0.25 + 1. + 1.), 0.000001);
+
+  units::PhysicalUnit<double, std::ratio<1>, std::ratio<2>> dots[count];
+  units::dot_n(position, position, dots);
+  EXPECT_NEAR(dots[0].value(), 2.25, 0.000001);
+
+  units::Vec3Array<units::PhysicalUnit<double, std::ratio<1>, std::ratio<2>>>
+      normals;
+  units::cross_n(position, position, normals);
+  EXPECT_NEAR(normals.get(7).z().value(), 0., 0.000001);
+
+  units::rotate_n(position, units::Rotation3<double>(
+                                units::Vec3<double>(0., 0., 1.),
+                                units::AbsoluteAngle<double>(180.)));
+  EXPECT_NEAR(position.get(10).x().value(), -10.5, 0.001);
+}